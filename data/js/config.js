@@ -111,6 +111,53 @@ export const domElements = {
   
   // System
   btnSystemRestart: getElement("btnSystemRestart"),
+
+  // Controller / LQR
+  lqrState: getElement("lqrState"),
+  lqrMode: getElement("lqrMode"),
+  lqrGains: getElement("lqrGains"),
+  btnLqrSend: getElement("btnLqrSend"),
+  btnLqrPull: getElement("btnLqrPull"),
+
+  // Gain schedule
+  schedState: getElement("schedState"),
+  schedEnable: getElement("schedEnable"),
+  schedVcomp: getElement("schedVcomp"),
+  schedSpdMax: getElement("schedSpdMax"),
+  schedBatMin: getElement("schedBatMin"),
+  schedBatMax: getElement("schedBatMax"),
+  schedVnom: getElement("schedVnom"),
+  schedAng: getElement("schedAng"),
+  schedSpd: getElement("schedSpd"),
+  btnSchedSend: getElement("btnSchedSend"),
+  btnSchedPull: getElement("btnSchedPull"),
+
+  // Autotune
+  atState: getElement("atState"),
+  atTarget: getElement("atTarget"),
+  atResult: getElement("atResult"),
+  btnAtStart: getElement("btnAtStart"),
+  btnAtAbort: getElement("btnAtAbort"),
+  btnAtApply: getElement("btnAtApply"),
+
+  // Motor duty map
+  mmState: getElement("mmState"),
+  mmEnable: getElement("mmEnable"),
+  mmResult: getElement("mmResult"),
+  btnMmMeasure: getElement("btnMmMeasure"),
+  btnMmAbort: getElement("btnMmAbort"),
+  btnMmSave: getElement("btnMmSave"),
+  btnMmCalibrate: getElement("btnMmCalibrate"),
+
+  // Blackbox
+  bbxState: getElement("bbxState"),
+  bbxTrigger: getElement("bbxTrigger"),
+  bbxChannel: getElement("bbxChannel"),
+  bbxLevel: getElement("bbxLevel"),
+  bbxPre: getElement("bbxPre"),
+  btnBbxArm: getElement("btnBbxArm"),
+  btnBbxTrigger: getElement("btnBbxTrigger"),
+  btnBbxDownload: getElement("btnBbxDownload"),
 };
 
 /**
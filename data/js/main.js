@@ -13,6 +13,11 @@ import {
 import { initWifiSettings, applyWifiStateFromHttp } from "./modules/wifi.js";
 import { initGroup, handleGroupConfig, handleGroupStatus } from "./modules/group.js";
 import { initPitchZero } from "./modules/pitchZero.js";
+import { initBlackbox, handleBlackboxState, updateBlackboxState } from "./modules/blackbox.js";
+import { initLqr, handleLqrState } from "./modules/lqr.js";
+import { initAutotune, handleAutotuneState } from "./modules/autotune.js";
+import { initSched, handleSchedState } from "./modules/sched.js";
+import { initMotorMap, handleMotorMapState } from "./modules/motorMap.js";
 import { connectWebSocket, syncInitialState } from "./services/websocket.js";
 
 /**
@@ -29,6 +34,11 @@ async function main() {
   initJoystick();
   initGroup();
   initPitchZero();
+  initBlackbox();
+  initLqr();
+  initAutotune();
+  initSched();
+  initMotorMap();
   init3D();
 
   // 启动时将指示灯置为初始状态
@@ -62,6 +72,7 @@ async function main() {
       if (typeof msg.battery === "number") {
         updateEnergyBar(msg.battery);
       }
+      if (msg.bbx) updateBlackboxState(msg.bbx);
       
       // 车队状态
       if (msg.group_status) {
@@ -80,6 +91,11 @@ async function main() {
     onGroupConfig: (msg) => {
       if (msg.type === 'group_config') handleGroupConfig(msg);
     },
+    onBlackboxState: handleBlackboxState,
+    onLqrState: handleLqrState,
+    onAutotuneState: handleAutotuneState,
+    onSchedState: handleSchedState,
+    onMotorMapState: handleMotorMapState,
   });
 
   logLine('ready');
@@ -0,0 +1,56 @@
+// /assets/js/modules/autotune.js
+import { domElements } from "../config.js";
+import { sendWebSocketMessage } from "../services/websocket.js";
+import { appendLog } from "../ui.js";
+
+const STATE_TEXT = { idle: "空闲", settle: "等待平衡", relay: "继电激励", done: "完成", failed: "失败" };
+const LOOP_TEXT = { ang: "角度环", spd: "速度环", none: "—" };
+
+let lastState = "";
+
+/**
+ * 初始化自整定面板
+ */
+export function initAutotune() {
+  const { atTarget, btnAtStart, btnAtAbort, btnAtApply } = domElements;
+  if (!atTarget || !btnAtStart || !btnAtAbort || !btnAtApply) return;
+
+  btnAtStart.onclick = () => {
+    sendWebSocketMessage({ type: "autotune", cmd: "start", target: atTarget.value });
+    appendLog(`[TUNE] 开始整定 ${atTarget.value}，请保持平衡、勿操作摇杆`);
+  };
+  btnAtAbort.onclick = () => sendWebSocketMessage({ type: "autotune", cmd: "abort" });
+  btnAtApply.onclick = () => {
+    sendWebSocketMessage({ type: "autotune", cmd: "apply" });
+    appendLog("[SAVE] 应用自整定参数");
+  };
+}
+
+function formatResult(name, r) {
+  if (!r || !r.valid) return "";
+  return `${name} Ku=${r.ku.toFixed(4)} Tu=${r.tu.toFixed(3)}s → P=${+r.p.toFixed(4)} I=${+r.i.toFixed(4)} D=${+r.d.toFixed(4)}`;
+}
+
+/**
+ * 回填整定进度与建议参数（autotune 消息）
+ */
+export function handleAutotuneState(msg) {
+  const { atState, atResult, btnAtApply } = domElements;
+  const state = STATE_TEXT[msg.state] || msg.state;
+  if (atState) {
+    const running = msg.state === "settle" || msg.state === "relay";
+    atState.textContent = running
+      ? `${LOOP_TEXT[msg.loop] || msg.loop} ${state} ${msg.cycles}/${msg.cycles_total} ${(msg.elapsed_ms / 1000).toFixed(1)}s`
+      : state;
+  }
+  if (atResult) {
+    const lines = [formatResult("角度环", msg.ang), formatResult("速度环", msg.spd)].filter(Boolean);
+    if (msg.error) lines.push(`原因：${msg.error}`);
+    atResult.textContent = lines.join("\n") || "—";
+  }
+  if (btnAtApply) btnAtApply.disabled = msg.state !== "done";
+  if (msg.state !== lastState && (msg.state === "done" || msg.state === "failed")) {
+    appendLog(msg.state === "done" ? "[TUNE] 整定完成，确认后点击应用" : `[TUNE] 整定失败：${msg.error || ""}`);
+  }
+  lastState = msg.state;
+}
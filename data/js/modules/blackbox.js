@@ -0,0 +1,134 @@
+// /assets/js/modules/blackbox.js
+import { domElements } from "../config.js";
+import { sendWebSocketMessage } from "../services/websocket.js";
+import { appendLog } from "../ui.js";
+
+// 最近一次收到的记录格式（blackbox_state 消息）
+let schema = null;
+
+const STATE_LABELS = {
+  idle: "未布防",
+  armed: "已布防",
+  triggered: "已触发",
+  frozen: "已冻结",
+};
+
+/**
+ * 初始化黑匣子面板
+ */
+export function initBlackbox() {
+  const { btnBbxArm, btnBbxTrigger, btnBbxDownload, bbxTrigger, bbxChannel, bbxLevel, bbxPre } = domElements;
+  if (!btnBbxArm || !btnBbxTrigger || !btnBbxDownload) return;
+
+  btnBbxArm.onclick = () => {
+    const msg = {
+      type: "blackbox",
+      cmd: "arm",
+      trigger: bbxTrigger?.value || "fall",
+      channel: bbxChannel?.value || "",
+      level: parseFloat(bbxLevel?.value) || 0,
+      pre: parseInt(bbxPre?.value, 10) || 50,
+    };
+    sendWebSocketMessage(msg);
+    appendLog(`[BBX] arm trigger=${msg.trigger} ${msg.trigger === "threshold" ? `${msg.channel}>=${msg.level}` : ""}`);
+  };
+  btnBbxTrigger.onclick = () => {
+    sendWebSocketMessage({ type: "blackbox", cmd: "trigger" });
+    appendLog("[BBX] manual trigger");
+  };
+  btnBbxDownload.onclick = downloadBlackbox;
+
+  fetchSchema();
+}
+
+async function fetchSchema() {
+  try {
+    const res = await fetch("/api/blackbox");
+    if (!res.ok) throw new Error(`HTTP ${res.status}`);
+    const msg = await res.json();
+    handleBlackboxState(msg);
+    return msg;
+  } catch (e) {
+    appendLog(`[BBX] /api/blackbox fail: ${e.message}`);
+    return null;
+  }
+}
+
+/**
+ * 处理 blackbox_state：更新状态显示，首次收到时填充阈值通道
+ */
+export function handleBlackboxState(msg) {
+  if (!msg || !Array.isArray(msg.fields)) return;
+  const { bbxChannel } = domElements;
+  if (bbxChannel && !bbxChannel.options.length) {
+    msg.fields
+      .filter((f) => f.type === "f")
+      .forEach((f) => bbxChannel.add(new Option(f.name, f.name, false, f.name === "angley")));
+  }
+  schema = msg;
+  updateBlackboxState(msg.state, msg.count, msg.capacity);
+}
+
+/**
+ * 遥测中的 bbx 字段只带状态名
+ */
+export function updateBlackboxState(name, count, capacity) {
+  const { bbxState } = domElements;
+  if (!bbxState || !name) return;
+  const label = STATE_LABELS[name] || name;
+  bbxState.textContent = typeof count === "number" ? `${label} ${count}/${capacity}` : label;
+}
+
+/**
+ * 按 schema 把 /api/blackbox/data 的二进制解成 CSV 文本
+ */
+export function decodeBlackbox(buffer, fmt) {
+  const dv = new DataView(buffer);
+  const magic = String.fromCharCode(dv.getUint8(0), dv.getUint8(1), dv.getUint8(2), dv.getUint8(3));
+  if (magic !== "BBX1") throw new Error("bad magic");
+  const version = dv.getUint16(4, true);
+  const recordSize = dv.getUint16(6, true);
+  const count = dv.getUint32(8, true);
+  const triggerPos = dv.getUint32(12, true);
+  if (version !== fmt.version || recordSize !== fmt.record_size) throw new Error("schema mismatch");
+
+  const readers = {
+    u: (o) => dv.getUint32(o, true),
+    i: (o) => dv.getInt16(o, true),
+    h: (o) => dv.getUint16(o, true),
+    f: (o) => dv.getFloat32(o, true),
+  };
+  const lines = [["trigger", ...fmt.fields.map((f) => f.name)].join(",")];
+  for (let r = 0; r < count; r++) {
+    const base = fmt.header_size + r * recordSize;
+    const row = fmt.fields.map((f) => {
+      const v = readers[f.type](base + f.offset);
+      return f.type === "f" ? v.toPrecision(6) : v;
+    });
+    lines.push([r === triggerPos ? 1 : 0, ...row].join(","));
+  }
+  return lines.join("\n");
+}
+
+async function downloadBlackbox() {
+  const fmt = await fetchSchema();
+  if (!fmt) return;
+  if (fmt.state !== "frozen") {
+    appendLog("[BBX] 尚未冻结，无法下载");
+    return;
+  }
+  try {
+    const res = await fetch("/api/blackbox/data");
+    if (!res.ok) throw new Error(`HTTP ${res.status}`);
+    const csv = decodeBlackbox(await res.arrayBuffer(), fmt);
+    const url = URL.createObjectURL(new Blob([csv], { type: "text/csv" }));
+    const a = document.createElement("a");
+    a.href = url;
+    a.download = `blackbox_${Date.now()}.csv`;
+    a.click();
+    URL.revokeObjectURL(url);
+    appendLog(`[BBX] 下载完成 ${fmt.count} 条`);
+  } catch (e) {
+    appendLog(`[BBX] 下载失败: ${e.message}`);
+  }
+}
@@ -167,7 +167,20 @@ function pushDataToChart(chart, dataPoints) {
       }
     }
   });
-  chart.update('none');
+  scheduleRedraw();
+}
+
+// 高刷新率下每帧只重绘一次，避免每条遥测都触发 chart.update
+let redrawPending = false;
+function scheduleRedraw() {
+  if (redrawPending) return;
+  redrawPending = true;
+  requestAnimationFrame(() => {
+    redrawPending = false;
+    state.charts.chart1?.update('none');
+    state.charts.chart2?.update('none');
+    state.charts.chart3?.update('none');
+  });
 }
 
 /**
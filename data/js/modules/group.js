@@ -12,8 +12,12 @@ const groupState = {
   leaderMac: '',
   groupId: 0,
   espnowEnabled: false,
+  fleetMode: 'duty', // duty：从车执行头车占空比；setpoint：从车自平衡跟随头车设定值
+  formationOffset: 0,
+  txMaxHz: 100,
   espnowStatus: 'unknown',
-  followersOnline: [] // 从车在线列表
+  followersOnline: [], // 已发现的从车（含离线，带链路统计）
+  leaderLink: null // 从车：头车下行链路
 };
 
 // UI元素
@@ -42,6 +46,10 @@ function cacheElements() {
     groupIdInput: document.getElementById('groupId'),
     leaderMacInput: document.getElementById('leaderMac'),
     espnowSwitch: document.getElementById('espnowSwitch'),
+    fleetModeSelect: document.getElementById('fleetMode'),
+    formationOffsetInput: document.getElementById('formationOffset'),
+    txMaxHzInput: document.getElementById('txMaxHz'),
+    groupTxText: document.getElementById('groupTxText'),
     myMacDisplay: document.getElementById('myMac'),
     groupSaveBtn: document.getElementById('btnSaveGroup'),
     groupRefreshBtn: document.getElementById('btnRefreshGroup'),
@@ -51,7 +59,10 @@ function cacheElements() {
     espnowStatusLamp: document.getElementById('espnowStatusLamp'),
     espnowStatusText: document.getElementById('espnowStatusText'),
     followersCount: document.getElementById('followersCount'),
-    followersList: document.getElementById('followersList')
+    followersList: document.getElementById('followersList'),
+    leaderLink: document.getElementById('leaderLink'),
+    leaderLinkText: document.getElementById('leaderLinkText'),
+    fleetTrackText: document.getElementById('fleetTrackText')
   };
   
   // 如果元素不存在（老版本HTML），则不初始化
@@ -72,6 +83,9 @@ function bindEvents() {
   elements.groupSaveBtn.addEventListener('click', saveGroupConfig);
   elements.groupRefreshBtn.addEventListener('click', requestGroupConfig);
   elements.roleSelect.addEventListener('change', onRoleChange);
+  if (elements.fleetModeSelect) {
+    elements.fleetModeSelect.addEventListener('change', onRoleChange);
+  }
 }
 
 /**
@@ -88,6 +102,13 @@ function onRoleChange() {
       leaderMacField.style.display = 'none';
     }
   }
+
+  // 队形偏移只在设定值模式下由头车下发
+  const offsetField = document.getElementById('formationOffsetField');
+  if (offsetField && elements.fleetModeSelect) {
+    const setpoint = elements.fleetModeSelect.value === 'setpoint';
+    offsetField.style.display = setpoint && role === 'leader' ? 'block' : 'none';
+  }
 }
 
 /**
@@ -120,6 +141,14 @@ function saveGroupConfig() {
       espnow_enabled: espnowEnabled ? 1 : 0  // 确保发送数字
     }
   };
+
+  if (elements.fleetModeSelect) {
+    config.param.fleet_mode = elements.fleetModeSelect.value;
+    config.param.formation_offset = parseFloat(elements.formationOffsetInput.value) || 0;
+  }
+  if (elements.txMaxHzInput) {
+    config.param.tx_max_hz = parseInt(elements.txMaxHzInput.value) || 100;
+  }
   
   if (role === 'follower') {
     config.param.leader_mac = leaderMac.toUpperCase();
@@ -149,6 +178,9 @@ export function handleGroupConfig(data) {
   groupState.leaderMac = data.leader_mac || '';
   groupState.groupId = data.group_id || 0;
   groupState.espnowEnabled = data.espnow_enabled || false;
+  groupState.fleetMode = data.fleet_mode || 'duty';
+  groupState.formationOffset = data.formation_offset || 0;
+  groupState.txMaxHz = data.tx_max_hz || 100;
   groupState.espnowStatus = data.espnow_status || 'unknown';
   
   // 更新UI
@@ -168,6 +200,13 @@ function updateUI() {
   elements.groupIdInput.value = groupState.groupId;
   elements.leaderMacInput.value = groupState.leaderMac;
   elements.espnowSwitch.checked = groupState.espnowEnabled;
+  if (elements.fleetModeSelect) {
+    elements.fleetModeSelect.value = groupState.fleetMode;
+    elements.formationOffsetInput.value = groupState.formationOffset;
+  }
+  if (elements.txMaxHzInput) {
+    elements.txMaxHzInput.value = groupState.txMaxHz;
+  }
   elements.myMacDisplay.textContent = groupState.myMac || '未知';
   
   // 根据角色显示/隐藏字段
@@ -209,6 +248,11 @@ function updateStatusDisplay() {
       elements.followersCount.style.display = 'none';
     }
   }
+
+  // 头车链路（仅从车显示）
+  if (elements.leaderLink) {
+    elements.leaderLink.style.display = groupState.role === 'follower' ? 'block' : 'none';
+  }
 }
 
 /**
@@ -219,12 +263,35 @@ export function handleGroupStatus(data) {
   
   const status = data.group_status;
   
-  // 更新从车在线列表
+  // 从车列表分页到达：total 在每条消息中，followers 从下标 first 起
+  if (typeof status.total === 'number') {
+    groupState.followersOnline.length = Math.min(groupState.followersOnline.length, status.total);
+  }
   if (status.followers) {
-    groupState.followersOnline = status.followers;
+    status.followers.forEach((f, i) => {
+      groupState.followersOnline[status.first + i] = f;
+    });
     updateFollowersList();
   }
+
+  // 从车：头车下行链路
+  if (status.leader) {
+    groupState.leaderLink = status.leader;
+    if (elements.leaderLinkText) {
+      elements.leaderLinkText.textContent = formatLink(status.leader);
+    }
+  }
   
+  // 发送统计
+  if (status.tx && elements.groupTxText) {
+    elements.groupTxText.textContent = formatTx(status.tx);
+  }
+
+  // 设定值模式：从车队形跟踪
+  if (status.fleet && elements.fleetTrackText) {
+    elements.fleetTrackText.textContent = formatFleet(status.fleet);
+  }
+
   // 更新其他状态
   if (status.espnow_status) {
     groupState.espnowStatus = status.espnow_status;
@@ -232,24 +299,56 @@ export function handleGroupStatus(data) {
   }
 }
 
+/**
+ * 链路统计格式化：区间丢包率、到达抖动、RSSI（当前/最差）、错误帧
+ * 下位机以数组发送：[丢包‰, 抖动0.1ms, RSSI, 最差RSSI, 错帧(, 距最近一帧ms)]
+ */
+function formatLink(link) {
+  if (!Array.isArray(link)) return '--';
+  const [lossPermille, jitter01ms, rssiNow, rssiMin, rejected] = link;
+  const loss = (lossPermille / 10).toFixed(1);
+  const jitter = (jitter01ms / 10).toFixed(1);
+  const rssi = rssiNow ? `${rssiNow}/${rssiMin}dBm` : '--';
+  return `丢包 ${loss}% 抖动 ${jitter}ms RSSI ${rssi} 错帧 ${rejected}`;
+}
+
+/**
+ * 发送统计：已发帧（从车为心跳）、未变化未发、失败、发送到完成回调的最长耗时
+ */
+function formatTx(tx) {
+  const done = ((tx.done_us || 0) / 1000).toFixed(1);
+  return `发送 ${tx.sent || 0} 帧 未变化 ${tx.skip || 0} 失败 ${tx.fail || 0} 完成≤${done}ms 上限 ${tx.hz}Hz`;
+}
+
+/**
+ * 设定值模式队形跟踪：队形误差（正值为落后）、速度修正、已收设定值帧
+ */
+function formatFleet(fleet) {
+  if (fleet.tracking === undefined) return `设定值帧 ${fleet.setpoints || 0}`;
+  if (!fleet.tracking) return `队形 未跟随 设定值帧 ${fleet.setpoints || 0}`;
+  const err = (fleet.pos_err || 0).toFixed(2);
+  const corr = (fleet.spd_corr || 0).toFixed(2);
+  return `队形误差 ${err}rad 修正 ${corr}rad/s 设定值帧 ${fleet.setpoints || 0}`;
+}
+
 /**
  * 更新从车列表显示
  */
 function updateFollowersList() {
   if (!elements.followersList) return;
   
-  const count = groupState.followersOnline.length;
+  const followers = groupState.followersOnline.filter((f) => f);
+  const count = followers.filter((f) => f.on).length;
   elements.followersCount.querySelector('.count').textContent = count;
   
-  if (count === 0) {
+  if (followers.length === 0) {
     elements.followersList.innerHTML = '<div class="no-followers">无从车在线</div>';
     return;
   }
   
   let html = '<div class="followers-grid">';
-  groupState.followersOnline.forEach((follower, index) => {
-    const lastSeen = Date.now() - follower.last_seen_ms;
-    const isOnline = lastSeen < 2000; // 2秒内视为在线
+  followers.forEach((follower, index) => {
+    const isOnline = follower.on && follower.seen < 2000; // 2秒内收到心跳视为在线
     html += `
       <div class="follower-item ${isOnline ? 'online' : 'offline'}">
         <div class="follower-icon">🚗</div>
@@ -257,6 +356,8 @@ function updateFollowersList() {
           <div class="follower-name">从车 #${index + 1}</div>
           <div class="follower-mac">${follower.mac}</div>
           <div class="follower-status">${isOnline ? '在线' : '离线'}</div>
+          <div class="follower-link">↑ ${formatLink(follower.up)}</div>
+          <div class="follower-link">↓ ${formatLink(follower.dn)}</div>
         </div>
       </div>
     `;
@@ -80,6 +80,7 @@ function sendJoystickData() {
     x: state.joystick.x,
     y: state.joystick.y,
     a: state.joystick.a,
+    t: Math.round(performance.now()), // 发送时刻（ms），下位机据此消除网络抖动
   });
 }
 
@@ -106,7 +107,7 @@ function handlePointerEnd() {
   state.joystick.isDragging = false;
   setStickPosition(0, 0);
   updateJoystickReadout(0, 0);
-  sendWebSocketMessage({ type: "joy", x: 0, y: 0, a: 0 });
+  sendWebSocketMessage({ type: "joy", x: 0, y: 0, a: 0, t: Math.round(performance.now()) });
 }
 
 export function initJoystick() {
@@ -0,0 +1,40 @@
+// /assets/js/modules/lqr.js
+import { domElements } from "../config.js";
+import { sendWebSocketMessage } from "../services/websocket.js";
+import { appendLog } from "../ui.js";
+
+const GAIN_COUNT = 10; // LQR_INPUTS * LQR_STATES
+
+/**
+ * 初始化控制器选择与 LQR 增益面板
+ */
+export function initLqr() {
+  const { lqrMode, lqrGains, btnLqrSend, btnLqrPull } = domElements;
+  if (!lqrMode || !lqrGains || !btnLqrSend || !btnLqrPull) return;
+
+  btnLqrSend.onclick = () => {
+    const param = { mode: lqrMode.value };
+    const text = lqrGains.value.trim();
+    if (text) {
+      const k = text.split(/[\s,]+/).filter(Boolean).map(Number);
+      if (k.length !== GAIN_COUNT || !k.every(Number.isFinite)) {
+        appendLog(`[LQR] 需要 ${GAIN_COUNT} 个有效数字，当前 ${k.length} 个`);
+        return;
+      }
+      param.k = k;
+    }
+    sendWebSocketMessage({ type: "lqr_set", param });
+    appendLog(`[SAVE] 控制器=${param.mode}${param.k ? " 增益已更新" : ""}`);
+  };
+  btnLqrPull.onclick = () => sendWebSocketMessage({ type: "get_lqr" });
+}
+
+/**
+ * 回填后端的控制器状态（lqr 消息）
+ */
+export function handleLqrState(msg) {
+  const { lqrState, lqrMode, lqrGains } = domElements;
+  if (lqrMode && (msg.mode === "pid" || msg.mode === "lqr")) lqrMode.value = msg.mode;
+  if (lqrGains && Array.isArray(msg.k)) lqrGains.value = msg.k.map((v) => +v.toFixed(6)).join(", ");
+  if (lqrState) lqrState.textContent = msg.mode === "lqr" ? "LQR" : "PID";
+}
@@ -0,0 +1,66 @@
+// /assets/js/modules/motorMap.js
+import { domElements } from "../config.js";
+import { sendWebSocketMessage } from "../services/websocket.js";
+import { appendLog } from "../ui.js";
+
+const STATE_TEXT = { idle: "空闲", running: "测量中", done: "完成", failed: "失败" };
+const DZ_TEXT = { pending: "等待", verify: "校验中", search: "标定中", done: "完成", failed: "失败" };
+const CURVE_NAMES = ["左正", "左反", "右正", "右反"];
+
+let lastState = "";
+
+/**
+ * 初始化占空比映射面板
+ */
+export function initMotorMap() {
+  const { mmEnable, btnMmMeasure, btnMmAbort, btnMmSave, btnMmCalibrate } = domElements;
+  if (!mmEnable || !btnMmMeasure || !btnMmAbort || !btnMmSave || !btnMmCalibrate) return;
+
+  mmEnable.onchange = () => sendWebSocketMessage({ type: "motor_map", cmd: mmEnable.checked ? "enable" : "disable" });
+  btnMmMeasure.onclick = () => {
+    sendWebSocketMessage({ type: "motor_map", cmd: "measure" });
+    appendLog("[MOTOR] 开始测量占空比-轮速曲线，请架空车轮");
+  };
+  btnMmAbort.onclick = () => sendWebSocketMessage({ type: "motor_map", cmd: "abort" });
+  btnMmCalibrate.onclick = () => {
+    sendWebSocketMessage({ type: "motor_map", cmd: "calibrate" });
+    appendLog("[MOTOR] 重新标定死区（停止平衡时进行，车轮会短促转动）");
+  };
+  btnMmSave.onclick = () => {
+    sendWebSocketMessage({ type: "motor_map", cmd: "save" });
+    appendLog("[SAVE] 保存占空比映射");
+  };
+}
+
+function formatCurve(name, c) {
+  if (!c || !c.valid) return `${name}：未测量`;
+  const pts = c.duty.map((d, k) => `${d.toFixed(2)}→${c.speed[k].toFixed(1)}`);
+  return `${name}：${pts.join(" ")}`;
+}
+
+/**
+ * 回填曲线与测量进度（motor_map 消息）
+ */
+export function handleMotorMapState(msg) {
+  const { mmState, mmEnable, mmResult } = domElements;
+  if (mmState) {
+    const state = STATE_TEXT[msg.state] || msg.state;
+    mmState.textContent =
+      msg.state === "running" ? `${state} ${msg.point}/${msg.points_total}` : `${msg.backend.toUpperCase()} ${state}`;
+  }
+  if (mmEnable) mmEnable.checked = !!msg.enable;
+  if (mmResult) {
+    const lines = [];
+    if (msg.deadzone) {
+      const dz = msg.deadzone.duty.map((d, i) => `${CURVE_NAMES[i]} ${d.toFixed(3)}`).join(" ");
+      lines.push(`死区（${DZ_TEXT[msg.deadzone.state] || msg.deadzone.state}${msg.deadzone.saved ? "" : "，未保存"}）：${dz}`);
+    }
+    lines.push(...(msg.curves || []).map((c, i) => formatCurve(CURVE_NAMES[i], c)));
+    if (msg.error) lines.push(`原因：${msg.error}`);
+    mmResult.textContent = lines.join("\n") || "—";
+  }
+  if (msg.state !== lastState && (msg.state === "done" || msg.state === "failed")) {
+    appendLog(msg.state === "done" ? "[MOTOR] 曲线测量完成，已启用映射，确认后点击保存" : `[MOTOR] 曲线测量失败：${msg.error || ""}`);
+  }
+  lastState = msg.state;
+}
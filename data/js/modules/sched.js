@@ -0,0 +1,73 @@
+// /assets/js/modules/sched.js
+import { domElements } from "../config.js";
+import { sendWebSocketMessage } from "../services/websocket.js";
+import { appendLog } from "../ui.js";
+
+let tableSize = 12; // bat_points * spd_points，收到后端状态后更新
+
+function parseTable(el, name) {
+  const text = el.value.trim();
+  if (!text) return undefined;
+  const v = text.split(/[\s,]+/).filter(Boolean).map(Number);
+  if (v.length !== tableSize || !v.every((x) => Number.isFinite(x) && x >= 0 && x <= 3)) {
+    appendLog(`[SCHED] ${name}需要 ${tableSize} 个 0~3 的数，当前 ${v.length} 个`);
+    return null;
+  }
+  return v;
+}
+
+/**
+ * 初始化增益调度面板
+ */
+export function initSched() {
+  const { schedEnable, schedVcomp, schedSpdMax, schedBatMin, schedBatMax, schedVnom, schedAng, schedSpd, btnSchedSend, btnSchedPull } =
+    domElements;
+  if (!schedEnable || !btnSchedSend || !btnSchedPull) return;
+
+  btnSchedSend.onclick = () => {
+    const ang = parseTable(schedAng, "角度环表");
+    const spd = parseTable(schedSpd, "速度环表");
+    if (ang === null || spd === null) return;
+    const param = {
+      enable: schedEnable.checked,
+      vcomp: schedVcomp.checked,
+      spd_max: Number(schedSpdMax.value),
+      bat_min: Number(schedBatMin.value),
+      bat_max: Number(schedBatMax.value),
+      v_nom: Number(schedVnom.value),
+    };
+    if (ang) param.ang = ang;
+    if (spd) param.spd = spd;
+    sendWebSocketMessage({ type: "sched_set", param });
+    appendLog("[SAVE] 增益调度表");
+  };
+  btnSchedPull.onclick = () => sendWebSocketMessage({ type: "get_sched" });
+}
+
+// 每行一个电压点
+function formatTable(values, cols) {
+  const rows = [];
+  for (let i = 0; i < values.length; i += cols) rows.push(values.slice(i, i + cols).map((v) => +v.toFixed(3)).join(", "));
+  return rows.join("\n");
+}
+
+/**
+ * 回填后端的增益调度状态（sched 消息）
+ */
+export function handleSchedState(msg) {
+  const { schedState, schedEnable, schedVcomp, schedSpdMax, schedBatMin, schedBatMax, schedVnom, schedAng, schedSpd } = domElements;
+  if (msg.error) appendLog(`[SCHED] ${msg.error}`);
+  tableSize = (msg.spd_points || 4) * (msg.bat_points || 3);
+  if (schedEnable) schedEnable.checked = !!msg.enable;
+  if (schedVcomp) schedVcomp.checked = !!msg.vcomp;
+  if (schedSpdMax) schedSpdMax.value = msg.spd_max;
+  if (schedBatMin) schedBatMin.value = msg.bat_min;
+  if (schedBatMax) schedBatMax.value = msg.bat_max;
+  if (schedVnom) schedVnom.value = msg.v_nom;
+  if (schedAng && Array.isArray(msg.ang)) schedAng.value = formatTable(msg.ang, msg.spd_points || 4);
+  if (schedSpd && Array.isArray(msg.spd)) schedSpd.value = formatTable(msg.spd, msg.spd_points || 4);
+  if (schedState && msg.now) {
+    const n = msg.now;
+    schedState.textContent = `${n.vbat.toFixed(2)}V ×${n.ang_gain.toFixed(2)}/${n.spd_gain.toFixed(2)} 补偿${n.vcomp.toFixed(2)}`;
+  }
+}
@@ -10,6 +10,12 @@ let uiConfigCallback = null;
 let pidParamsCallback = null;
 let rgbStateCallback = null;
 let groupConfigCallback = null;
+let blackboxStateCallback = null;
+let lqrStateCallback = null;
+let autotuneStateCallback = null;
+let schedStateCallback = null;
+let motorMapStateCallback = null;
+let telemSchema = null; // ui_config.telem：二进制遥测帧格式
 
 /**
  * 发送 WebSocket 消息 (JSON)
@@ -21,11 +27,119 @@ export function sendWebSocketMessage(obj) {
   }
 }
 
+const TELEM_ACK_INTERVAL = 250; // ms，回执供后端估计延迟、自适应调整本客户端频率
+let lastAckAt = 0;
+
+/**
+ * 收到遥测后立即回执其时间戳（限频），后端据此计算延迟
+ * @param {number} t_ms
+ */
+function ackTelemetry(t_ms) {
+  const now = performance.now();
+  if (now - lastAckAt < TELEM_ACK_INTERVAL) return;
+  lastAckAt = now;
+  sendWebSocketMessage({ type: "telem_ack", t: t_ms });
+}
+
+// 差分参考：上一帧各通道的量化整数（与后端 TelemEncoder 的参考一致）
+const telemRef = { q: new Int32Array(16), n: 0, valid: false };
+
+/**
+ * 读取 zigzag + LEB128 变长整数
+ * @returns {number|null} 越界时返回 null
+ */
+function readVarint(bytes, pos) {
+  let z = 0;
+  for (let shift = 0; shift < 35; shift += 7) {
+    if (pos.i >= bytes.length) return null;
+    const b = bytes[pos.i++];
+    z += (b & 0x7f) * 2 ** shift;
+    if (!(b & 0x80)) {
+      return z % 2 ? -(z + 1) / 2 : z / 2;
+    }
+  }
+  return null;
+}
+
+/**
+ * 按 ui_config 下发的格式解码二进制遥测帧（小端）
+ * 帧头：magic u8, version u8, flags u8, count u8, seq u32, t_ms u32
+ * 帧体：关键帧为 count 个 int32，差分帧为 count 个变长差值；值 = 量化整数 × step
+ * @param {ArrayBuffer} buf
+ * @returns {object|null} 与旧 JSON 遥测相同结构的对象
+ */
+function decodeTelemetry(buf) {
+  const sc = telemSchema;
+  if (!sc || buf.byteLength < sc.head) return null;
+  const dv = new DataView(buf);
+  if (dv.getUint8(0) !== sc.magic || dv.getUint8(1) !== sc.version) return null;
+  const flags = dv.getUint8(2);
+  const count = dv.getUint8(3);
+  const isKey = !!(flags & sc.flag_key);
+  const groups = flags & sc.flag_chart ? (flags >> sc.group_shift) & 0x07 : 0;
+  // 通道 = 姿态/电量 + 订阅的曲线组（每组 3 路）
+  const steps = sc.steps.slice();
+  for (let g = 0; g < 3; g++) {
+    if (groups & (1 << g)) steps.push(...sc.chart_steps.slice(g * 3, g * 3 + 3));
+  }
+  if (count !== steps.length || count > telemRef.q.length) return null;
+
+  const q = telemRef.q;
+  if (isKey) {
+    if (buf.byteLength < sc.head + count * 4) return null;
+    for (let i = 0; i < count; i++) q[i] = dv.getInt32(sc.head + i * 4, true);
+  } else {
+    // 差分帧只能接在同通道数的参考之后，否则等下一个关键帧
+    if (!telemRef.valid || telemRef.n !== count) return null;
+    const bytes = new Uint8Array(buf, sc.head);
+    const pos = { i: 0 };
+    const next = new Int32Array(count);
+    for (let i = 0; i < count; i++) {
+      const d = readVarint(bytes, pos);
+      if (d === null) {
+        telemRef.valid = false;
+        return null;
+      }
+      next[i] = (q[i] + d) | 0;
+    }
+    q.set(next);
+  }
+  telemRef.n = count;
+  telemRef.valid = true;
+
+  const msg = {
+    type: "telemetry",
+    seq: dv.getUint32(4, true),
+    t_ms: dv.getUint32(8, true),
+    fallen: !!(flags & sc.flag_fallen),
+    bbx: sc.bbx_states[(flags >> sc.bbx_shift) & 0x03],
+  };
+  const nf = sc.fields.length;
+  for (let i = 0; i < nf; i++) msg[sc.fields[i]] = q[i] * steps[i];
+  if (groups) {
+    // 未订阅的组填 null，曲线上显示为断点
+    msg.d = new Array(sc.chart).fill(null);
+    let k = nf;
+    for (let g = 0; g < 3; g++) {
+      if (!(groups & (1 << g))) continue;
+      for (let j = 0; j < 3; j++, k++) msg.d[g * 3 + j] = q[k] * steps[k];
+    }
+  }
+  ackTelemetry(msg.t_ms);
+  return msg;
+}
+
 /**
  * 处理收到的 WebSocket 消息
  * @param {MessageEvent} event
  */
 function handleMessage(event) {
+  if (event.data instanceof ArrayBuffer) {
+    const t = decodeTelemetry(event.data);
+    if (t && telemetryCallback) telemetryCallback(t);
+    return;
+  }
+
   let msg = null;
   try {
     msg = JSON.parse(event.data);
@@ -41,6 +155,10 @@ function handleMessage(event) {
       if (telemetryCallback) telemetryCallback(msg);
       break;
     case "ui_config":
+      if (msg.telem) {
+        telemSchema = msg.telem;
+        telemRef.valid = false;
+      }
       if (uiConfigCallback) uiConfigCallback(msg);
       break;
     case "pid":
@@ -60,9 +178,52 @@ function handleMessage(event) {
         }
       }
       break;
+    case "blackbox_state":
+      if (blackboxStateCallback) blackboxStateCallback(msg);
+      break;
+    case "lqr":
+      if (lqrStateCallback) lqrStateCallback(msg);
+      break;
+    case "autotune":
+      if (autotuneStateCallback) autotuneStateCallback(msg);
+      break;
+    case "sched":
+      if (schedStateCallback) schedStateCallback(msg);
+      break;
+    case "motor_map":
+      if (motorMapStateCallback) motorMapStateCallback(msg);
+      break;
     case "info":
       if (msg.text) appendLog(`[INFO] ${msg.text}`);
       break;
+    case "loop_stats": {
+      const t = msg.stages?.total || {};
+      const p = msg.stages?.period || {};
+      appendLog(
+        `[LOOP] total p50=${t.p50}us p99=${t.p99}us max=${t.max}us | period p99=${p.p99}us | overrun=${msg.overrun} late=${msg.late}`
+      );
+      if (msg.heap && msg.telem) {
+        appendLog(
+          `[HEAP] free=${msg.heap.free} min=${msg.heap.min_free} largest=${msg.heap.largest} | telem frames=${msg.telem.frames} build_allocs=${msg.telem.build_allocs} send_allocs=${msg.telem.send_allocs} pool_miss=${msg.telem.pool_miss} oversize=${msg.telem.pool_oversize}`
+        );
+      }
+      if (msg.motor) {
+        appendLog(
+          `[MOTOR] ${msg.motor.legacy ? "legacy" : "cached"} out mean=${msg.motor.cycles_mean} max=${msg.motor.cycles_max} cycles | dir_writes=${msg.motor.dir_writes} duty_writes=${msg.motor.duty_writes} / ${msg.motor.updates} ticks`
+        );
+      }
+      if (msg.joy && msg.joy.samples) {
+        appendLog(
+          `[JOY] frames=${msg.joy.samples} dropped=${msg.joy.dropped} deadman=${msg.joy.deadman} delay=${msg.joy.delay_ms.toFixed(1)}ms`
+        );
+      }
+      (msg.telem?.clients || []).forEach((c) => {
+        appendLog(
+          `[CLIENT #${c.id}] ${c.hz}/${c.rate} Hz queue=${c.queue} lat=${c.lat_ms}ms sent=${c.sent} dropped=${c.dropped} backoffs=${c.backoffs} bytes=${c.bytes}`
+        );
+      });
+      break;
+    }
     default:
       // 未知消息类型
       break;
@@ -85,6 +246,11 @@ function reconnect() {
  * @param {function} callbacks.onPidParams - PID参数数据回调
  * @param {function} callbacks.onRgbState - RGB状态回调
  * @param {function} callbacks.onGroupConfig - 车队配置回调
+ * @param {function} callbacks.onBlackboxState - 黑匣子状态回调
+ * @param {function} callbacks.onLqrState - 控制器/LQR 状态回调
+ * @param {function} callbacks.onAutotuneState - 自整定进度回调
+ * @param {function} callbacks.onSchedState - 增益调度状态回调
+ * @param {function} callbacks.onMotorMapState - 占空比映射状态回调
  */
 export function connectWebSocket(callbacks = {}) {
   if (callbacks.onTelemetry) telemetryCallback = callbacks.onTelemetry;
@@ -92,6 +258,11 @@ export function connectWebSocket(callbacks = {}) {
   if (callbacks.onPidParams) pidParamsCallback = callbacks.onPidParams;
   if (callbacks.onRgbState) rgbStateCallback = callbacks.onRgbState;
   if (callbacks.onGroupConfig) groupConfigCallback = callbacks.onGroupConfig;
+  if (callbacks.onBlackboxState) blackboxStateCallback = callbacks.onBlackboxState;
+  if (callbacks.onLqrState) lqrStateCallback = callbacks.onLqrState;
+  if (callbacks.onAutotuneState) autotuneStateCallback = callbacks.onAutotuneState;
+  if (callbacks.onSchedState) schedStateCallback = callbacks.onSchedState;
+  if (callbacks.onMotorMapState) motorMapStateCallback = callbacks.onMotorMapState;
 
   const protocol = location.protocol === "http:" ? "ws://" : "wss://";
   const url = `${protocol}${location.host}/ws`;
@@ -100,12 +271,21 @@ export function connectWebSocket(callbacks = {}) {
 
   try {
     ws = new WebSocket(url);
+    ws.binaryType = "arraybuffer";
 
     ws.onopen = () => {
       state.connected = true;
       setStatus("已就绪");
       sendWebSocketMessage({ type: "get_pid" });
       appendLog("[SEND] get_pid");
+      sendWebSocketMessage({ type: "get_lqr" });
+      sendWebSocketMessage({ type: "autotune", cmd: "status" });
+      sendWebSocketMessage({ type: "get_sched" });
+      sendWebSocketMessage({ type: "motor_map", cmd: "status" });
+      // 遥测订阅按客户端保存，重连后重新声明本页的频率与曲线开关
+      const hz = parseInt(domElements.rateHzInput.value || "10", 10);
+      if (hz > 0) sendWebSocketMessage({ type: "telem_hz", ms: hz });
+      sendWebSocketMessage({ type: "charts_send", on: !!state.chartsOn });
     };
 
     ws.onclose = () => {
@@ -78,8 +78,8 @@ export function updateEnergyBar(voltage) {
 function bindToolbarEvents() {
   domElements.btnSetRate.onclick = () => {
     const ms = Math.max(
-      20,
-      Math.min(1000, parseInt(domElements.rateHzInput.value || "100", 100))
+      1,
+      Math.min(200, parseInt(domElements.rateHzInput.value || "10", 10))
     );
     sendWebSocketMessage({ type: "telem_hz", ms });
     appendLog(`[SEND] telem_hz ${ms} Hz`);
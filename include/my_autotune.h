@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+
+// 在线自整定：平衡状态下用继电反馈（Åström–Hägglund）替换角度环或速度环的 PID 输出，
+// 测出极限环幅值 a 与周期 Tu，得到临界增益 Ku = 4h / (pi * a)，再按整定规则给出建议参数
+// 继电与状态机在控制任务中每拍运行；网页只置请求标志，进度经 WebSocket 推送，
+// 用户确认后由网页桥接层经 my_cmd_pid() 投递，控制任务生效后再保存
+
+enum autotune_state : uint8_t
+{
+    AT_IDLE = 0,
+    AT_SETTLE, // 等待平衡稳定
+    AT_RELAY,  // 继电激励中
+    AT_DONE,   // 已得到建议参数，等待应用
+    AT_FAILED,
+};
+
+enum autotune_loop : uint8_t
+{
+    AT_LOOP_NONE = 0,
+    AT_LOOP_ANG,
+    AT_LOOP_SPD,
+};
+
+enum autotune_target : uint8_t
+{
+    AT_TARGET_ANG = 1,  // 只整定角度环
+    AT_TARGET_SPD = 2,  // 只整定速度环
+    AT_TARGET_BOTH = 3, // 先角度环后速度环
+};
+
+struct autotune_result
+{
+    bool valid;
+    float ku;        // 临界增益（与对应 PID 的 P 同单位）
+    float tu;        // 极限环周期 (s)
+    float amplitude; // 误差幅值（角度环 deg，速度环 rad/s）
+    float p, i, d;   // 建议参数（速度环 d 恒为 0）
+};
+
+struct autotune_status
+{
+    autotune_state state;
+    autotune_loop loop;   // 当前（或最后）整定的环
+    uint8_t target;       // autotune_target
+    uint8_t cycles;       // 已采集的有效周期
+    uint8_t cycles_total; // 需要的有效周期
+    uint32_t elapsed_ms;  // 本次整定已用时间
+    const char *error;    // AT_FAILED 时的原因
+    autotune_result ang;
+    autotune_result spd;
+};
+
+// 控制任务：每拍在 pitch_control() 之前调用，处理请求、稳定判定、超时与安全退出
+void my_autotune_update();
+// 控制任务：loop 正在继电激励时返回 true 并写出继电输出，调用方跳过对应 PID
+bool my_autotune_relay(autotune_loop loop, float err, float &out);
+bool my_autotune_active(); // 非 IDLE/DONE/FAILED
+
+// 网络任务
+void my_autotune_start(autotune_target target);
+void my_autotune_abort();
+void my_autotune_status(autotune_status &out);
+const char *my_autotune_state_name(autotune_state s);
+const char *my_autotune_loop_name(autotune_loop l);
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 黑匣子：控制任务每拍把完整状态写入环形缓冲（优先放 PSRAM），
+// 触发（摔倒 / 阈值 / 手动）后再录 post 段即冻结，网页通过 /api/blackbox/data 下载二进制
+// 写入方只有控制任务；arm/trigger 请求由网络任务置标志，下一拍由控制任务执行，全程无锁
+
+#define BLACKBOX_VERSION 1
+
+// 单拍记录，字段顺序即二进制布局（小端），新增字段只能追加并提升 BLACKBOX_VERSION
+struct blackbox_record
+{
+    uint32_t t_us;
+    uint32_t tick;
+    float dt;
+    int16_t enc_l; // 本拍编码器增量
+    int16_t enc_r;
+    uint16_t flags; // bit0 run, bit1 fallen
+    uint16_t reserved;
+    float ang_now, ang_tar;
+    float spd_now, spd_tar;
+    float pos_now, pos_tar;
+    float yaw_now, yaw_tar;
+    float anglex, angley, anglez;
+    float gyrox, gyroy, gyroz;
+    float wel_spd1, wel_spd2;
+    float base_duty, yaw_duty;
+    float L_cmd, R_cmd;
+    float L_duty, R_duty;
+    float joy_x, joy_y;
+};
+
+// 下载文件头，后接 count 条 blackbox_record（按时间顺序）
+struct blackbox_header
+{
+    char magic[4];       // "BBX1"
+    uint16_t version;    // BLACKBOX_VERSION
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t trigger_pos; // 触发点在记录中的下标
+    uint32_t dt_us;       // 标称控制周期
+    uint8_t trigger;      // blackbox_trigger
+    uint8_t reserved[3];
+};
+
+enum blackbox_trigger : uint8_t
+{
+    BB_TRIG_MANUAL = 0,
+    BB_TRIG_FALL,
+    BB_TRIG_THRESHOLD,
+};
+
+enum blackbox_state : uint8_t
+{
+    BB_IDLE = 0,  // 未布防，不写入
+    BB_ARMED,     // 持续写入，等待触发
+    BB_TRIGGERED, // 已触发，正在录 post 段
+    BB_FROZEN,    // 已冻结，可下载
+};
+
+// 字段描述，供网页按名称解码与选择阈值通道
+struct blackbox_field
+{
+    const char *name;
+    uint16_t offset;
+    char type; // 'u' uint32, 'i' int16, 'h' uint16, 'f' float
+};
+
+struct blackbox_arm_config
+{
+    blackbox_trigger trigger;
+    int8_t channel;   // 阈值触发的 float 字段下标（blackbox_fields() 中的序号）
+    float level;      // |值| >= level 触发
+    uint8_t pre_pct;  // 触发前数据占窗口比例（%）
+};
+
+struct blackbox_status
+{
+    blackbox_state state;
+    blackbox_trigger trigger;
+    uint32_t capacity;
+    uint32_t count;       // 当前窗口内有效记录数
+    uint32_t trigger_pos; // 冻结后有效
+    bool psram;
+};
+
+bool my_blackbox_init();                       // 分配缓冲，PSRAM 不可用时退回内部 RAM 的小窗口
+void my_blackbox_record();                     // 控制任务每拍末尾调用
+void my_blackbox_arm(const blackbox_arm_config &cfg);
+void my_blackbox_trigger();                    // 手动触发
+void my_blackbox_stop();                       // 回到 IDLE
+void my_blackbox_status(blackbox_status &out);
+const blackbox_field *my_blackbox_fields(size_t &count);
+int my_blackbox_find_field(const char *name);  // 返回字段下标，-1 表示不存在
+const char *my_blackbox_trigger_name(blackbox_trigger t);
+const char *my_blackbox_state_name(blackbox_state s);
+
+// 冻结后按字节读取下载内容（文件头 + 记录），返回实际拷贝长度；total 为总长度，未冻结时为 0
+size_t my_blackbox_read(uint8_t *dst, size_t len, size_t offset, size_t &total);
@@ -6,6 +6,12 @@
 #define I2C0_SDA 42
 #define I2C0_SCL 41
 #define I2C_FREQUENCY 400000
+#define MPU6050_ASYNC 1            // 1: 采样任务经 FIFO 异步读取；0: 控制任务内阻塞读取（原方案）
+// INT 引脚（数据就绪中断）。默认 -1：未接线，采样任务每个 RTOS 节拍（1ms）轮询一次 FIFO。
+// 启用：把模块 INT 接到一个未占用且支持中断的 GPIO，在此填写引脚号；采样任务改为等中断唤醒（10ms 超时兜底）
+#define MPU6050_INT_PIN -1
+#define MPU6050_SAMPLE_RATE_HZ 1000 // 片上采样率，≤1000 时开 188Hz DLPF；400kHz I2C 下上限约 2kHz
+#define ATTITUDE_ESTIMATOR 3       // 姿态解算：0 互补 1 Mahony 2 Madgwick 3 卡尔曼（lib/MY_ATTITUDE_LIB）
 
 /********** RGB(WS2812) **********/
 #define RGB_LED_PIN         38
@@ -35,12 +41,45 @@
 #define MOTOR_B_IN2_PIN      5
 #define MOTOR_B_PWM_PIN      4
 
-/********** PWM 参数 (LEDC) **********/
+/********** PWM 参数 **********/
+#define MOTOR_PWM_LEDC      0   // LEDC：5kHz 边沿对齐，左右通道分别写入
+#define MOTOR_PWM_MCPWM     1   // MCPWM：20kHz 中心对齐，左右共用一个定时器，周期边界同时锁存
+#define MOTOR_PWM_BACKEND   MOTOR_PWM_MCPWM
+
+/* LEDC 后端 */
 #define PWM_RESOLUTION      12  // PWM 分辨率 12 位
 #define PWM_FREQ            5000
 #define MIN_DUTY            0
 #define MAX_DUTY            ((1UL << PWM_RESOLUTION) - 1)
 
+/* MCPWM 后端：增减计数，比较值在计数归零时生效；160MHz 计数时钟下每周期 4000 级（约 12 位） */
+#define MCPWM_FREQ          20000
+#define MCPWM_RESOLUTION_HZ 160000000
+
+/* 驱动死区：TB6612 开关延迟与上下管防直通死区每个脉冲吃掉的时间（手册 L→H 死区 230ns，加上升/下降沿），
+   非零占空比按当前 PWM 频率补上这段；可用示波器比较 PWMA 输入与 AO 输出的脉宽修正 */
+#define MOTOR_DEADTIME_NS   300
+
+// 1：旧输出路径（每拍 digitalWrite 方向脚 + ledcWrite），仅用于与新路径对比输出耗时
+// 0：方向/占空比缓存，变化时才写 GPIO 寄存器，PWM 按 MOTOR_PWM_BACKEND 输出
+#define MOTOR_OUTPUT_LEGACY 0
+
+/* 起转死区标定：未运行时后台二分查找，结果存 NVS，见 说明文档/MOTOR.md */
+#define MOTOR_DZ_VERIFY     1       // 1：上电读到 NVS 标定值后在 ±MOTOR_DZ_VERIFY_MARGIN 处各试探一次，不符则重新标定
+static constexpr float MOTOR_DZ_MAX = 0.5f;            // 二分区间上界（占空比），整个区间不转视为电机/编码器未接
+static constexpr uint8_t MOTOR_DZ_ITERS = 7;           // 每个方向二分轮数，分辨率 MOTOR_DZ_MAX / 2^7 ≈ 0.004
+static constexpr uint32_t MOTOR_DZ_PROBE_MS = 60;      // 每轮施加试探占空比的时间
+static constexpr uint32_t MOTOR_DZ_REST_MS = 100;      // 试探前车轮需静止（无编码器计数）的时间
+static constexpr uint32_t MOTOR_DZ_MOVE_COUNTS = 3;    // 试探期间累计计数达到此值视为起转
+static constexpr float MOTOR_DZ_VERIFY_MARGIN = 0.02f; // 快速校验的占空比余量
+
+/* 占空比映射：实测占空比-轮速曲线，见 说明文档/MOTOR.md */
+#define MOTOR_MAP_POINTS    8       // 每条曲线点数（起转占空比 ~ 满占空比等分）
+static constexpr uint32_t MOTOR_MAP_SETTLE_MS = 400;  // 每点切换后等待稳速
+static constexpr uint32_t MOTOR_MAP_MEASURE_MS = 200; // 取平均轮速的窗口
+static constexpr uint32_t MOTOR_MAP_COAST_MS = 1500;  // 正反向之间滑行停转
+static constexpr float MOTOR_MAP_MIN_SPEED = 2.0f;    // 满占空比轮速低于此值 (rad/s) 视为测量失败
+
 /********** 屏幕配置 **********/
 #define SCREEN_SDA_PIN      46
 #define SCREEN_SCL_PIN      9
@@ -54,6 +93,29 @@
 #define PITCH_SPD_DEADBAND 0.0f   // 速度环死区，单位：rad/s
 #define PITCH_TOR_DEADBAND 0.0f  // 力矩输出死区
 
+/********** 控制周期 **********/
+#define CONTROL_FIXED_DT 1        // 1：控制律用标称周期 robot.dt_ms（系数只算一次）；0：用本拍实测 robot.tick.dt
+
+/********** 编码器测速 **********/
+#ifndef ENCODER_VEL_OBSERVER
+#define ENCODER_VEL_OBSERVER 1    // 1：α-β 速度观测器（my_vel_observer.h）；0：本拍计数差 / 实测 dt
+#endif
+static constexpr float ENCODER_OBS_ACCEL = 100.0f; // 观测器加速度噪声 (rad/s²)：越大跟踪越快、越不平滑
+
+/********** 控制器选择 **********/
+#define CTRL_MODE_PID 0  // 位置 -> 速度 -> 角度 串级 PID
+#define CTRL_MODE_LQR 1  // 全状态 LQR，增益由 native_bench lqr 离线算出，经 my_params 存 NVS
+#define LQR_STATES 5     // pitch 误差 (deg), pitch 角速度 (deg/s), 位置误差 (rad), 速度误差 (rad/s), 偏航角速度误差 (deg/s)
+#define LQR_INPUTS 2     // base_duty, yaw_duty
+
+/********** 增益调度（my_sched） **********/
+#define SCHED_SPD_POINTS 4 // 速度轴点数：|轮速| 0 ~ spd_max 等距
+#define SCHED_BAT_POINTS 3 // 电压轴点数：bat_min ~ bat_max 等距
+static constexpr float SCHED_BAT_TAU_S = 1.0f;       // 电池电压低通时间常数，ADC 单次采样噪声较大
+static constexpr float SCHED_BAT_VALID_MIN = 5.0f;   // 低于此电压视为未接电池（USB 供电），不做补偿
+static constexpr float SCHED_VCOMP_MIN = 0.8f;       // 电压补偿系数限幅
+static constexpr float SCHED_VCOMP_MAX = 1.4f;
+
 /********** 速度环转换为Pitch角度配置 **********/
 static constexpr float RAD_TO_DEG_F = 57.29577951308232f;
 static constexpr float PITCH_ANGLE_OFFSET_LIMIT = 10.0f;   // 最大前倾/后仰角度修正
@@ -63,6 +125,29 @@ static constexpr float YAW_RATE_MAX_DEG_S = 200.0f;        // 摇杆满量程对
 static constexpr float YAW_RATE_CMD_DEADBAND = 0.5f;       // 摇杆转换的角速度死区
 static constexpr float YAW_TORQUE_DEADBAND = 0.02f;        // 偏航输出死区，避免轻微抖动
 
+/********** 摇杆设定值生成（my_joy） **********/
+#define JOY_QUEUE_LEN 16                                     // 网络任务 -> 控制任务的摇杆帧队列（2 的幂）
+static constexpr uint32_t JOY_DEADMAN_MS = 250;             // 超过该时间没有新帧，摇杆目标归零（网页拖动时每 50ms 发一帧）
+static constexpr uint32_t JOY_EXTRAP_MS = 60;               // 按最近两帧斜率最多外推的时长，补偿网络延迟
+static constexpr uint32_t JOY_CLOCK_CREEP_US = 20;          // 发送端时钟对齐每帧最大上调
+static constexpr uint32_t JOY_CLOCK_RESYNC_MS = 500;        // 对齐偏差超过该值（页面重载）时重新对齐
+static constexpr float JOY_TRACK_TAU = 0.03f;               // 跟踪时间常数 (s)
+static constexpr float JOY_RATE_MAX = 20.0f;                // 摇杆量最大变化率 (/s)
+static constexpr float JOY_ACC_MAX = 400.0f;                // (/s²)
+static constexpr float JOY_JERK_MAX = 20000.0f;             // (/s³)
+
+/********** 自整定配置（my_autotune） **********/
+static constexpr float AUTOTUNE_ANG_RELAY = 1.0f;        // 角度环继电幅值（base_duty 单位）
+static constexpr float AUTOTUNE_ANG_HYST = 0.2f;         // 角度环继电滞环（deg）
+static constexpr float AUTOTUNE_ANG_ABORT_DEG = 10.0f;   // 角度误差超过即中止
+static constexpr float AUTOTUNE_SPD_RELAY = 0.02f;       // 速度环继电幅值（rad，对应约 1.1° 的 pitch 偏移）
+static constexpr float AUTOTUNE_SPD_HYST = 0.3f;         // 速度环继电滞环（rad/s），大于编码器一个计数的量化
+static constexpr float AUTOTUNE_SPD_ABORT = 20.0f;       // 速度误差超过即中止（rad/s）
+static constexpr uint32_t AUTOTUNE_SETTLE_MS = 500;      // 开始前需连续稳定的时间
+static constexpr uint32_t AUTOTUNE_TIMEOUT_MS = 20000;   // 单个环的最长激励时间
+static constexpr uint8_t AUTOTUNE_SKIP_CYCLES = 2;       // 丢弃起振阶段的周期数
+static constexpr uint8_t AUTOTUNE_CYCLES = 6;            // 参与平均的周期数
+
 /********** wifi配置 **********/
 #define SSID_PREFIX "BalBot"  // SSID前缀，后面会自动加MAC后缀（例：BalBot_AABB）
 #define SSID "Balance_Robot"  // 兼容旧代码的默认SSID
@@ -71,7 +156,21 @@ static constexpr float YAW_TORQUE_DEADBAND = 0.02f;        // 偏航输出死区
 /********** 车队配置 **********/
 // ESP-NOW配置常量已在my_group.h中定义
 // 这里仅保留应用层配置
-#define GROUP_COMMAND_SEND_INTERVAL_MS 2  // 头车发送指令间隔（与dt_ms一致）
+// ESP-NOW 发送（my_group 的发送任务，控制任务只投递最新指令，不调用 WiFi 驱动）
+static constexpr uint16_t GROUP_TX_MAX_HZ = 100;         // 默认最高发送频率，可在网页修改（存 NVS）
+static constexpr uint16_t GROUP_TX_MAX_HZ_LIMIT = 500;   // 上限：控制频率
+static constexpr uint32_t GROUP_TX_KEEPALIVE_MS = 50;    // 指令不变时的重发间隔（连丢 3 帧仍在摇杆失联判定以内）
+static constexpr uint32_t GROUP_TX_DONE_TIMEOUT_MS = 20; // 等待发送完成回调的上限
+static constexpr float GROUP_TX_DUTY_EPS = 0.005f;       // 占空比变化超过该值才算新指令
+static constexpr float GROUP_TX_POS_EPS = 0.05f;         // 设定值：头车里程变化 (rad)
+static constexpr float GROUP_TX_VEL_EPS = 0.2f;          // 设定值：目标/实测轮速变化 (rad/s)
+static constexpr float GROUP_TX_YAW_EPS = 1.0f;          // 设定值：目标偏航角速度变化 (deg/s)
+// 设定值模式（FleetMode::SETPOINT，my_fleet）
+static constexpr uint32_t GROUP_SETPOINT_INTERVAL_MS = 20; // 头车广播设定值间隔（从车经 my_joy 外推与平滑）
+static constexpr float FLEET_FORM_KP = 2.0f;               // 队形误差 (rad) -> 轮速修正 (rad/s)
+static constexpr float FLEET_FORM_KD = 0.5f;               // 两车轮速差 (rad/s) -> 轮速修正，抑制起停超调
+static constexpr float FLEET_FORM_SPD_MAX = 3.0f;          // 轮速修正上限 (rad/s)
+static constexpr float FLEET_FORM_DEADBAND = 0.2f;         // 队形误差死区 (rad)，以内不修正，松杆后位置环锁定
 
 /********** 电池检测 **********/
 #define BAT_PIN 10
@@ -94,6 +193,41 @@ struct pid_config
     float l; // 最值限制
 };
 
+struct lqr_config
+{
+    float k[LQR_INPUTS][LQR_STATES]; // u = K * x，单位与 base_duty/yaw_duty 一致
+};
+
+// 增益调度表：按 |轮速| × 电池电压双线性插值出角度环/速度环的增益倍率，
+// 电压补偿把归一化指令换算到标称电压下的等效占空比
+struct sched_config
+{
+    uint8_t enable;                                   // 增益调度开关（关闭时倍率恒为 1）
+    uint8_t vcomp;                                    // drive_motor 电压补偿开关
+    float spd_max;                                    // 速度轴上限 (rad/s)
+    float bat_min, bat_max;                           // 电压轴范围 (V)
+    float v_nom;                                      // 标称电压 (V)，死区标定与 PID 整定时的电压
+    float ang[SCHED_BAT_POINTS][SCHED_SPD_POINTS];    // 角度环倍率（P/I 与陀螺 D 一起缩放）
+    float spd[SCHED_BAT_POINTS][SCHED_SPD_POINTS];    // 速度环倍率
+};
+
+// 占空比映射曲线：左正/左反/右正/右反，每条 MOTOR_MAP_POINTS 点，轮速取绝对值
+enum motor_curve_index : uint8_t
+{
+    MOTOR_CURVE_L_FWD = 0,
+    MOTOR_CURVE_L_REV,
+    MOTOR_CURVE_R_FWD,
+    MOTOR_CURVE_R_REV,
+    MOTOR_CURVE_COUNT
+};
+
+struct motor_map_config
+{
+    uint8_t enable;                                      // 1：按曲线映射；0 或曲线无效：起转占空比 + 直线
+    float duty[MOTOR_CURVE_COUNT][MOTOR_MAP_POINTS];     // 递增
+    float speed[MOTOR_CURVE_COUNT][MOTOR_MAP_POINTS];    // 对应空载稳态轮速 (rad/s)，单调不减
+};
+
 struct motion_state
 {
     float now;
@@ -141,6 +275,16 @@ struct wel_data
     float pos2;
 };
 
+struct tick_state
+{
+    float dt;             // 本拍实测周期 (s)，编码器测速与 PID 统一使用
+    uint32_t last_us;     // 上一拍时间戳
+    uint32_t count;       // 节拍计数
+    uint32_t overrun;     // 错过的节拍数（执行超时或被抢占）
+    uint32_t exec_us;     // 本拍执行耗时
+    uint32_t exec_max_us; // 最大执行耗时
+};
+
 struct rgb_state
 {
     int rgb_count; // 灯珠数量
@@ -151,6 +295,7 @@ struct robot_state
 {
     int dt_ms;
     int data_ms;
+    tick_state tick;       //控制节拍统计
 
     bool run;              //运行指示位
     bool chart_enable;     //图表推送位
@@ -181,4 +326,9 @@ struct robot_state
     pid_config spd_pid;
     pid_config pos_pid;
     pid_config yaw_pid;
+
+    uint8_t ctrl_mode;     // CTRL_MODE_PID / CTRL_MODE_LQR
+    lqr_config lqr;
+    sched_config sched;
+    motor_map_config motor_map;
 };
@@ -13,6 +13,8 @@ extern void robot_state_update();
 extern void robot_pos_control();
 extern void pitch_control();
 extern void yaw_control();
+extern void lqr_control();
+extern void control_mode_check();
 extern void pitch_zero_adapt();
 extern void fall_check();
 extern void control_idle_reset();
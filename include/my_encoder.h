@@ -3,7 +3,7 @@
 #include "my_config.h"
 
 void my_encoder_init();     // 初始化编码器硬件
-void my_encoder_update();   // 读取并复位本周期计数增量，并更新 wel 速度/位置
+void my_encoder_update();   // 读取 64 位累计计数、求本周期增量，并更新 wel 速度/位置（硬件计数器不清零）
 
 extern volatile int32_t Encoder_Left_Delta;  // 左编码器周期脉冲增量
 extern volatile int32_t Encoder_Right_Delta; // 右编码器周期脉冲增量
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+#include "my_group.h"
+
+// 编队设定值模式（FleetMode::SETPOINT）
+//   头车：照常自平衡，每 GROUP_SETPOINT_INTERVAL_MS 广播目标轮速、偏航角速度、里程、实测轮速与队形偏移
+//   从车：同样运行自己的平衡串级/LQR；设定值换算成本车摇杆量交给 my_joy（按头车时间戳对齐、外推、平滑），
+//         再按与头车的里程差修正速度目标以保持队形；跟随头车的启停，失联时目标归零、原地平衡
+// 头车每拍广播占空比（FleetMode::DUTY）的方式保留给刚性连接的车队
+
+struct fleet_status
+{
+    bool follower;      // 本机为设定值模式的从车
+    bool tracking;      // 从车：队形原点有效，正在跟随
+    uint32_t setpoints; // 从车：收到的设定值帧；头车：交给发送任务的设定值帧（未变化的由发送任务跳过）
+    float pos_err;      // 从车：队形误差 (rad)，正值表示落后
+    float spd_corr;     // 从车：队形修正的轮速 (rad/s)
+};
+
+// 控制任务
+bool my_fleet_follower(); // 本机为设定值模式的从车（网页摇杆不生效）
+void my_fleet_push(const fleet_setpoint &sp, uint32_t tx_us, uint32_t rx_us); // my_state_drain() 取出的设定值
+void my_fleet_update();   // 每拍，robot_state_update() 之后：从车叠加队形修正，头车按间隔广播
+
+// 其他任务
+void my_fleet_status(fleet_status &out);
@@ -2,11 +2,14 @@
 
 #include <Arduino.h>
 #include <cstdint>
+#include "my_fleet_proto.h"
+#include "my_fleet_tx.h"
 
 /********** 车队配置 **********/
 #define GROUP_NVS_NAMESPACE "group_cfg"
 #define GROUP_COMMAND_TIMEOUT_MS 500  // 从车超时时间
 #define GROUP_MAX_FOLLOWERS 20        // ESP-NOW最大peer数
+#define GROUP_RSSI_PROMISC 1          // 1: 开启混杂模式（仅管理帧）读取各 peer 的 RSSI
 
 /********** 车辆角色枚举 **********/
 enum class VehicleRole : uint8_t
@@ -16,6 +19,13 @@ enum class VehicleRole : uint8_t
     FOLLOWER = 2     // 从车
 };
 
+/********** 编队控制方式 **********/
+enum class FleetMode : uint8_t
+{
+    DUTY = 0,        // 头车每拍广播左右占空比，从车关闭平衡直接输出（刚性连接的车队）
+    SETPOINT = 1     // 头车低频广播目标轮速/偏航角速度/里程，从车自平衡跟踪（my_fleet）
+};
+
 /********** 车队配置结构 **********/
 struct group_config
 {
@@ -23,34 +33,74 @@ struct group_config
     uint8_t leader_mac[6];      // 头车MAC地址（从车需要）
     uint8_t group_id;           // 车队ID
     bool espnow_enabled;        // ESP-NOW启用状态
+    FleetMode fleet_mode;       // 编队控制方式（头车与从车须一致）
+    float formation_offset;     // 头车：广播的队形偏移 (rad)，可在线修改
+    uint16_t tx_max_hz;         // 指令最高发送频率，可在线修改
 };
 
-/********** 运动指令结构（ESP-NOW传输） **********/
+/********** ESP-NOW 负载（帧头、序号、CRC 见 my_fleet_proto.h） **********/
+// 运动指令（FLEET_MSG_MOTION，头车 -> 从车）
 struct motion_command
 {
     float L_duty;               // 左轮占空比 (-1.0 ~ 1.0)
     float R_duty;               // 右轮占空比 (-1.0 ~ 1.0)
-    uint32_t timestamp;         // 时间戳（毫秒）
-    uint8_t group_id;           // 车队ID
-    uint8_t checksum;           // 简单校验和
 } __attribute__((packed));
 
-/********** 从车心跳结构（从车 -> 头车） **********/
+// 高层设定值（FLEET_MSG_SETPOINT，头车 -> 从车，FleetMode::SETPOINT）
+#define FLEET_SP_RUN 0x01       // 头车处于运行状态
+struct fleet_setpoint
+{
+    float spd;                  // 目标轮速 (rad/s)
+    float yaw_rate;             // 目标偏航角速度 (deg/s)
+    float pos;                  // 头车里程 (rad)，从车据此保持队形
+    float vel;                  // 头车实测轮速 (rad/s)，用于外推里程与队形阻尼
+    float offset;               // 队形偏移 (rad)，正值为相对起始队形前移
+    uint8_t flags;              // FLEET_SP_*
+} __attribute__((packed));
+
+// 一侧测得的链路质量，随心跳上报
+struct fleet_link_report
+{
+    uint16_t loss_permille;     // 最近一个心跳周期的丢包率 (‰)
+    uint16_t jitter_us;         // 到达抖动（饱和到 65535）
+    int8_t rssi;                // 最近一帧 RSSI (dBm)，0 为未知
+    int8_t rssi_min;            // 最差 RSSI
+    uint16_t rejected;          // 累计错误帧（饱和）
+} __attribute__((packed));
+
+// 从车心跳（FLEET_MSG_HEARTBEAT，从车 -> 头车）
 struct follower_heartbeat
 {
-    uint8_t follower_mac[6];    // 从车MAC地址
-    uint8_t group_id;           // 车队ID
-    uint32_t timestamp;         // 时间戳
     uint8_t battery_level;      // 电池电量 (0-100)
-    uint8_t checksum;           // 校验和
+    fleet_link_report down;     // 从车测得的下行（运动指令）链路
 } __attribute__((packed));
 
+/********** 发送统计 **********/
+// 指令与心跳都由发送任务调用 esp_now_send；完成结果来自发送回调
+// 广播帧没有 ACK，回调成功只表示已发上空口；单播（从车心跳）为对端已确认
+struct fleet_tx_stats
+{
+    uint32_t posted;            // 控制任务投递的指令（队列长 1，发送任务来不及取的被新指令覆盖）
+    fleet_tx_counts sched;      // 发送调度计数（见 my_fleet_tx.h）
+    uint32_t heartbeats;        // 从车：发出的心跳
+    uint32_t ok;                // 发送回调：成功
+    uint32_t fail;              // 发送回调：失败（单播未收到 ACK）
+    uint32_t error;             // esp_now_send 返回错误
+    uint32_t timeout;           // 超过 GROUP_TX_DONE_TIMEOUT_MS 未收到回调
+    uint32_t done_mean_us;      // esp_now_send 到回调的平均耗时
+    uint32_t done_max_us;
+    uint16_t max_hz;            // 当前最高发送频率
+};
+
 /********** 从车状态结构 **********/
 struct follower_info
 {
     uint8_t mac[6];             // MAC地址
     uint32_t last_seen;         // 最后心跳时间
     bool online;                // 是否在线
+    uint8_t battery_level;
+    FleetLink up;               // 头车测得的上行（心跳）链路
+    fleet_link_report down;     // 从车上报的下行链路
 };
 
 /********** 全局变量 **********/
@@ -72,9 +122,13 @@ void my_group_espnow_init();
 bool my_group_config_save(const group_config &cfg);
 bool my_group_config_load(group_config &cfg);
 void my_group_set_role(VehicleRole role, const uint8_t *leader_mac = nullptr);
+void my_group_set_formation_offset(float offset); // 立即生效（头车下一帧设定值即带上），不存 NVS
+void my_group_set_tx_rate(uint16_t hz);           // 立即生效，不存 NVS；限幅到 1 ~ GROUP_TX_MAX_HZ_LIMIT
 
-// 通信接口
-void my_group_send_command(float left_duty, float right_duty);
+// 通信接口：控制任务投递最新指令，只入队不调用 WiFi 驱动；由发送任务按变化/保活/限速发出
+void my_group_send_command(float left_duty, float right_duty); // FleetMode::DUTY
+void my_group_send_setpoint(const fleet_setpoint &sp);         // FleetMode::SETPOINT
+void my_group_tx_stats(fleet_tx_stats &out);                   // 其他任务
 bool my_group_is_command_timeout();
 
 // 获取当前配置
@@ -86,12 +140,15 @@ void my_group_get_mac(uint8_t *mac);
 // ESP-NOW状态
 bool my_group_espnow_is_ready();
 
-// 从车心跳（从车调用）
-void my_group_send_heartbeat();
-
-// 获取从车列表（头车调用）
+// 获取从车列表（头车调用）：按加入顺序返回全部已发现的从车（含离线），下标固定
 int my_group_get_followers(follower_info *followers, int max_count);
 
+// 从车测得的头车链路（从车调用）
+void my_group_leader_link(fleet_link_stats &out);
+
+// 收到的错误帧按原因累计（下标为 fleet_decode_result）；已知 peer 的同时计入其 rejected
+void my_group_rx_errors(uint32_t (&out)[FLEET_ERR_COUNT]);
+
 // 更新从车在线状态
 void my_group_update_followers_status();
 
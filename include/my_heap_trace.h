@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 堆分配计数：链接时用 --wrap 截获 malloc/calloc/realloc，只累加次数，不改变分配行为
+// 关注任务单独计数，用于证明遥测等周期路径在稳态下不分配堆内存
+
+struct heap_trace_info
+{
+    uint32_t total;      // 全部任务累计分配次数
+    uint32_t watched;    // 关注任务累计分配次数
+    uint32_t free_bytes; // 内部 RAM 空闲
+    uint32_t min_free;   // 开机以来最低空闲
+    uint32_t largest;    // 最大连续空闲块（碎片化程度）
+};
+
+void my_heap_trace_watch();           // 关注调用方所在任务（每个进程只关注一个任务）
+uint32_t my_heap_trace_watched();     // 关注任务累计分配次数，前后相减即一段代码的分配次数
+void my_heap_trace_info(heap_trace_info &out);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+// 摇杆设定值生成：网页摇杆帧带发送端时间戳，经单生产者单消费者队列送到控制任务（my_state），
+// 控制任务按时间戳对齐、外推，再经限加加速度跟踪生成每拍的 robot.joy.x/y（my_setpoint.h），
+// 取代原先到帧即写 + 速度目标低通；超过 JOY_DEADMAN_MS 没有新帧时目标归零
+
+struct joy_sample
+{
+    float x, y, a;
+    uint32_t sender_us; // 发送端时间戳（网页 performance.now() 换算），旧页面不带时取 rx_us
+    uint32_t rx_us;     // 网络任务收到的时刻（micros）
+};
+
+struct joy_stats
+{
+    uint32_t samples;  // 已处理的帧数
+    uint32_t dropped;  // 队列满丢弃的帧数
+    uint32_t deadman;  // 失联保护触发次数
+    uint32_t delay_us; // 最近一帧比最快一帧多出的网络延迟
+};
+
+// 控制任务
+void my_joy_push(const joy_sample &s); // my_state_drain() 取出的每一帧
+void my_joy_update();                  // 每拍：生成 robot.joy.x/y/a
+
+// 其他任务
+void my_joy_dropped(); // 投递方：队列满
+void my_joy_stats(joy_stats &out);
@@ -5,5 +5,54 @@
 extern volatile float motor_left_u;   // 左轮归一化指令（-1~1）
 extern volatile float motor_right_u;  // 右轮归一化指令（-1~1）
 
-void my_motor_init();                               // 初始化电机引脚、PWM通道以及死区校准流程
-void my_motor_update();    
+// 输出级统计：只计 my_motor_update() 中写硬件的部分（方向脚 + PWM 比较值），上电后累计
+struct motor_out_stats
+{
+    uint32_t updates;     // my_motor_update 调用次数
+    uint32_t dir_writes;  // 实际写方向脚的次数（每侧计一次）
+    uint32_t duty_writes; // 实际写 PWM 的次数（每侧计一次）
+    uint32_t cycles_last; // 本拍写硬件耗时（CPU 周期）
+    uint32_t cycles_max;
+    uint64_t cycles_sum;
+};
+
+void my_motor_init();                      // 初始化电机引脚、PWM，读取 NVS 中的死区（标定在控制任务中后台进行）
+void my_motor_update();                    // 控制任务每拍调用：指令 -> 方向/占空比，变化时才写硬件
+const motor_out_stats &my_motor_stats();   // 控制任务写，其他任务只读（数值可能差一拍）
+
+// 起转死区标定状态（pending/verify/search/done/failed）
+struct motor_cal_status
+{
+    const char *state;
+    bool loaded; // NVS 中有标定值
+    bool active; // 正在试探（未运行时占用电机输出）
+};
+
+void my_motor_calibrate();                         // 网络任务：要求重新完整标定（未运行时进行）
+void my_motor_cal_status(motor_cal_status &out);
+void my_motor_service();                           // 低优先级任务周期调用：标定完成后写 NVS
+
+// 占空比-轮速曲线测量：车轮架空、未运行时由控制任务执行，两轮同向逐点加占空比，
+// 稳速后取平均轮速（先正向后反向），完成后写入 robot.motor_map 并启用，保存由网页触发
+enum motor_map_state : uint8_t
+{
+    MM_IDLE = 0,
+    MM_RUNNING,
+    MM_DONE,
+    MM_FAILED,
+};
+
+struct motor_map_status
+{
+    motor_map_state state;
+    uint8_t point;        // 已完成点数
+    uint8_t points_total; // 2 * MOTOR_MAP_POINTS（正反向）
+    const char *error;    // MM_FAILED 时的原因
+};
+
+// 网络任务
+void my_motor_map_measure();
+void my_motor_map_abort();
+void my_motor_map_status(motor_map_status &out);
+const char *my_motor_map_state_name(motor_map_state s);
+const char *my_motor_pwm_backend_name();
@@ -1,8 +1,23 @@
 #pragma once
-#include <MPU6050_tockn.h>
 
-extern MPU6050 mpu6050;
-// MPU6050实例
+#include <stdint.h>
+
+// MPU6050实例定义在 my_mpu6050.cpp 中，头文件不依赖具体驱动，便于主机仿真替换
+
+// 异步采样统计（MPU6050_ASYNC=0 时只有 samples 有效）
+struct imu_fifo_stats
+{
+    uint32_t samples;       // 已处理的样本数
+    uint32_t fifo_overflow; // 片上 FIFO 溢出/错位复位次数
+    uint32_t ring_drop;     // 环形缓冲满丢弃数
+    uint32_t i2c_error;     // I2C 读失败次数
+    uint32_t stale;         // 控制节拍取不到新样本的次数
+    uint32_t last_batch;    // 最近一次读出的 FIFO 帧数
+    uint32_t age_us;        // 控制节拍使用的样本距今时间
+};
+
 extern void my_mpu6050_init();
 extern void my_mpu6050_setzero();
-extern void my_mpu6050_update();
\ No newline at end of file
+extern void my_mpu6050_update();
+extern bool my_mpu6050_probe(); // 开机自检：IMU 是否在线
+extern const imu_fifo_stats &my_mpu6050_stats();
@@ -45,6 +45,7 @@ IPAddress wifi_ap_ip();
 #define CHART_12 robot.ang.now
 #define CHART_NAME13 "err"
 #define CHART_13 robot.ang.err
+#define CHART_STEP1 {0.01f, 0.01f, 0.01f} // 各路量化精度（差分遥测）
 
 // 图表2：控制力矩输出 - 各环输出力矩
 #define CHART_NAME2 "力矩输出"
@@ -54,6 +55,7 @@ IPAddress wifi_ap_ip();
 #define CHART_22 (robot.spd.duty * 10.0f)
 #define CHART_NAME23 "pos×10"
 #define CHART_23 (robot.pos.duty * 10.0f)
+#define CHART_STEP2 {0.1f, 0.1f, 0.1f}
 
 // 图表3：速度与位置跟踪
 #define CHART_NAME3 "速度跟踪"
@@ -63,6 +65,7 @@ IPAddress wifi_ap_ip();
 #define CHART_32 robot.spd.tar
 #define CHART_NAME33 "pos_err×10"
 #define CHART_33 (robot.pos.err * 10.0f)
+#define CHART_STEP3 {0.01f, 0.01f, 0.01f}
 
 #endif
 
@@ -74,6 +77,7 @@ IPAddress wifi_ap_ip();
 #define CHART_NAME12 "spd"
 #define CHART_13 robot.wel.pos1
 #define CHART_NAME13 "pos"
+#define CHART_STEP1 {0.01f, 0.01f, 0.01f}
 
 #define CHART_NAME2 "R"
 #define CHART_21 robot.tor.R
@@ -82,6 +86,7 @@ IPAddress wifi_ap_ip();
 #define CHART_NAME22 "spd"
 #define CHART_23 robot.wel.pos2
 #define CHART_NAME23 "pos"
+#define CHART_STEP2 {0.01f, 0.01f, 0.01f}
 
 #define CHART_NAME3 "0"
 #define CHART_31 0
@@ -90,34 +95,36 @@ IPAddress wifi_ap_ip();
 #define CHART_NAME32 "0"
 #define CHART_33 0
 #define CHART_NAME33 "0"
+#define CHART_STEP3 {1.0f, 1.0f, 1.0f}
 #endif
 
 // 滑块关联数据 =============================================
+// 按 pid_gains 成员展开（见 my_state.h），网页桥接层在参数副本上读写，经命令邮箱交给控制任务
 #define SLIDER_NAME1 "平衡控制参数"
 #define SLIDER_NAME11 "P"
-#define SLIDER_11 robot.ang_pid.p
+#define SLIDER_11 pid.ang.p
 #define SLIDER_NAME12 "I"
-#define SLIDER_12 robot.ang_pid.i
+#define SLIDER_12 pid.ang.i
 #define SLIDER_NAME13 "D"
-#define SLIDER_13 robot.ang_pid.d
+#define SLIDER_13 pid.ang.d
 #define SLIDER_NAME2 "速度控制参数"
 #define SLIDER_NAME21 "P"
-#define SLIDER_21 robot.spd_pid.p
+#define SLIDER_21 pid.spd.p
 #define SLIDER_NAME22 "I"
-#define SLIDER_22 robot.spd_pid.i
+#define SLIDER_22 pid.spd.i
 #define SLIDER_NAME23 "D"
-#define SLIDER_23 robot.spd_pid.d
+#define SLIDER_23 pid.spd.d
 #define SLIDER_NAME3 "位置控制参数"
 #define SLIDER_NAME31 "P"
-#define SLIDER_31 robot.pos_pid.p
+#define SLIDER_31 pid.pos.p
 #define SLIDER_NAME32 "I"
-#define SLIDER_32 robot.pos_pid.i
+#define SLIDER_32 pid.pos.i
 #define SLIDER_NAME33 "D"
-#define SLIDER_33 robot.pos_pid.d
+#define SLIDER_33 pid.pos.d
 #define SLIDER_NAME4 "转向控制参数"
 #define SLIDER_NAME41 "P"
-#define SLIDER_41 robot.yaw_pid.p
+#define SLIDER_41 pid.yaw.p
 #define SLIDER_NAME42 "I"
-#define SLIDER_42 robot.yaw_pid.i
+#define SLIDER_42 pid.yaw.i
 #define SLIDER_NAME43 "D"
-#define SLIDER_43 robot.yaw_pid.d
+#define SLIDER_43 pid.yaw.d
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "my_config.h"
+
 /**
  * 机器人参数持久化保存/加载模块
  * 使用ESP32的NVS（Non-Volatile Storage）保存参数
@@ -23,3 +25,10 @@ bool my_params_load();
  */
 bool my_params_clear();
 
+
+/**
+ * 起转死区（左正/左反/右正/右反）单独存取，标定完成后由低优先级任务保存
+ * @return true 成功（读取时 NVS 中无记录返回 false，dz 不变）
+ */
+bool my_params_load_deadzone(float (&dz)[MOTOR_CURVE_COUNT]);
+bool my_params_save_deadzone(const float (&dz)[MOTOR_CURVE_COUNT]);
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+// 控制环分段计时：CPU 周期计数 + 固定桶直方图
+// 写入方只有控制任务；其他任务只读统计结果，清零通过标志位交给控制任务执行
+
+enum perf_stage : uint8_t
+{
+    PERF_IMU = 0,   // my_mpu6050_update()（异步模式下仅出队）
+    PERF_ENCODER,   // my_encoder_update()
+    PERF_CONTROL,   // 拍首命令生效（my_state_drain/my_joy_update）+ PID 串级 / 编队逻辑
+    PERF_MOTOR,     // my_motor_update()
+    PERF_ESPNOW,    // 车队：投递指令到发送任务 + 设定值模式的 my_fleet_update
+    PERF_TOTAL,     // 整个 my_motion_update()
+    PERF_PERIOD,    // 实测节拍周期（抖动）
+    PERF_STAGE_COUNT
+};
+
+struct perf_summary
+{
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    float mean_us;
+    uint32_t p50_us;
+    uint32_t p99_us;
+};
+
+uint32_t my_perf_now();                                    // 当前周期计数
+uint32_t my_perf_record(perf_stage stage, uint32_t start); // 记录 start 至今耗时，返回当前计数便于串联下一段
+void my_perf_add_cycles(perf_stage stage, uint32_t cycles); // 记录一段已累计的周期数
+void my_perf_add_us(perf_stage stage, uint32_t us);        // 直接记录一个微秒值
+uint32_t my_perf_cycles_to_us(uint32_t cycles);
+void my_perf_late();                                       // 本拍执行超过周期
+uint32_t my_perf_late_count();
+void my_perf_summary(perf_stage stage, perf_summary &out);
+const char *my_perf_stage_name(perf_stage stage);
+void my_perf_request_reset();                              // 任意任务可调用，下一拍生效
+void my_perf_service();                                    // 控制任务每拍调用，处理清零请求
@@ -0,0 +1,15 @@
+#pragma once
+
+// 增益调度与电压补偿
+// 控制任务每拍调用 my_sched_update()：电池电压低通后与 |轮速| 一起查 robot.sched 表（等距网格双线性插值），
+// 结果放在下列全局量里，pitch_control() 的角度环/速度环按倍率缩放，drive_motor() 按 sched_vcomp 补偿电压
+// 表由网页修改（my_params 存 NVS），修改后调用 my_sched_request_reload()，下一拍在控制任务里重算轴
+// 自整定进行中倍率固定为 1，避免辨识结果混入调度
+
+extern float sched_ang_gain; // 角度环倍率（含陀螺 D 项）
+extern float sched_spd_gain; // 速度环倍率
+extern float sched_vcomp;    // 电压补偿系数 v_nom / v_bat（关闭或未接电池时为 1）
+extern float sched_vbat;     // 低通后的电池电压 (V)
+
+void my_sched_update();         // 控制任务：每拍在控制律之前调用
+void my_sched_request_reload(); // 任意任务：robot.sched 轴参数已修改
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "my_config.h"
+#include "my_joy.h"
+
+struct fleet_setpoint;
+
+// 控制任务与其他任务之间的 robot 数据交换
+//   控制任务 -> 其他任务：每拍末尾发布一份完整 robot 快照（双缓冲 seqlock），遥测与网页读取快照，
+//     不再直接读正在被改写的 robot，同一帧里的各字段一定来自同一拍
+//   其他任务 -> 控制任务：命令邮箱，后投递的覆盖未生效的；控制任务每拍开头统一取出写入 robot，
+//     PID/LQR 参数与运行开关不会在串级计算中途变化；摇杆帧走队列，每帧都交给 my_joy
+// 每个邮箱/队列只允许一个投递任务（见各函数注释）
+
+struct pid_gains
+{
+    pid_config ang, spd, pos, yaw;
+};
+
+struct lqr_gains
+{
+    uint8_t ctrl_mode; // CTRL_MODE_PID / CTRL_MODE_LQR
+    lqr_config lqr;
+};
+
+// 控制任务
+void my_state_drain();   // 每拍开头：取出邮箱中的命令写入 robot
+void my_state_publish(); // 每拍末尾：发布快照
+void my_state_follower(float &left, float &right); // 最近一次收到的从车占空比指令
+
+// 其他任务
+uint32_t my_state_snapshot(robot_state &out); // 返回快照对应的发布序号，0 表示控制任务尚未运行（out 为当前 robot）
+void my_cmd_joystick(const joy_sample &s);          // 网络任务；队列满时丢弃并计数
+void my_cmd_run(bool run);                          // 网络任务
+void my_cmd_pid(const pid_gains &g, bool save);     // 网络任务；save 为 true 时生效后再存 NVS
+void my_cmd_lqr(const lqr_gains &g, bool save);     // 网络任务
+void my_cmd_sched(const sched_config &s, bool save); // 网络任务；生效时重算调度表轴
+void my_cmd_pitch_zero(float zero, bool save);      // 网络任务；控制任务中与重心自适应在同一处修改
+void my_state_request_save();                       // 网络任务：没有待生效的命令，直接请求遥测任务保存
+void my_cmd_follower(float left, float right);      // ESP-NOW 接收回调
+void my_cmd_fleet_setpoint(const fleet_setpoint &sp, uint32_t tx_us, uint32_t rx_us); // ESP-NOW 接收回调
+// 网络任务：当前参数，本任务投递过的取最近一次投递值（控制任务可能尚未生效，回显与在其上修改都以它为准）
+void my_state_pid(pid_gains &out);
+void my_state_lqr(lqr_gains &out);
+void my_state_sched(sched_config &out);
+bool my_state_take_save_request(); // 遥测任务：参数已在控制任务中生效，需要 my_params_save()
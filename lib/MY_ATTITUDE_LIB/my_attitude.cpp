@@ -0,0 +1,288 @@
+#include "my_attitude.h"
+#include <math.h>
+
+namespace
+{
+    constexpr float DegToRad = 0.017453292519943295f;
+    constexpr float RadToDeg = 57.29577951308232f;
+
+    // 加速度模长偏离 1g 超过该比例时（冲击、急加速）不用加速度修正
+    constexpr float AccTrustBand = 0.3f;
+
+    float inv_sqrt(float x)
+    {
+        return 1.0f / sqrtf(x);
+    }
+
+    bool acc_usable(const attitude_input &in, float &norm_sq)
+    {
+        norm_sq = in.ax * in.ax + in.ay * in.ay + in.az * in.az;
+        return norm_sq > (1.0f - AccTrustBand) * (1.0f - AccTrustBand) &&
+               norm_sq < (1.0f + AccTrustBand) * (1.0f + AccTrustBand);
+    }
+
+    // 加速度计倾角（deg），与 MPU6050_tockn 的公式一致
+    float acc_angle_x(const attitude_input &in)
+    {
+        return atan2f(in.ay, in.az + fabsf(in.ax)) * RadToDeg;
+    }
+
+    float acc_angle_y(const attitude_input &in)
+    {
+        return -atan2f(in.ax, in.az + fabsf(in.ay)) * RadToDeg;
+    }
+
+    // 由静止加速度得到初始四元数（yaw = 0）
+    void quat_from_acc(const attitude_input &in, float q[4])
+    {
+        const float roll = acc_angle_x(in) * DegToRad * 0.5f;
+        const float pitch = acc_angle_y(in) * DegToRad * 0.5f;
+        const float cr = cosf(roll), sr = sinf(roll);
+        const float cp = cosf(pitch), sp = sinf(pitch);
+        q[0] = cr * cp;
+        q[1] = sr * cp;
+        q[2] = cr * sp;
+        q[3] = -sr * sp;
+    }
+
+    void quat_to_output(const float q[4], const attitude_input &in, attitude_output &out)
+    {
+        const float sinp = 2.0f * (q[0] * q[2] - q[3] * q[1]);
+        out.anglex = atan2f(2.0f * (q[0] * q[1] + q[2] * q[3]), 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2])) * RadToDeg;
+        out.angley = asinf(sinp > 1.0f ? 1.0f : (sinp < -1.0f ? -1.0f : sinp)) * RadToDeg;
+        out.anglez = atan2f(2.0f * (q[0] * q[3] + q[1] * q[2]), 1.0f - 2.0f * (q[2] * q[2] + q[3] * q[3])) * RadToDeg;
+        out.gyrox = in.gx;
+        out.gyroy = in.gy;
+        out.gyroz = in.gz;
+    }
+
+    void quat_integrate(float q[4], float gx, float gy, float gz, float dt_s)
+    {
+        const float h = 0.5f * dt_s;
+        const float q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+        q[0] += (-q1 * gx - q2 * gy - q3 * gz) * h;
+        q[1] += (q0 * gx + q2 * gz - q3 * gy) * h;
+        q[2] += (q0 * gy - q1 * gz + q3 * gx) * h;
+        q[3] += (q0 * gz + q1 * gy - q2 * gx) * h;
+        const float n = inv_sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        q[0] *= n;
+        q[1] *= n;
+        q[2] *= n;
+        q[3] *= n;
+    }
+}
+
+/********** 互补滤波 **********/
+ComplementaryFilter::ComplementaryFilter(float tau_s) : tau_(tau_s)
+{
+}
+
+void ComplementaryFilter::reset(const attitude_input &in)
+{
+    out_.anglex = acc_angle_x(in);
+    out_.angley = acc_angle_y(in);
+    out_.anglez = 0.0f;
+}
+
+void ComplementaryFilter::update(const attitude_input &in, float dt_s)
+{
+    const float k = tau_ / (tau_ + dt_s);
+    out_.anglex = k * (out_.anglex + in.gx * dt_s) + (1.0f - k) * acc_angle_x(in);
+    out_.angley = k * (out_.angley + in.gy * dt_s) + (1.0f - k) * acc_angle_y(in);
+    out_.anglez += in.gz * dt_s;
+    out_.gyrox = in.gx;
+    out_.gyroy = in.gy;
+    out_.gyroz = in.gz;
+}
+
+/********** Mahony **********/
+MahonyFilter::MahonyFilter(float kp, float ki)
+    : kp_(kp), ki_(ki), q_{1.0f, 0.0f, 0.0f, 0.0f}, integral_{0.0f, 0.0f, 0.0f}
+{
+}
+
+void MahonyFilter::reset(const attitude_input &in)
+{
+    quat_from_acc(in, q_);
+    integral_[0] = integral_[1] = integral_[2] = 0.0f;
+    quat_to_output(q_, in, out_);
+}
+
+void MahonyFilter::update(const attitude_input &in, float dt_s)
+{
+    float gx = in.gx * DegToRad;
+    float gy = in.gy * DegToRad;
+    float gz = in.gz * DegToRad;
+
+    float norm_sq;
+    if (acc_usable(in, norm_sq))
+    {
+        const float n = inv_sqrt(norm_sq);
+        const float ax = in.ax * n, ay = in.ay * n, az = in.az * n;
+        // 估计的重力方向（机体系）
+        const float vx = 2.0f * (q_[1] * q_[3] - q_[0] * q_[2]);
+        const float vy = 2.0f * (q_[0] * q_[1] + q_[2] * q_[3]);
+        const float vz = q_[0] * q_[0] - q_[1] * q_[1] - q_[2] * q_[2] + q_[3] * q_[3];
+        // 误差 = 实测 × 估计
+        const float ex = ay * vz - az * vy;
+        const float ey = az * vx - ax * vz;
+        const float ez = ax * vy - ay * vx;
+        if (ki_ > 0.0f)
+        {
+            integral_[0] += ki_ * ex * dt_s;
+            integral_[1] += ki_ * ey * dt_s;
+            integral_[2] += ki_ * ez * dt_s;
+        }
+        gx += kp_ * ex + integral_[0];
+        gy += kp_ * ey + integral_[1];
+        gz += kp_ * ez + integral_[2];
+    }
+    quat_integrate(q_, gx, gy, gz, dt_s);
+    quat_to_output(q_, in, out_);
+    // 输出角速度扣除积分项估计的零偏
+    out_.gyrox += integral_[0] * RadToDeg;
+    out_.gyroy += integral_[1] * RadToDeg;
+}
+
+/********** Madgwick **********/
+MadgwickFilter::MadgwickFilter(float beta) : beta_(beta), q_{1.0f, 0.0f, 0.0f, 0.0f}
+{
+}
+
+void MadgwickFilter::reset(const attitude_input &in)
+{
+    quat_from_acc(in, q_);
+    quat_to_output(q_, in, out_);
+}
+
+void MadgwickFilter::update(const attitude_input &in, float dt_s)
+{
+    const float gx = in.gx * DegToRad;
+    const float gy = in.gy * DegToRad;
+    const float gz = in.gz * DegToRad;
+    const float q0 = q_[0], q1 = q_[1], q2 = q_[2], q3 = q_[3];
+
+    // 陀螺积分的四元数导数
+    float d0 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    float d1 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    float d2 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    float d3 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    float norm_sq;
+    if (acc_usable(in, norm_sq))
+    {
+        const float n = inv_sqrt(norm_sq);
+        const float ax = in.ax * n, ay = in.ay * n, az = in.az * n;
+        // 目标函数梯度（重力方向误差）
+        const float f1 = 2.0f * (q1 * q3 - q0 * q2) - ax;
+        const float f2 = 2.0f * (q0 * q1 + q2 * q3) - ay;
+        const float f3 = 1.0f - 2.0f * (q1 * q1 + q2 * q2) - az;
+        float s0 = -2.0f * q2 * f1 + 2.0f * q1 * f2;
+        float s1 = 2.0f * q3 * f1 + 2.0f * q0 * f2 - 4.0f * q1 * f3;
+        float s2 = -2.0f * q0 * f1 + 2.0f * q3 * f2 - 4.0f * q2 * f3;
+        float s3 = 2.0f * q1 * f1 + 2.0f * q2 * f2;
+        const float s_sq = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        if (s_sq > 0.0f)
+        {
+            const float sn = beta_ * inv_sqrt(s_sq);
+            d0 -= sn * s0;
+            d1 -= sn * s1;
+            d2 -= sn * s2;
+            d3 -= sn * s3;
+        }
+    }
+
+    q_[0] += d0 * dt_s;
+    q_[1] += d1 * dt_s;
+    q_[2] += d2 * dt_s;
+    q_[3] += d3 * dt_s;
+    const float n = inv_sqrt(q_[0] * q_[0] + q_[1] * q_[1] + q_[2] * q_[2] + q_[3] * q_[3]);
+    q_[0] *= n;
+    q_[1] *= n;
+    q_[2] *= n;
+    q_[3] *= n;
+    quat_to_output(q_, in, out_);
+}
+
+/********** 卡尔曼 **********/
+void AngleKalman::reset(float angle0)
+{
+    angle = angle0;
+    bias = 0.0f;
+    p[0][0] = p[0][1] = p[1][0] = p[1][1] = 0.0f;
+}
+
+float AngleKalman::update(float meas_angle, float rate, float dt_s)
+{
+    // 预测
+    angle += dt_s * (rate - bias);
+    p[0][0] += dt_s * (dt_s * p[1][1] - p[0][1] - p[1][0] + q_angle);
+    p[0][1] -= dt_s * p[1][1];
+    p[1][0] -= dt_s * p[1][1];
+    p[1][1] += q_bias * dt_s;
+
+    // 观测修正
+    const float s = p[0][0] + r_measure;
+    const float k0 = p[0][0] / s;
+    const float k1 = p[1][0] / s;
+    const float y = meas_angle - angle;
+    angle += k0 * y;
+    bias += k1 * y;
+
+    const float p00 = p[0][0], p01 = p[0][1];
+    p[0][0] -= k0 * p00;
+    p[0][1] -= k0 * p01;
+    p[1][0] -= k1 * p00;
+    p[1][1] -= k1 * p01;
+    return angle;
+}
+
+void KalmanFilter::reset(const attitude_input &in)
+{
+    roll_.reset(acc_angle_x(in));
+    pitch_.reset(acc_angle_y(in));
+    out_.anglex = roll_.angle;
+    out_.angley = pitch_.angle;
+    out_.anglez = 0.0f;
+}
+
+void KalmanFilter::update(const attitude_input &in, float dt_s)
+{
+    float norm_sq;
+    if (acc_usable(in, norm_sq))
+    {
+        out_.anglex = roll_.update(acc_angle_x(in), in.gx, dt_s);
+        out_.angley = pitch_.update(acc_angle_y(in), in.gy, dt_s);
+    }
+    else
+    {
+        // 冲击期间只做预测
+        roll_.angle += dt_s * (in.gx - roll_.bias);
+        pitch_.angle += dt_s * (in.gy - pitch_.bias);
+        out_.anglex = roll_.angle;
+        out_.angley = pitch_.angle;
+    }
+    out_.anglez += in.gz * dt_s;
+    out_.gyrox = in.gx - roll_.bias;
+    out_.gyroy = in.gy - pitch_.bias;
+    out_.gyroz = in.gz;
+}
+
+AttitudeEstimator &my_attitude_estimator(AttitudeMode mode)
+{
+    static ComplementaryFilter complementary;
+    static MahonyFilter mahony;
+    static MadgwickFilter madgwick;
+    static KalmanFilter kalman;
+    switch (mode)
+    {
+    case AttitudeMode::MAHONY:
+        return mahony;
+    case AttitudeMode::MADGWICK:
+        return madgwick;
+    case AttitudeMode::KALMAN:
+        return kalman;
+    default:
+        return complementary;
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <stdint.h>
+
+// 姿态解算输入：加速度（g）、角速度（deg/s，已扣除静止零偏）
+struct attitude_input
+{
+    float ax, ay, az;
+    float gx, gy, gz;
+};
+
+// 姿态解算输出，坐标约定与 MPU6050_tockn 一致：anglex/angley 分别随 gyrox/gyroy 正向增长
+struct attitude_output
+{
+    float anglex, angley, anglez; // deg
+    float gyrox, gyroy, gyroz;    // deg/s，带零偏估计的算法输出已修正的角速度
+};
+
+enum class AttitudeMode : uint8_t
+{
+    COMPLEMENTARY = 0, // 原 MPU6050_tockn 互补滤波（按 dt 换算系数）
+    MAHONY,            // 四元数 + PI 修正
+    MADGWICK,          // 四元数 + 梯度下降修正
+    KALMAN,            // roll/pitch 各一个 2 状态（角度 + 陀螺零偏）卡尔曼
+    COUNT
+};
+
+// 姿态估计器接口：reset() 用静止时的加速度初始化，update() 每个 IMU 样本调用一次
+// 默认参数来自 native_bench attitude 的合成数据扫参，实车数据可用 --csv 复核
+class AttitudeEstimator
+{
+public:
+    virtual ~AttitudeEstimator() = default;
+    virtual void reset(const attitude_input &in) = 0;
+    virtual void update(const attitude_input &in, float dt_s) = 0;
+    virtual const char *name() const = 0;
+    const attitude_output &output() const { return out_; }
+
+protected:
+    attitude_output out_ = {};
+};
+
+class ComplementaryFilter : public AttitudeEstimator
+{
+public:
+    explicit ComplementaryFilter(float tau_s = 0.098f); // 0.098s 即 2ms 节拍下的 0.98/0.02
+    void reset(const attitude_input &in) override;
+    void update(const attitude_input &in, float dt_s) override;
+    const char *name() const override { return "complementary"; }
+
+private:
+    float tau_;
+};
+
+class MahonyFilter : public AttitudeEstimator
+{
+public:
+    MahonyFilter(float kp = 1.0f, float ki = 0.05f);
+    void reset(const attitude_input &in) override;
+    void update(const attitude_input &in, float dt_s) override;
+    const char *name() const override { return "mahony"; }
+
+private:
+    float kp_, ki_;
+    float q_[4];
+    float integral_[3];
+};
+
+class MadgwickFilter : public AttitudeEstimator
+{
+public:
+    explicit MadgwickFilter(float beta = 0.02f);
+    void reset(const attitude_input &in) override;
+    void update(const attitude_input &in, float dt_s) override;
+    const char *name() const override { return "madgwick"; }
+
+private:
+    float beta_;
+    float q_[4];
+};
+
+// 单轴 2 状态卡尔曼：状态 [角度, 陀螺零偏]，过程输入为陀螺角速度，观测为加速度计角度
+struct AngleKalman
+{
+    float q_angle = 0.001f;  // 角度过程噪声
+    float q_bias = 0.0003f;  // 零偏过程噪声
+    float r_measure = 3.0f;  // 加速度计观测噪声（deg²），平衡时的前后加速度是主要误差来源
+    float angle = 0.0f;
+    float bias = 0.0f;
+    float p[2][2] = {{0.0f, 0.0f}, {0.0f, 0.0f}};
+
+    void reset(float angle0);
+    float update(float meas_angle, float rate, float dt_s); // 返回修正后的角度
+};
+
+class KalmanFilter : public AttitudeEstimator
+{
+public:
+    KalmanFilter() = default;
+    void reset(const attitude_input &in) override;
+    void update(const attitude_input &in, float dt_s) override;
+    const char *name() const override { return "kalman"; }
+
+private:
+    AngleKalman roll_;
+    AngleKalman pitch_;
+};
+
+// 每种模式一个静态实例，供 IMU 驱动与主机基准共用
+AttitudeEstimator &my_attitude_estimator(AttitudeMode mode);
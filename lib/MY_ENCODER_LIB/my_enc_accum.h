@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+
+// 由回绕的硬件计数器得到 64 位累计计数（不清零硬件计数器，增量靠相减得到）
+//   PCNT 计到 ±limit 时自动归零并产生 H_LIM / L_LIM 事件，中断把 ±limit 累加到 overflow，
+//   累计值 = overflow + 当前计数。读数与中断之间只有一种竞争：计数器已归零但中断尚未执行
+//   （读方关中断期间或中断在另一核上排队），此时和值恰好差一个 limit；
+//   两次读数之间的真实增量远小于 limit/2（2ms 内最多几百个计数），据此识别并补偿
+
+struct EncoderAccum
+{
+    int32_t limit = 30000; // 硬件计数上下限（pcnt counter_h_lim / -counter_l_lim）
+    int64_t total = 0;     // 上一次读出的累计计数
+
+    void reset(int64_t overflow, int32_t count)
+    {
+        total = overflow + count;
+    }
+
+    // overflow 与 count 须在同一临界区内读取；返回新的累计计数
+    inline int64_t update(int64_t overflow, int32_t count)
+    {
+        int64_t next = overflow + count;
+        const int64_t d = next - total;
+        if (d > limit / 2)
+            next -= limit; // 反向到 -limit 归零，L_LIM 中断未执行
+        else if (d < -(limit / 2))
+            next += limit; // 正向到 +limit 归零，H_LIM 中断未执行
+        total = next;
+        return next;
+    }
+};
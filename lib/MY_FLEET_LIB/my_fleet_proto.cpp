@@ -0,0 +1,139 @@
+#include "my_fleet_proto.h"
+#include <string.h>
+
+// CRC-16/CCITT-FALSE：多项式 0x1021，初值 0xFFFF；半字节查表，16 项
+uint16_t fleet_crc16(const uint8_t *data, size_t len)
+{
+    static const uint16_t Table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    };
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; ++i)
+    {
+        crc = static_cast<uint16_t>((crc << 4) ^ Table[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = static_cast<uint16_t>((crc << 4) ^ Table[(crc >> 12) ^ (data[i] & 0x0F)]);
+    }
+    return crc;
+}
+
+size_t fleet_encode(const fleet_header &h, const void *payload, size_t n, uint8_t *out)
+{
+    if (n > FLEET_MAX_PAYLOAD)
+        return 0;
+    memcpy(out, &h, sizeof(fleet_header));
+    if (n)
+        memcpy(out + sizeof(fleet_header), payload, n);
+    const size_t body = sizeof(fleet_header) + n;
+    const uint16_t crc = fleet_crc16(out, body);
+    out[body] = static_cast<uint8_t>(crc & 0xFF);
+    out[body + 1] = static_cast<uint8_t>(crc >> 8);
+    return body + 2;
+}
+
+fleet_decode_result fleet_decode(const uint8_t *frame, size_t len, fleet_header &h, const uint8_t *&payload, size_t &n)
+{
+    if (len < FLEET_FRAME_OVERHEAD)
+        return FLEET_ERR_SHORT;
+    memcpy(&h, frame, sizeof(fleet_header));
+    if (h.magic != FLEET_MAGIC)
+        return FLEET_ERR_MAGIC;
+    if (h.version != FLEET_VERSION)
+        return FLEET_ERR_VERSION;
+    const size_t body = len - 2;
+    const uint16_t crc = static_cast<uint16_t>(frame[body] | (frame[body + 1] << 8));
+    if (fleet_crc16(frame, body) != crc)
+        return FLEET_ERR_CRC;
+    payload = frame + sizeof(fleet_header);
+    n = body - sizeof(fleet_header);
+    return FLEET_OK;
+}
+
+const char *fleet_decode_result_name(fleet_decode_result r)
+{
+    switch (r)
+    {
+    case FLEET_OK:
+        return "ok";
+    case FLEET_ERR_SHORT:
+        return "short";
+    case FLEET_ERR_MAGIC:
+        return "magic";
+    case FLEET_ERR_VERSION:
+        return "version";
+    case FLEET_ERR_CRC:
+        return "crc";
+    case FLEET_ERR_LENGTH:
+        return "length";
+    default:
+        return "?";
+    }
+}
+
+void FleetLink::on_frame(uint16_t seq, uint32_t tx_us, uint32_t rx_us)
+{
+    const int32_t transit = static_cast<int32_t>(rx_us - tx_us);
+    st_.last_rx_us = rx_us;
+    const uint16_t ahead = static_cast<uint16_t>(seq - max_seq_);
+    if (started_ && ahead == 0)
+    {
+        ++st_.dup;
+        return;
+    }
+    ++st_.received;
+    if (!started_ || ahead >= MaxDropout)
+    {
+        const uint16_t behind = static_cast<uint16_t>(max_seq_ - seq);
+        if (started_ && behind <= MaxMisorder)
+        {
+            // 晚到：期望数在丢失时已计入，收到数 +1 即补回
+            ++st_.late;
+            st_.lost = expected_ > st_.received ? expected_ - st_.received : 0;
+            return;
+        }
+        if (started_)
+            ++st_.restarts;
+        // 首帧或对端重启：以本帧为新起点，之前的缺口不计
+        started_ = true;
+        max_seq_ = seq;
+        expected_ += 1;
+        last_transit_ = transit;
+    }
+    else
+    {
+        max_seq_ = seq;
+        expected_ += ahead;
+        // RFC 3550 6.4.1：J += (|D| - J) / 16，以 ×16 的整数形式累加
+        int32_t d = transit - last_transit_;
+        last_transit_ = transit;
+        if (d < 0)
+            d = -d;
+        jitter_q4_ += static_cast<uint32_t>(d) - ((jitter_q4_ + 8) >> 4);
+        st_.jitter_us = jitter_q4_ >> 4;
+    }
+    st_.lost = expected_ > st_.received ? expected_ - st_.received : 0;
+}
+
+void FleetLink::on_rssi(int8_t rssi)
+{
+    st_.rssi = rssi;
+    if (st_.rssi_min == 0 || rssi < st_.rssi_min)
+        st_.rssi_min = rssi;
+}
+
+void FleetLink::reset()
+{
+    *this = FleetLink();
+}
+
+float FleetLossWindow::update(const fleet_link_stats &s)
+{
+    const uint32_t dr = s.received - received_;
+    const int32_t dl = static_cast<int32_t>(s.lost - lost_);
+    received_ = s.received;
+    lost_ = s.lost;
+    if (dr == 0)
+        return loss_;
+    loss_ = dl > 0 ? static_cast<float>(dl) / static_cast<float>(dr + dl) : 0.0f;
+    return loss_;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// 车队 ESP-NOW 帧格式与链路统计
+//   帧 = fleet_header + 负载 + CRC16（CCITT-FALSE，覆盖帧头与负载，小端）
+//   接收端先校验 magic/version/CRC，再按 type 分发，负载长度必须与该类型的结构一致；
+//   不再按帧长猜类型，同长度的错类型帧或损坏帧都会被丢弃
+//   FleetLink 对一个发送方的帧做统计：丢包（期望 - 收到，乱序晚到的会补回）、
+//   RFC 3550 到达抖动、RSSI；只在接收回调中更新
+
+#define FLEET_MAGIC 0xB7
+#define FLEET_VERSION 1
+#define FLEET_MAX_PAYLOAD 64
+
+enum fleet_msg_type : uint8_t
+{
+    FLEET_MSG_MOTION = 1,    // 头车 -> 从车：运动指令
+    FLEET_MSG_HEARTBEAT = 2, // 从车 -> 头车：心跳 + 下行链路报告
+    FLEET_MSG_SETPOINT = 3,  // 头车 -> 从车：高层设定值（从车自平衡）
+};
+
+struct fleet_header
+{
+    uint8_t magic;    // FLEET_MAGIC
+    uint8_t version;  // FLEET_VERSION
+    uint8_t type;     // fleet_msg_type
+    uint8_t group_id; // 车队ID
+    uint16_t seq;     // 发送方序号，所有类型共用一个计数
+    uint32_t tx_us;   // 发送方时间戳（micros），用于到达抖动
+} __attribute__((packed));
+
+#define FLEET_FRAME_OVERHEAD (sizeof(fleet_header) + 2)
+#define FLEET_MAX_FRAME (FLEET_FRAME_OVERHEAD + FLEET_MAX_PAYLOAD)
+
+enum fleet_decode_result : uint8_t
+{
+    FLEET_OK = 0,
+    FLEET_ERR_SHORT,   // 短于帧头 + CRC
+    FLEET_ERR_MAGIC,   // 不是本协议的帧
+    FLEET_ERR_VERSION, // 协议版本不符
+    FLEET_ERR_CRC,     // 校验失败
+    FLEET_ERR_LENGTH,  // 负载长度与类型不符（由调用方判定）
+    FLEET_ERR_COUNT
+};
+
+uint16_t fleet_crc16(const uint8_t *data, size_t len);
+// 组帧到 out（至少 n + FLEET_FRAME_OVERHEAD 字节），返回帧长；n 超过 FLEET_MAX_PAYLOAD 返回 0
+size_t fleet_encode(const fleet_header &h, const void *payload, size_t n, uint8_t *out);
+// 校验并拆帧：成功时 h 为帧头，payload/n 指向负载
+fleet_decode_result fleet_decode(const uint8_t *frame, size_t len, fleet_header &h, const uint8_t *&payload, size_t &n);
+const char *fleet_decode_result_name(fleet_decode_result r);
+
+// 一个发送方的链路统计（累计值）
+struct fleet_link_stats
+{
+    uint32_t received;  // 收到的有效帧（含晚到）
+    uint32_t lost;      // 期望 - 收到
+    uint32_t late;      // 乱序晚到
+    uint32_t dup;       // 重复
+    uint32_t rejected;  // 帧格式/CRC/长度错误
+    uint32_t restarts;  // 序号跳变（对端重启）后重新计数
+    uint32_t jitter_us; // RFC 3550 到达抖动
+    uint32_t last_rx_us;
+    int8_t rssi;        // 最近一帧 RSSI (dBm)，0 为未知
+    int8_t rssi_min;    // 最差 RSSI
+};
+
+class FleetLink
+{
+public:
+    // 收到一帧有效帧：seq/tx_us 取自帧头，rx_us 为本地到达时刻
+    void on_frame(uint16_t seq, uint32_t tx_us, uint32_t rx_us);
+    void on_reject() { ++st_.rejected; }
+    void on_rssi(int8_t rssi);
+    void reset();
+    const fleet_link_stats &stats() const { return st_; }
+
+private:
+    static constexpr uint16_t MaxDropout = 3000; // 向前跳超过该值视为对端重启
+    static constexpr uint16_t MaxMisorder = 100; // 向后超过该值同样视为重启
+
+    fleet_link_stats st_ = {};
+    uint32_t expected_ = 0;
+    uint32_t jitter_q4_ = 0; // 抖动 ×16，按 RFC 3550 的整数形式累加
+    int32_t last_transit_ = 0;
+    uint16_t max_seq_ = 0;
+    bool started_ = false;
+};
+
+// 读方按固定间隔取样，求本区间的丢包率；区间内没有新帧时保持上一次的值
+class FleetLossWindow
+{
+public:
+    float update(const fleet_link_stats &s);
+
+private:
+    uint32_t received_ = 0;
+    uint32_t lost_ = 0;
+    float loss_ = 0.0f;
+};
@@ -0,0 +1,46 @@
+#include "my_fleet_tx.h"
+
+void FleetTxSchedule::offer(bool changed)
+{
+    ++counts_.offered;
+    has_value_ = true;
+    if (!changed)
+    {
+        ++counts_.skipped;
+        return;
+    }
+    if (dirty_)
+        ++counts_.coalesced;
+    dirty_ = true;
+}
+
+bool FleetTxSchedule::due(uint32_t now_us) const
+{
+    if (!has_value_)
+        return false;
+    if (!started_)
+        return dirty_;
+    const uint32_t elapsed = now_us - last_us_;
+    return (dirty_ && elapsed >= min_us_) || elapsed >= keepalive_us_;
+}
+
+uint32_t FleetTxSchedule::wait_us(uint32_t now_us) const
+{
+    if (!has_value_)
+        return keepalive_us_;
+    if (!started_)
+        return dirty_ ? 0 : keepalive_us_;
+    const uint32_t elapsed = now_us - last_us_;
+    const uint32_t deadline = dirty_ && min_us_ < keepalive_us_ ? min_us_ : keepalive_us_;
+    return elapsed >= deadline ? 0 : deadline - elapsed;
+}
+
+void FleetTxSchedule::sent(uint32_t now_us)
+{
+    ++counts_.sent;
+    if (!dirty_)
+        ++counts_.keepalive;
+    dirty_ = false;
+    started_ = true;
+    last_us_ = now_us;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+
+// 车队 ESP-NOW 发送调度（一个发送方、一路指令流）
+//   有变化的指令：距上次发送已过最小间隔立即发出，否则暂存，到点发出期间最新的一帧（中间的合并掉）
+//   没有变化：不发；距上次发送超过保活间隔时重发最近一帧，接收端据此判断链路仍在
+// 是否"有变化"由调用方按指令类型比较（与上次发出的内容比，缓慢漂移累积超过容差同样会发出）
+// 时间均为 micros()，按无符号差值计算，允许回绕
+
+struct fleet_tx_counts
+{
+    uint32_t offered;   // 交给调度的指令
+    uint32_t skipped;   // 与上次发出的相同，未发
+    uint32_t coalesced; // 限速期间被后来的指令覆盖
+    uint32_t sent;      // 发出的帧（含保活）
+    uint32_t keepalive; // 其中的保活重发
+};
+
+class FleetTxSchedule
+{
+public:
+    FleetTxSchedule(uint32_t min_interval_us, uint32_t keepalive_us)
+        : min_us_(min_interval_us), keepalive_us_(keepalive_us) {}
+
+    void set_min_interval(uint32_t us) { min_us_ = us; }
+    uint32_t min_interval() const { return min_us_; }
+
+    // 新的指令；changed 为与上次发出的内容相比有变化（首帧由调用方按有变化处理）
+    void offer(bool changed);
+    // now 时刻是否应发送
+    bool due(uint32_t now_us) const;
+    // 距下一次到点还有多久 (us)，0 表示现在就该发；尚无指令时返回保活间隔
+    uint32_t wait_us(uint32_t now_us) const;
+    // 已发出（发送失败也调用，失败的帧同样占用了一个发送时隙，保活从此刻重新计时）
+    void sent(uint32_t now_us);
+
+    const fleet_tx_counts &counts() const { return counts_; }
+
+private:
+    uint32_t min_us_;
+    uint32_t keepalive_us_;
+    uint32_t last_us_ = 0;
+    bool has_value_ = false; // 至少收到过一条指令，此后才保活
+    bool started_ = false;   // 至少发出过一帧
+    bool dirty_ = false;     // 有尚未发出的变化
+    fleet_tx_counts counts_ = {};
+};
@@ -0,0 +1,265 @@
+#include "my_lqr.h"
+#include <math.h>
+#include <string.h>
+
+namespace
+{
+    constexpr int N = 4; // 平衡子系统状态数：theta, theta_dot, phi, phi_dot
+    constexpr double G = 9.81;
+    constexpr double DegToRad = 0.017453292519943295;
+    constexpr int MaxIterations = 200000;
+
+    typedef double mat[N][N];
+    typedef double vec[N];
+
+    void mat_mul(const mat a, const mat b, mat out)
+    {
+        mat t;
+        for (int i = 0; i < N; ++i)
+            for (int j = 0; j < N; ++j)
+            {
+                double s = 0.0;
+                for (int k = 0; k < N; ++k)
+                    s += a[i][k] * b[k][j];
+                t[i][j] = s;
+            }
+        memcpy(out, t, sizeof(t));
+    }
+
+    double mat_max_abs(const mat a)
+    {
+        double m = 0.0;
+        for (int i = 0; i < N; ++i)
+            for (int j = 0; j < N; ++j)
+                m = fmax(m, fabs(a[i][j]));
+        return m;
+    }
+
+    // 连续模型 x' = A x + B u（u 为两轮共模占空比）
+    void balance_model(const lqr_plant &p, mat a, vec b)
+    {
+        const double M = p.body_mass;
+        const double L = p.body_com;
+        const double r = p.wheel_radius;
+        const double mw = 2.0 * p.wheel_mass;
+        const double Iw = 2.0 * 0.5 * p.wheel_mass * r * r;
+        const double a11 = (mw + M) * r * r + Iw;
+        const double a12 = M * r * L;
+        const double a22 = M * L * L + p.body_inertia;
+        const double det = a11 * a22 - a12 * a12;
+        const double cu = 2.0 * p.stall_torque * p.voltage_ratio; // 占空比 -> 轮端力矩
+        const double cb = 2.0 * p.stall_torque / p.no_load_speed;  // 反电动势阻尼
+
+        // 广义力对 [theta, theta_dot, phi, phi_dot, u] 的系数
+        const double f1[N + 1] = {0.0, cb, 0.0, -cb, cu};         // 轮方程
+        const double f2[N + 1] = {M * G * L, -cb, 0.0, cb, -cu};  // 车身方程
+        memset(a, 0, sizeof(mat));
+        a[0][1] = 1.0;
+        a[2][3] = 1.0;
+        for (int j = 0; j <= N; ++j)
+        {
+            const double theta_dd = (a11 * f2[j] - a12 * f1[j]) / det;
+            const double phi_dd = (a22 * f1[j] - a12 * f2[j]) / det;
+            if (j < N)
+            {
+                a[1][j] = theta_dd;
+                a[3][j] = phi_dd;
+            }
+            else
+            {
+                b[0] = 0.0;
+                b[1] = theta_dd;
+                b[2] = 0.0;
+                b[3] = phi_dd;
+            }
+        }
+    }
+
+    // 零阶保持离散化：Ad = e^{A dt}，Bd = ∫e^{A t}dt B，泰勒级数（|A dt| 远小于 1）
+    void discretize(const mat a, const vec b, double dt, mat ad, vec bd)
+    {
+        mat term, sum_a, sum_b;
+        memset(term, 0, sizeof(term));
+        memset(sum_a, 0, sizeof(sum_a));
+        for (int i = 0; i < N; ++i)
+        {
+            term[i][i] = 1.0;
+            sum_a[i][i] = 1.0;
+        }
+        for (int i = 0; i < N; ++i)
+            for (int j = 0; j < N; ++j)
+                sum_b[i][j] = (i == j) ? dt : 0.0;
+
+        for (int n = 1; n < 20; ++n)
+        {
+            // term = A^n dt^n / n!
+            mat ta;
+            mat_mul(term, a, ta);
+            for (int i = 0; i < N; ++i)
+                for (int j = 0; j < N; ++j)
+                {
+                    term[i][j] = ta[i][j] * dt / n;
+                    sum_a[i][j] += term[i][j];
+                    sum_b[i][j] += term[i][j] * dt / (n + 1);
+                }
+        }
+        memcpy(ad, sum_a, sizeof(mat));
+        for (int i = 0; i < N; ++i)
+        {
+            bd[i] = 0.0;
+            for (int j = 0; j < N; ++j)
+                bd[i] += sum_b[i][j] * b[j];
+        }
+    }
+
+    // 单输入离散 Riccati 迭代，返回增益 k（u = -k x）
+    bool dare(const mat ad, const vec bd, const double q[N], double r, vec k, int &iterations)
+    {
+        mat p;
+        memset(p, 0, sizeof(p));
+        for (int i = 0; i < N; ++i)
+            p[i][i] = q[i];
+
+        for (iterations = 1; iterations <= MaxIterations; ++iterations)
+        {
+            // pb = P B, pa = P A
+            vec pb;
+            mat pa;
+            for (int i = 0; i < N; ++i)
+            {
+                pb[i] = 0.0;
+                for (int j = 0; j < N; ++j)
+                    pb[i] += p[i][j] * bd[j];
+            }
+            mat_mul(p, ad, pa);
+            double s = r;
+            for (int i = 0; i < N; ++i)
+                s += bd[i] * pb[i];
+            // k = (B'PA) / (R + B'PB)
+            for (int j = 0; j < N; ++j)
+            {
+                double v = 0.0;
+                for (int i = 0; i < N; ++i)
+                    v += bd[i] * pa[i][j];
+                k[j] = v / s;
+            }
+            // P' = Q + A'PA - A'PB k
+            mat next;
+            double diff = 0.0;
+            for (int i = 0; i < N; ++i)
+                for (int j = 0; j < N; ++j)
+                {
+                    double apa = 0.0, apb = 0.0;
+                    for (int m = 0; m < N; ++m)
+                    {
+                        apa += ad[m][i] * pa[m][j];
+                        apb += ad[m][i] * pb[m];
+                    }
+                    next[i][j] = (i == j ? q[i] : 0.0) + apa - apb * k[j];
+                    diff = fmax(diff, fabs(next[i][j] - p[i][j]));
+                }
+            memcpy(p, next, sizeof(p));
+            if (diff <= 1e-10 * fmax(1.0, mat_max_abs(p)))
+                return true;
+        }
+        return false;
+    }
+
+    // 谱半径：rho ≈ |M^(2^s)|^(1/2^s)，逐次平方并归一化防溢出
+    double spectral_radius(const mat m)
+    {
+        mat t;
+        memcpy(t, m, sizeof(t));
+        double log_scale = 0.0;
+        const int squarings = 14;
+        for (int s = 0; s < squarings; ++s)
+        {
+            mat_mul(t, t, t);
+            log_scale *= 2.0;
+            const double n = mat_max_abs(t);
+            if (n == 0.0)
+                return 0.0;
+            for (int i = 0; i < N; ++i)
+                for (int j = 0; j < N; ++j)
+                    t[i][j] /= n;
+            log_scale += log(n);
+        }
+        return exp(log_scale / static_cast<double>(1 << squarings));
+    }
+}
+
+lqr_plant lqr_default_plant()
+{
+    lqr_plant p{};
+    p.body_mass = 0.50f;
+    p.body_com = 0.040f;
+    p.body_inertia = 4.2e-4f;
+    p.wheel_mass = 0.030f;
+    p.wheel_radius = 0.0325f;
+    p.track_width = 0.150f;
+    p.yaw_inertia = 1.3e-3f;
+    p.stall_torque = 0.50f;
+    p.no_load_speed = 30.0f;
+    p.voltage_ratio = 1.0f;
+    return p;
+}
+
+lqr_weights lqr_default_weights()
+{
+    // Bryson 法则：1 / 允许偏差²
+    lqr_weights w{};
+    w.q[0] = 1.0f / (0.05f * 0.05f); // 车身倾角 ~3°
+    w.q[1] = 1.0f / (1.0f * 1.0f);   // 车身角速度
+    w.q[2] = 1.0f / (2.0f * 2.0f);   // 轮转角（约 6cm）
+    w.q[3] = 1.0f / (4.0f * 4.0f);   // 轮速
+    w.q[4] = 1.0f / (1.0f * 1.0f);   // 偏航角速度
+    w.r[0] = 1.0f / (0.5f * 0.5f);
+    w.r[1] = 1.0f / (0.3f * 0.3f);
+    return w;
+}
+
+bool lqr_design(const lqr_plant &plant, const lqr_weights &w, float dt_s, float duty_sum_lim, lqr_result &out)
+{
+    memset(&out, 0, sizeof(out));
+    if (dt_s <= 0.0f || duty_sum_lim <= 0.0f || plant.no_load_speed <= 0.0f || plant.yaw_inertia <= 0.0f)
+        return false;
+
+    mat a, ad;
+    vec b, bd, k;
+    balance_model(plant, a, b);
+    discretize(a, b, dt_s, ad, bd);
+    const double q[N] = {w.q[0], w.q[1], w.q[2], w.q[3]};
+    out.converged = dare(ad, bd, q, w.r[0], k, out.iterations);
+
+    mat cl;
+    for (int i = 0; i < N; ++i)
+        for (int j = 0; j < N; ++j)
+            cl[i][j] = ad[i][j] - bd[i] * k[j];
+    out.rho_balance = static_cast<float>(spectral_radius(cl));
+
+    // 偏航：r' = ay r + by ud，标量 Riccati 有闭式解
+    const double kr_yaw = plant.track_width / (2.0 * plant.wheel_radius);
+    const double rr = plant.wheel_radius;
+    const double jy = plant.yaw_inertia + 2.0 * 1.5 * plant.wheel_mass * kr_yaw * kr_yaw * rr * rr;
+    const double ay = -2.0 * plant.stall_torque * kr_yaw * kr_yaw / (plant.no_load_speed * jy);
+    const double by = 2.0 * plant.stall_torque * plant.voltage_ratio * kr_yaw / jy;
+    const double ed = exp(ay * dt_s);
+    const double bdy = by * (ed - 1.0) / ay;
+    // P = q + e²P - e²b²P²/(r + b²P)  =>  b²P² + (r - e²r - q b²)P - q r = 0
+    const double qa = bdy * bdy;
+    const double qb = w.r[1] * (1.0 - ed * ed) - w.q[4] * bdy * bdy;
+    const double qc = -static_cast<double>(w.q[4]) * w.r[1];
+    const double py = (-qb + sqrt(qb * qb - 4.0 * qa * qc)) / (2.0 * qa);
+    const double ky = bdy * py * ed / (w.r[1] + bdy * bdy * py);
+    out.rho_yaw = static_cast<float>(fabs(ed - bdy * ky));
+
+    // 换算到固件单位：固件状态与物理状态方向相反（前倾 pitch 读数减小、电机正转对应 pos/spd 减小），
+    // base_duty = -duty_sum_lim * u，yaw_duty = duty_sum_lim * ud
+    const double d = duty_sum_lim;
+    out.k[0][0] = static_cast<float>(d * k[0] * -DegToRad);
+    out.k[0][1] = static_cast<float>(d * k[1] * -DegToRad);
+    out.k[0][2] = static_cast<float>(d * k[2] * -1.0);
+    out.k[0][3] = static_cast<float>(d * k[3] * -1.0);
+    out.k[1][4] = static_cast<float>(-d * ky * DegToRad);
+    return out.converged && out.rho_balance < 1.0f && out.rho_yaw < 1.0f;
+}
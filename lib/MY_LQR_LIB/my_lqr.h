@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+
+// 全状态 LQR 增益离线设计（主机工具与仿真共用，固件只加载结果）
+// 模型与 my_sim_plant 相同：平面两轮倒立摆（theta, theta_dot, phi, phi_dot）+ 偏航角速度一阶模型，
+// 电机为电压源 + 反电动势，在直立点线性化，按控制周期零阶保持离散化后迭代求解离散 Riccati 方程
+// 输出增益直接换算到固件状态与输出单位（见 LQR_STATES 注释），控制律 u = K * x
+
+// 状态/输出顺序与 my_config.h 中 LQR_STATES / LQR_INPUTS 的说明一致
+#ifndef LQR_STATES
+#define LQR_STATES 5 // 0 pitch 误差 (deg)  1 pitch 角速度 (deg/s)  2 位置误差 (rad)  3 速度误差 (rad/s)  4 偏航角速度误差 (deg/s)
+#endif
+#ifndef LQR_INPUTS
+#define LQR_INPUTS 2 // 0 base_duty  1 yaw_duty（与 PID 串级输出同单位，经 duty_add 混合）
+#endif
+
+struct lqr_plant
+{
+    float body_mass;     // 车身质量 (kg)
+    float body_com;      // 质心到轮轴距离 (m)
+    float body_inertia;  // 车身绕质心转动惯量 (kg*m^2)
+    float wheel_mass;    // 单轮质量 (kg)
+    float wheel_radius;  // 轮半径 (m)
+    float track_width;   // 轮距 (m)
+    float yaw_inertia;   // 整车绕竖轴转动惯量 (kg*m^2)
+    float stall_torque;  // 单轮堵转力矩（轮端，额定电压，N*m）
+    float no_load_speed; // 单轮空载转速（轮端，额定电压，rad/s）
+    float voltage_ratio; // 电池电压 / 额定电压
+};
+
+// 代价权重，按物理单位（rad, rad/s, 归一化占空比）
+struct lqr_weights
+{
+    float q[LQR_STATES]; // theta, theta_dot, phi, phi_dot, yaw_rate
+    float r[LQR_INPUTS]; // 共模占空比, 差模占空比
+};
+
+struct lqr_result
+{
+    float k[LQR_INPUTS][LQR_STATES]; // 固件单位的增益矩阵
+    float rho_balance;               // 闭环离散系统谱半径（<1 稳定）
+    float rho_yaw;
+    int iterations;                  // Riccati 迭代次数
+    bool converged;
+};
+
+lqr_plant lqr_default_plant();    // 与 sim_plant_default_params() 一致的实车参数
+lqr_weights lqr_default_weights();
+
+// duty_sum_lim 为 duty_add() 中 base/yaw 到归一化指令的换算（DUTY_SUM_LIM）
+bool lqr_design(const lqr_plant &plant, const lqr_weights &w, float dt_s, float duty_sum_lim, lqr_result &out);
@@ -0,0 +1,116 @@
+#include "my_deadzone_cal.h"
+#include <math.h>
+
+void DeadzoneCal::begin(DzPhase phase, uint32_t now_ms)
+{
+    phase_ = phase;
+    dir_ = 0;
+    iter_ = 0;
+    resting_ = true;
+    since_ms_ = now_ms;
+    lo_[0] = lo_[1] = 0.0f;
+    hi_[0] = hi_[1] = cfg_.max;
+}
+
+void DeadzoneCal::finish()
+{
+    bool ok = true;
+    for (uint8_t c = 0; c < Curves; ++c)
+    {
+        // 上界从未下降说明整个区间都没有转动：按旧约定记为 1.0
+        if (result_[c] >= cfg_.max - 1e-4f)
+        {
+            result_[c] = 1.0f;
+            ok = false;
+        }
+    }
+    phase_ = ok ? DzPhase::Done : DzPhase::Failed;
+    event_ = ok ? DzEvent::Done : DzEvent::Failed;
+}
+
+// 一轮试探结束：moved 为两侧是否起转
+void DeadzoneCal::step(const bool (&moved)[2], const float (&start)[Curves], uint32_t now_ms)
+{
+    if (phase_ == DzPhase::Verify)
+    {
+        const bool expect = iter_ == 0;
+        if (moved[0] != expect || moved[1] != expect)
+        {
+            begin(DzPhase::Search, now_ms);
+            event_ = DzEvent::VerifyMismatch;
+            return;
+        }
+        if (++iter_ < 2)
+            return;
+        iter_ = 0;
+        if (++dir_ < 2)
+            return;
+        for (uint8_t c = 0; c < Curves; ++c)
+            result_[c] = start[c];
+        phase_ = DzPhase::Done;
+        event_ = DzEvent::VerifyPassed;
+        return;
+    }
+
+    for (uint8_t i = 0; i < 2; ++i)
+        (moved[i] ? hi_[i] : lo_[i]) = probe_[i];
+    if (++iter_ < cfg_.iters)
+        return;
+    for (uint8_t i = 0; i < 2; ++i)
+        result_[curve(i, forward())] = hi_[i];
+    iter_ = 0;
+    lo_[0] = lo_[1] = 0.0f;
+    hi_[0] = hi_[1] = cfg_.max;
+    if (++dir_ >= 2)
+        finish();
+}
+
+bool DeadzoneCal::update(uint32_t now_ms, bool run, const uint32_t (&delta)[2], const float (&start)[Curves], float (&duty)[2])
+{
+    event_ = DzEvent::None;
+    if (!active())
+        return false;
+    if (run)
+    {
+        resting_ = true;
+        since_ms_ = now_ms;
+        return false;
+    }
+
+    duty[0] = duty[1] = 0.0f;
+    const uint32_t elapsed_ms = now_ms - since_ms_;
+    if (resting_)
+    {
+        if (delta[0] || delta[1])
+            since_ms_ = now_ms;
+        else if (elapsed_ms >= cfg_.rest_ms)
+        {
+            for (uint8_t i = 0; i < 2; ++i)
+            {
+                const float s = start[curve(i, forward())];
+                if (phase_ == DzPhase::Verify)
+                    probe_[i] = iter_ == 0 ? fminf(s + cfg_.verify_margin, 1.0f) : fmaxf(s - cfg_.verify_margin, 0.0f);
+                else
+                    probe_[i] = 0.5f * (lo_[i] + hi_[i]);
+                moved_[i] = 0;
+            }
+            resting_ = false;
+            since_ms_ = now_ms;
+        }
+        return true;
+    }
+
+    moved_[0] += delta[0];
+    moved_[1] += delta[1];
+    if (elapsed_ms >= cfg_.probe_ms)
+    {
+        const bool moved[2] = {moved_[0] >= cfg_.move_counts, moved_[1] >= cfg_.move_counts};
+        resting_ = true;
+        since_ms_ = now_ms;
+        step(moved, start, now_ms);
+        return true;
+    }
+    duty[0] = probe_[0];
+    duty[1] = probe_[1];
+    return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <stdint.h>
+
+// 电机起转死区后台标定（控制任务逐拍推进）
+//   每轮先滑行到两轮连续 rest_ms 无编码器计数（上一轮的惯性不计入下一轮），再给两轮同向同时施加
+//   试探占空比 probe_ms，期间累计计数达到 move_counts 视为起转：
+//   Search：每个方向二分 iters 轮，区间 0 ~ max，取起转区间上界
+//   Verify：已有标定值时，只在 start ± verify_margin 各试一次（上界应转、下界应不转），不符则转 Search
+//   运行平衡时暂停并交还输出，停下后从当前轮重新滑行、试探
+// 曲线顺序为左正、左反、右正、右反（与 MOTOR_CURVE_* 一致）；时间为毫秒，按无符号差值计算
+
+struct deadzone_cal_config
+{
+    float max;            // 二分区间上界（占空比），整个区间不转视为电机/编码器未接
+    uint8_t iters;        // 每个方向二分轮数
+    uint32_t probe_ms;    // 每轮施加试探占空比的时间
+    uint32_t rest_ms;     // 试探前车轮需静止的时间
+    uint32_t move_counts; // 试探期间累计计数达到此值视为起转
+    float verify_margin;  // 快速校验的占空比余量
+};
+
+enum class DzPhase : uint8_t
+{
+    Pending, // 尚未开始（等调用方按是否有 NVS 值选择 Verify/Search/Done）
+    Verify,
+    Search,
+    Done,
+    Failed,
+};
+
+// 本拍 update() 产生的事件，调用方据此打印、发布结果并安排写 NVS
+enum class DzEvent : uint8_t
+{
+    None,
+    VerifyMismatch, // 校验不符，已转入 Search
+    VerifyPassed,   // 校验通过，沿用原值，无需保存
+    Done,           // 标定完成，result() 为新值，待保存
+    Failed,         // 有曲线整个区间都不转，result() 中记为 1.0，不保存
+};
+
+class DeadzoneCal
+{
+public:
+    static const uint8_t Curves = 4;
+
+    explicit DeadzoneCal(const deadzone_cal_config &cfg) : cfg_(cfg) {}
+
+    // 进入 phase，从正向第一轮开始
+    void begin(DzPhase phase, uint32_t now_ms);
+    DzPhase phase() const { return phase_; }
+    bool active() const { return phase_ == DzPhase::Verify || phase_ == DzPhase::Search; }
+
+    // 每拍调用。run：正在平衡；delta：本拍两侧编码器计数（绝对值）；start：当前起转占空比（Verify 按此试探）
+    // 返回 true 表示接管输出：probing() 时两侧按 forward() 方向输出 duty，否则制动滑行
+    bool update(uint32_t now_ms, bool run, const uint32_t (&delta)[2], const float (&start)[Curves], float (&duty)[2]);
+    bool probing() const { return !resting_; }
+    bool forward() const { return dir_ == 0; }
+    DzEvent event() const { return event_; }
+    const float (&result() const)[Curves] { return result_; }
+
+private:
+    static uint8_t curve(uint8_t side, bool forward) { return static_cast<uint8_t>(side * 2 + (forward ? 0 : 1)); }
+    void step(const bool (&moved)[2], const float (&start)[Curves], uint32_t now_ms);
+    void finish();
+
+    deadzone_cal_config cfg_;
+    DzPhase phase_ = DzPhase::Pending;
+    DzEvent event_ = DzEvent::None;
+    uint8_t dir_ = 0;  // 0 正向，1 反向
+    uint8_t iter_ = 0; // Search：已完成轮数；Verify：0 上界试探，1 下界试探
+    bool resting_ = true;
+    uint32_t since_ms_ = 0; // 进入当前阶段（滑行静止/试探）的时刻
+    uint32_t moved_[2] = {};
+    float lo_[2] = {}, hi_[2] = {};
+    float probe_[2] = {};
+    float result_[Curves] = {};
+};
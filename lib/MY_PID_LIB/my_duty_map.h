@@ -0,0 +1,36 @@
+#pragma once
+#include <math.h>
+
+// 电机占空比映射：由实测“占空比 - 空载稳态轮速”曲线反查占空比，使归一化指令与轮速近似成正比
+//   曲线首点为起转占空比（速度约 0），末点为满占空比；duty 递增，speed 单调不减（测量时已保证）
+//   低占空比段驱动芯片死区与摩擦使轮速增长偏慢，直线补偿在平衡点附近力矩台阶大，映射后更细
+// 点数少（< 16），顺序查找即可
+
+namespace ctl
+{
+    // mag：0 ~ 1，期望轮速占满占空比轮速的比例；返回占空比（不含电压补偿）
+    template <int N>
+    inline float duty_map(const float (&duty)[N], const float (&speed)[N], float mag)
+    {
+        static_assert(N >= 2, "duty map needs at least 2 points");
+        const float target = fminf(fmaxf(mag, 0.0f), 1.0f) * speed[N - 1];
+        int i = 1;
+        while (i < N - 1 && speed[i] < target)
+            ++i;
+        const float span = speed[i] - speed[i - 1];
+        const float frac = span > 1e-6f ? fminf(fmaxf((target - speed[i - 1]) / span, 0.0f), 1.0f) : 0.0f;
+        return duty[i - 1] + (duty[i] - duty[i - 1]) * frac;
+    }
+
+    // 曲线可用：末点有转速且占空比递增
+    template <int N>
+    inline bool duty_map_valid(const float (&duty)[N], const float (&speed)[N])
+    {
+        if (!(speed[N - 1] > 0.0f))
+            return false;
+        for (int i = 1; i < N; ++i)
+            if (!(duty[i] > duty[i - 1]) || speed[i] < speed[i - 1])
+                return false;
+        return true;
+    }
+}
@@ -28,8 +28,13 @@ float LowPassFilter::apply(float input, float dt_s)
         return input;
     }
 
-    const float alpha = dt_s / (tau + dt_s); // 一阶低通滤波器系数
-    state += alpha * (input - state);
+    if (dt_s != alpha_dt_ || tau != alpha_tau_)
+    {
+        alpha_ = dt_s / (tau + dt_s); // 一阶低通滤波器系数
+        alpha_dt_ = dt_s;
+        alpha_tau_ = tau;
+    }
+    state += alpha_ * (input - state);
     return state;
 }
 
@@ -50,6 +55,11 @@ float LowPassFilter::operator()(float input)
     return apply_auto(input);
 }
 
+float LowPassFilter::operator()(float input, float dt_s)
+{
+    return apply(input, dt_s);
+}
+
 PIDParams::PIDParams(float p, float i, float d, float out_lim, float int_lim, float ramp, float d_tau)
     : kp(p),
       ki(i),
@@ -63,6 +73,7 @@ PIDParams::PIDParams(float p, float i, float d, float out_lim, float int_lim, fl
 
 MyPID::MyPID(const PIDParams &params)
     : cfg_(params),
+      k_{-1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f},
       d_filter_(params.derivative_lpf_tau),
       integral_(0.0f),
       prev_error_(0.0f),
@@ -86,24 +97,26 @@ MyPID::MyPID(float kp, float ki, float kd, float limit, float integral_limit, fl
 {
 }
 
-float MyPID::clamp(float v, float lo, float hi)
-{
-    if (v < lo) return lo;
-    if (v > hi) return hi;
-    return v;
-}
-
 void MyPID::reset(float output, float error)
 {
+    // 不读时钟：reset 可能每拍都被调用（如无转向指令时的 PID_YAW）
     const float out_lim = fabsf(cfg_.limit);
-    const float int_lim = fabsf(cfg_.integral_limit);
     integral_ = 0.0f;
     prev_error_ = error;
     last_output_ = clamp(output, -out_lim, out_lim);
-    last_us_ = micros();
-    has_state_ = false;
-    d_filter_.reset(0.0f);
-    integral_ = clamp(integral_, -int_lim, int_lim);
+    has_state_ = false; // 下次 compute 只做初始化，微分滤波随之重置
+}
+
+void MyPID::update_coeffs(float dt)
+{
+    k_.dt = dt;
+    k_.kp = P;
+    k_.ki = I;
+    k_.kd = D;
+    k_.ki_half_dt = 0.5f * I * dt;
+    k_.inv_dt = 1.0f / dt;
+    k_.kd_inv_dt = D * k_.inv_dt;
+    k_.ramp_step = cfg_.output_ramp * dt;
 }
 
 float MyPID::operator()(float error)
@@ -111,57 +124,20 @@ float MyPID::operator()(float error)
     return compute(error);
 }
 
-float MyPID::compute(float error)
+float MyPID::operator()(float error, float dt_s)
 {
-    // 先同步外部赋值的 P/I/D
-    cfg_.kp = P;
-    cfg_.ki = I;
-    cfg_.kd = D;
+    return compute(error, dt_s);
+}
 
+float MyPID::compute(float error)
+{
     const uint32_t now_us = micros();
-    if (!has_state_)
-    {
-        // 首次调用：仅用当前误差初始化，避免微分尖峰
-        prev_error_ = error;
-        last_us_ = now_us;
-        has_state_ = true;
-        const float out_lim = fabsf(cfg_.limit);
-        const float int_lim = fabsf(cfg_.integral_limit);
-        last_output_ = clamp(cfg_.kp * error, -out_lim, out_lim);
-        integral_ = clamp(0.0f, -int_lim, int_lim);
-        d_filter_.initialized = false;
-        return last_output_;
-    }
-
-    float dt = static_cast<float>(now_us - last_us_) * 1e-6f;
-    if (dt <= 0.0f || dt > 0.5f)
-    {
-        dt = 1e-3f; // 防止异常大间隔
-    }
-
-    // 梯形积分
-    integral_ += 0.5f * (error + prev_error_) * dt * cfg_.ki;
-    const float int_lim = fabsf(cfg_.integral_limit);
-    integral_ = clamp(integral_, -int_lim, int_lim);
-
-    // 微分（可选低通）
-    const float derr = (error - prev_error_) / (dt > 0.0f ? dt : 1e-6f);
-    const float d_term = cfg_.kd * ((cfg_.derivative_lpf_tau > 0.0f) ? d_filter_.apply(derr, dt) : derr);
-
-    // PID 输出
-    float output = cfg_.kp * error + integral_ + d_term;
-    const float out_lim = fabsf(cfg_.limit);
-    output = clamp(output, -out_lim, out_lim);
-
-    // 斜率限制
-    if (cfg_.output_ramp > 0.0f && has_state_)
-    {
-        const float max_step = cfg_.output_ramp * dt;
-        output = clamp(output, last_output_ - max_step, last_output_ + max_step);
-    }
-
-    last_output_ = output;
-    prev_error_ = error;
+    const float dt = has_state_ ? static_cast<float>(now_us - last_us_) * 1e-6f : 0.0f;
     last_us_ = now_us;
-    return output;
+    return compute(error, dt);
+}
+
+float MyPID::compute(float error, float dt)
+{
+    return step(error, dt);
 }
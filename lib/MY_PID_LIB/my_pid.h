@@ -2,18 +2,25 @@
 #include <Arduino.h>
 
 // 一阶低通滤波器，独立工具，可单独使用
+// 控制环应使用 apply(input, dt)：dt 与 tau 不变时系数只算一次
 struct LowPassFilter
 {
     float tau;          // 时间常数（s），越大越平滑
     float state;        // 当前输出
     bool initialized;   // 是否已初始化
-    uint32_t last_us;   // 上一次更新时间戳
+    uint32_t last_us;   // 上一次更新时间戳（仅 apply_auto 使用）
 
     explicit LowPassFilter(float tau_s = 0.0f);
     void reset(float value = 0.0f);
     float apply(float input, float dt_s);
     float apply_auto(float input);    // 自动计算 dt（基于 micros）
     float operator()(float input);    // 兼容函数式调用：只传入输入值
+    float operator()(float input, float dt_s);
+
+private:
+    float alpha_ = 1.0f; // 缓存的 dt / (tau + dt)
+    float alpha_dt_ = 0.0f;
+    float alpha_tau_ = -1.0f;
 };
 
 // PID 配置参数
@@ -36,7 +43,9 @@ struct PIDParams
               float d_tau = 0.0f);
 };
 
-// 轻量 PID 控制器，微秒计时 + 梯形积分 + 斜率限制
+// 轻量 PID 控制器，梯形积分 + 斜率限制
+// compute(error, dt) 由控制节拍统一给定 dt；ki*dt/2、1/dt、ramp*dt 等系数缓存，
+// 只在 P/I/D 或 dt 变化时重算，固定 dt 下每步只剩乘加与限幅
 class MyPID
 {
 public:
@@ -48,14 +57,29 @@ public:
     float I;
     float D;
 
-    float compute(float error);               // 直接输入误差
+    float compute(float error);               // 直接输入误差，内部用 micros() 计算 dt（兼容旧用法）
+    float compute(float error, float dt_s);   // 由控制节拍给定 dt
+    inline float step(float error, float dt_s); // 同 compute(error, dt)，头文件内联版本，供 my_pipeline.h 展开
     float operator()(float error);            // 兼容函数式调用：输入误差
+    float operator()(float error, float dt_s);
 
     void reset(float output = 0.0f, float error = 0.0f);
     float last_output() const { return last_output_; }
 
 private:
+    // 随 P/I/D 与 dt 变化的派生系数
+    struct Coeffs
+    {
+        float dt;        // 计算系数时的 dt
+        float kp, ki, kd; // 计算系数时的 P/I/D
+        float ki_half_dt; // 梯形积分 ki*dt/2
+        float inv_dt;
+        float kd_inv_dt;  // 无微分滤波时直接 kd/dt
+        float ramp_step;  // 每步最大输出变化
+    };
+
     PIDParams cfg_;
+    Coeffs k_;
     LowPassFilter d_filter_;
     float integral_;
     float prev_error_;
@@ -63,7 +87,52 @@ private:
     uint32_t last_us_;
     bool has_state_;
 
-    static float clamp(float v, float lo, float hi);
+    void update_coeffs(float dt);
+    static float clamp(float v, float lo, float hi)
+    {
+        return v < lo ? lo : (v > hi ? hi : v);
+    }
 };
 
 using PIDController = MyPID;
+
+inline float MyPID::step(float error, float dt)
+{
+    if (!has_state_)
+    {
+        // 首次调用：仅用当前误差初始化，避免微分尖峰
+        prev_error_ = error;
+        has_state_ = true;
+        last_output_ = clamp(P * error, -cfg_.limit, cfg_.limit);
+        integral_ = 0.0f;
+        d_filter_.initialized = false;
+        return last_output_;
+    }
+
+    if (dt <= 0.0f || dt > 0.5f)
+    {
+        dt = 1e-3f; // 防止异常大间隔
+    }
+    // 外部可直接改 P/I/D，与缓存不一致或 dt 变化时才重算系数
+    if (dt != k_.dt || P != k_.kp || I != k_.ki || D != k_.kd)
+        update_coeffs(dt);
+
+    // 梯形积分
+    integral_ = clamp(integral_ + (error + prev_error_) * k_.ki_half_dt, -cfg_.integral_limit, cfg_.integral_limit);
+
+    // 微分（可选低通）
+    const float d_term = (cfg_.derivative_lpf_tau > 0.0f)
+                             ? k_.kd * d_filter_.apply((error - prev_error_) * k_.inv_dt, dt)
+                             : (error - prev_error_) * k_.kd_inv_dt;
+
+    // PID 输出
+    float output = clamp(k_.kp * error + integral_ + d_term, -cfg_.limit, cfg_.limit);
+
+    // 斜率限制
+    if (k_.ramp_step > 0.0f)
+        output = clamp(output, last_output_ - k_.ramp_step, last_output_ + k_.ramp_step);
+
+    last_output_ = output;
+    prev_error_ = error;
+    return output;
+}
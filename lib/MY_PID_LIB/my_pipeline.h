@@ -0,0 +1,96 @@
+#pragma once
+#include <math.h>
+#include "my_pid.h"
+
+// 编译期组合的控制流水线：每级是只含静态 apply(x, dt) 的空类型，
+// Pipeline<A, B, C>::run(x, dt) 依次展开为 C(B(A(x)))，整条链在调用处内联，常量参数直接折叠
+//   Deadband<W> / Clamp<L> / Scale<K>   W、L、K 为携带 static constexpr float value 的类型（见 CTL_CONST）
+//   PID<inst> / LowPass<inst>           引用全局 MyPID / LowPassFilter 实例，增益仍可在运行时修改
+//   Gain<g>                             乘以全局 float g（运行时倍率）
+// 新增一级（陷波、前馈等）只需再写一个带静态 apply 的结构体；需要状态时同样引用全局实例
+
+// 定义编译期常量类型：CTL_CONST(AngDeadband, 0.5f);
+#define CTL_CONST(name, v)                  \
+    struct name                             \
+    {                                       \
+        static constexpr float value = (v); \
+    }
+
+namespace ctl
+{
+    // |x| < W 时输出 0；W 为 0 时整级被编译器删掉
+    template <typename W>
+    struct Deadband
+    {
+        static inline float apply(float x, float)
+        {
+            return (W::value > 0.0f && fabsf(x) < W::value) ? 0.0f : x;
+        }
+    };
+
+    // 对称限幅 [-L, L]
+    template <typename L>
+    struct Clamp
+    {
+        static inline float apply(float x, float)
+        {
+            const float lim = L::value;
+            return x > lim ? lim : (x < -lim ? -lim : x);
+        }
+    };
+
+    template <typename K>
+    struct Scale
+    {
+        static inline float apply(float x, float)
+        {
+            return x * K::value;
+        }
+    };
+
+    // 运行时倍率：引用全局 float（如增益调度结果），每拍读取
+    template <float &G>
+    struct Gain
+    {
+        static inline float apply(float x, float)
+        {
+            return x * G;
+        }
+    };
+
+    template <MyPID &Inst>
+    struct PID
+    {
+        static inline float apply(float e, float dt)
+        {
+            return Inst.step(e, dt);
+        }
+    };
+
+    template <LowPassFilter &Inst>
+    struct LowPass
+    {
+        static inline float apply(float x, float dt)
+        {
+            return Inst.apply(x, dt);
+        }
+    };
+
+    template <typename... Stages>
+    struct Pipeline;
+
+    template <>
+    struct Pipeline<>
+    {
+        static inline float run(float x, float) { return x; }
+    };
+
+    template <typename First, typename... Rest>
+    struct Pipeline<First, Rest...>
+    {
+        static inline float run(float x, float dt)
+        {
+            return Pipeline<Rest...>::run(First::apply(x, dt), dt);
+        }
+    };
+}
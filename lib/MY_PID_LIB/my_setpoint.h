@@ -0,0 +1,199 @@
+#pragma once
+#include <math.h>
+#include <stdint.h>
+
+// 带时间戳的离散指令 -> 控制节拍上的连续设定值（摇杆等几十毫秒一帧、经 WiFi 抖动到达的指令）
+//   SenderClock    发送端时钟对齐：offset = min(到达时刻 - 发送时刻)，以到得最快的一帧为零延迟基准；
+//                  每帧允许 offset 向上缓慢爬升以跟上两端晶振漂移，跳变过大（页面重载）时重新对齐
+//   SampleTrack    最近两帧按发送端时间戳求斜率，从最新一帧外推到当前时刻（最长 horizon），补偿网络延迟；
+//                  斜率只用发送端时间，到达时刻的抖动不影响
+//   JerkLimited    三阶跟踪：加加速度、加速度、速度都限幅，输出二阶连续，没有阶跃
+//   TimedSetpoint  以上组合 + 失联保护：超过 deadman 没有新帧，目标归零
+// 时间统一为 uint32 微秒，回绕按差值处理
+namespace ctl
+{
+    struct SenderClock
+    {
+        uint32_t offset = 0;
+        bool valid = false;
+
+        // 返回该帧在本地时钟下的发送时刻
+        uint32_t align(uint32_t sender_us, uint32_t rx_us, uint32_t creep_us, uint32_t resync_us)
+        {
+            const uint32_t cand = rx_us - sender_us;
+            const int32_t diff = static_cast<int32_t>(cand - offset);
+            if (!valid || diff < 0 || diff > static_cast<int32_t>(resync_us))
+                offset = cand;
+            else
+                offset += static_cast<uint32_t>(diff) < creep_us ? static_cast<uint32_t>(diff) : creep_us;
+            valid = true;
+            return sender_us + offset;
+        }
+    };
+
+    struct SampleTrack
+    {
+        float v0 = 0.0f, v1 = 0.0f;
+        uint32_t t0 = 0, t1 = 0;
+        uint8_t count = 0;
+
+        void reset(float v)
+        {
+            v0 = v1 = v;
+            count = 0;
+        }
+
+        void push(float v, uint32_t t)
+        {
+            if (count && static_cast<int32_t>(t - t1) <= 0)
+            {
+                v1 = v; // 时间戳相同或回退：只更新取值
+                return;
+            }
+            v0 = v1;
+            t0 = t1;
+            v1 = v;
+            t1 = t;
+            if (count < 2)
+                ++count;
+        }
+
+        // 返回 now 时刻的目标值，rate 为目标变化率（/s）；两帧间隔超过 horizon 的 4 倍视为不连续，不外推
+        float eval(uint32_t now, uint32_t horizon_us, float &rate) const
+        {
+            rate = 0.0f;
+            const int32_t span = static_cast<int32_t>(t1 - t0);
+            if (count < 2 || v1 == 0.0f || span <= 0 || span > 4 * static_cast<int32_t>(horizon_us))
+                return v1;
+            const float slope = (v1 - v0) / (span * 1e-6f);
+            int32_t ahead = static_cast<int32_t>(now - t1);
+            if (ahead < 0)
+                ahead = 0;
+            if (ahead >= static_cast<int32_t>(horizon_us))
+                return v1 + slope * (horizon_us * 1e-6f);
+            rate = slope;
+            return v1 + slope * (ahead * 1e-6f);
+        }
+    };
+
+    struct JerkLimited
+    {
+        float pos = 0.0f, vel = 0.0f, acc = 0.0f;
+
+        void reset(float p)
+        {
+            pos = p;
+            vel = acc = 0.0f;
+        }
+
+        // tau 为跟踪时间常数（临界阻尼），各限幅为正数
+        float update(float target, float target_rate, float dt, float tau, float v_max, float a_max, float j_max)
+        {
+            const float kp = 1.0f / (tau * tau);
+            const float kv = 2.0f / tau;
+            float a_des = kp * (target - pos) + kv * (target_rate - vel);
+            a_des = fminf(fmaxf(a_des, -a_max), a_max);
+            const float dj = j_max * dt;
+            acc += fminf(fmaxf(a_des - acc, -dj), dj);
+            vel += acc * dt;
+            if (fabsf(vel) > v_max)
+            {
+                vel = copysignf(v_max, vel);
+                acc = 0.0f;
+            }
+            pos += vel * dt;
+            return pos;
+        }
+    };
+
+    struct SetpointParams
+    {
+        uint32_t horizon_us;  // 最长外推
+        uint32_t deadman_us;  // 超过该时间没有新帧，目标归零
+        uint32_t creep_us;    // 时钟对齐每帧最大上调
+        uint32_t resync_us;   // 对齐偏差超过该值时重新对齐
+        float tau;            // 跟踪时间常数 (s)
+        float v_max, a_max, j_max;
+        float lo, hi;         // 目标值范围
+    };
+
+    template <int Axes>
+    class TimedSetpoint
+    {
+    public:
+        explicit TimedSetpoint(const SetpointParams &p) : p_(p) {}
+
+        // 收到一帧：sender_us 为发送端时间戳，rx_us 为本地到达时刻
+        void push(const float (&v)[Axes], uint32_t sender_us, uint32_t rx_us)
+        {
+            const uint32_t t = clock_.align(sender_us, rx_us, p_.creep_us, p_.resync_us);
+            delay_us = rx_us - t;
+            if (dead_)
+            {
+                // 失联后恢复：从归零后的目标重新开始，不拿失联前的旧帧求斜率
+                for (int i = 0; i < Axes; ++i)
+                    track_[i].reset(0.0f);
+                dead_ = false;
+            }
+            for (int i = 0; i < Axes; ++i)
+                track_[i].push(v[i], t);
+            last_rx_ = rx_us;
+            have_ = true;
+        }
+
+        // 每拍调用；返回 true 表示本拍刚触发失联保护
+        bool update(uint32_t now_us, float dt, float (&out)[Axes])
+        {
+            bool tripped = false;
+            if (have_ && !dead_ && static_cast<int32_t>(now_us - last_rx_) > static_cast<int32_t>(p_.deadman_us))
+            {
+                for (int i = 0; i < Axes; ++i)
+                {
+                    tripped |= track_[i].v1 != 0.0f;
+                    track_[i].reset(0.0f);
+                }
+                dead_ = true;
+            }
+            for (int i = 0; i < Axes; ++i)
+            {
+                float rate;
+                float target = track_[i].eval(now_us, p_.horizon_us, rate);
+                if (target <= p_.lo || target >= p_.hi)
+                {
+                    target = fminf(fmaxf(target, p_.lo), p_.hi);
+                    rate = 0.0f;
+                }
+                out[i] = fminf(fmaxf(gen_[i].update(target, rate, dt, p_.tau, p_.v_max, p_.a_max, p_.j_max), p_.lo), p_.hi);
+                // 目标为 0 且已贴近时直接落到 0，下游以 == 0 判断松杆
+                if (target == 0.0f && fabsf(out[i]) < 1e-3f && fabsf(gen_[i].vel) < 0.05f)
+                {
+                    gen_[i].reset(0.0f);
+                    out[i] = 0.0f;
+                }
+            }
+            return tripped;
+        }
+
+        // 输出立即归零并丢弃当前目标（摔倒等），之后的新帧照常生效
+        void reset()
+        {
+            for (int i = 0; i < Axes; ++i)
+            {
+                track_[i].reset(0.0f);
+                gen_[i].reset(0.0f);
+            }
+        }
+
+        bool dead() const { return dead_; }
+        uint32_t delay_us = 0; // 最近一帧比最快一帧多出的网络延迟
+
+    private:
+        SetpointParams p_;
+        SenderClock clock_;
+        SampleTrack track_[Axes];
+        JerkLimited gen_[Axes];
+        uint32_t last_rx_ = 0;
+        bool have_ = false;
+        bool dead_ = false;
+    };
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <math.h>
+
+// 等距网格双线性插值（增益调度表用）
+//   轴只存起点与步长倒数，下标由乘法直接算出，不做查找；越界钳到边界格
+//   每次查表约 2 次乘加定位 + 3 次 lerp，无数据相关分支
+
+namespace ctl
+{
+    // 一维等距轴：x0 ~ x1 共 N 个点
+    template <int N>
+    struct Axis
+    {
+        static_assert(N >= 2, "axis needs at least 2 points");
+        float x0 = 0.0f;
+        float inv_step = 1.0f;
+
+        void set(float x_first, float x_last)
+        {
+            const float span = x_last - x_first;
+            x0 = x_first;
+            inv_step = fabsf(span) > 1e-6f ? (N - 1) / span : 0.0f;
+        }
+
+        // 返回格下标 i（0 ~ N-2），frac 为格内位置（0 ~ 1）
+        inline int locate(float x, float &frac) const
+        {
+            float f = (x - x0) * inv_step;
+            f = fminf(fmaxf(f, 0.0f), static_cast<float>(N - 1));
+            int i = static_cast<int>(f);
+            i = i < N - 2 ? i : N - 2;
+            frac = f - static_cast<float>(i);
+            return i;
+        }
+    };
+
+    // table[y][x]，先定位两轴再插值；同一组轴可查多张表（定位一次）
+    template <int NX, int NY>
+    struct Grid2D
+    {
+        Axis<NX> x;
+        Axis<NY> y;
+
+        struct Cell
+        {
+            int ix, iy;
+            float fx, fy;
+        };
+
+        inline Cell locate(float xv, float yv) const
+        {
+            Cell c;
+            c.ix = x.locate(xv, c.fx);
+            c.iy = y.locate(yv, c.fy);
+            return c;
+        }
+
+        static inline float lookup(const float (&t)[NY][NX], const Cell &c)
+        {
+            const float a = t[c.iy][c.ix] + (t[c.iy][c.ix + 1] - t[c.iy][c.ix]) * c.fx;
+            const float b = t[c.iy + 1][c.ix] + (t[c.iy + 1][c.ix + 1] - t[c.iy + 1][c.ix]) * c.fx;
+            return a + (b - a) * c.fy;
+        }
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <math.h>
+#include <stdint.h>
+
+// 编码器速度观测器（α-β 滤波，即常加速度噪声模型下的稳态 Kalman）
+//   量测为累计计数（整数，不丢精度），状态为位置与速度；每拍用实测 dt 预测，
+//   残差按 α 修正位置、按 β/dt 修正速度。低速时单拍只有 0/±1 个计数，
+//   直接差分会在 0 与 ±0.117 rad/s 之间跳变，观测器把它平均成连续的速度
+//   α、β 由跟踪指数 λ = σa·dt² / σm 闭式算出（Kalata）：σa 为加速度噪声（计数/s²），
+//   σm 为量化噪声（1/√12 计数）；σa 越大跟得越紧、越不平滑
+struct VelObserver
+{
+    float alpha = 1.0f;
+    float beta = 0.0f;
+
+    // sigma_acc 为加速度噪声（计数/s²），dt_s 为标称周期
+    void configure(float sigma_acc, float dt_s)
+    {
+        const float sigma_meas = 0.288675f; // 1/√12：均匀量化噪声
+        const float lambda = sigma_acc * dt_s * dt_s / sigma_meas;
+        const float r = (4.0f + lambda - sqrtf(8.0f * lambda + lambda * lambda)) * 0.25f;
+        alpha = 1.0f - r * r;
+        beta = 2.0f * (2.0f - alpha) - 4.0f * sqrtf(1.0f - alpha);
+    }
+
+    void reset(int64_t count)
+    {
+        base_ = count;
+        offset_ = 0.0f;
+        vel_ = 0.0f;
+    }
+
+    // 返回速度（计数/s）
+    inline float update(int64_t count, float dt_s)
+    {
+        const float meas = static_cast<float>(count - base_); // 相对上一拍量测，避免大计数下浮点失精
+        const float pred = offset_ + vel_ * dt_s;
+        const float resid = meas - pred;
+        vel_ += (beta / dt_s) * resid;
+        offset_ = pred + alpha * resid - meas;
+        base_ = count;
+        return vel_;
+    }
+
+    float velocity() const { return vel_; }
+
+private:
+    int64_t base_ = 0;     // 上一拍量测计数
+    float offset_ = 0.0f;  // 位置估计 - base_（计数）
+    float vel_ = 0.0f;     // 速度估计（计数/s）
+};
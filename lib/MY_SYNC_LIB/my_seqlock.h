@@ -0,0 +1,140 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+// 任务间无锁数据交换
+// 各原语都只按字节复制 T，T 必须可平凡复制；读方拿到的一定是某一次完整写入的值，不会是两次写入拼成的
+namespace lockfree
+{
+    // 双缓冲 seqlock 快照：一个写者周期性发布，任意多个读者随时读取
+    // 写者写非当前缓冲再切换，读者只有在复制期间写者又连续发布两次才会重试（读者跨过整整一个发布周期），
+    // 写者从不等待读者
+    template <typename T>
+    class Snapshot
+    {
+    public:
+        // 仅写者调用
+        void publish(const T &v)
+        {
+            const uint32_t next = 1u - front_.load(std::memory_order_relaxed);
+            Slot &s = slot_[next];
+            const uint32_t seq = s.seq.load(std::memory_order_relaxed);
+            s.seq.store(seq + 1, std::memory_order_relaxed); // 奇数：正在写
+            std::atomic_thread_fence(std::memory_order_release);
+            const uint32_t n = count_.load(std::memory_order_relaxed) + 1;
+            memcpy(&s.data, &v, sizeof(T));
+            s.n = n;
+            s.seq.store(seq + 2, std::memory_order_release);
+            front_.store(next, std::memory_order_release);
+            count_.store(n, std::memory_order_release);
+        }
+
+        // 任意任务调用，返回读到的是第几次发布（0 表示尚未发布过，out 不变）
+        uint32_t read(T &out) const
+        {
+            for (;;)
+            {
+                if (count_.load(std::memory_order_acquire) == 0)
+                    return 0;
+                const Slot &s = slot_[front_.load(std::memory_order_acquire)];
+                const uint32_t s0 = s.seq.load(std::memory_order_acquire);
+                if (s0 & 1u)
+                    continue;
+                memcpy(&out, &s.data, sizeof(T));
+                const uint32_t n = s.n;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.seq.load(std::memory_order_relaxed) == s0)
+                    return n;
+            }
+        }
+
+        uint32_t count() const { return count_.load(std::memory_order_acquire); }
+
+    private:
+        struct Slot
+        {
+            std::atomic<uint32_t> seq{0};
+            uint32_t n = 0; // 本缓冲对应的发布序号
+            T data;
+        };
+        Slot slot_[2];
+        std::atomic<uint32_t> front_{0};
+        std::atomic<uint32_t> count_{0};
+    };
+
+    // 单槽命令邮箱：一个投递方、一个取件方，后投递的覆盖尚未取走的（只关心最新值的命令）
+    // 两边都不等待：取件时若投递方正在写或复制中被覆盖，本次返回 false，新值留到下一次取
+    template <typename T>
+    class Mailbox
+    {
+    public:
+        // 仅投递方调用
+        void post(const T &v)
+        {
+            const uint32_t seq = seq_.load(std::memory_order_relaxed);
+            seq_.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            memcpy(&data_, &v, sizeof(T));
+            seq_.store(seq + 2, std::memory_order_release);
+        }
+
+        // 仅取件方调用：有未取走的新值时写入 out 并返回 true
+        bool take(T &out)
+        {
+            const uint32_t s0 = seq_.load(std::memory_order_acquire);
+            if (s0 == taken_ || (s0 & 1u))
+                return false;
+            memcpy(&out, &data_, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) != s0)
+                return false;
+            taken_ = s0;
+            return true;
+        }
+
+    private:
+        std::atomic<uint32_t> seq_{0};
+        T data_;
+        uint32_t taken_ = 0;
+    };
+
+    // 单生产者单消费者环形队列：每条都要送达、按序处理的样本（IMU 中断样本、带时间戳的摇杆指令）
+    // N 为 2 的幂，最多存 N 条（头尾为自由递增计数，差值即条数）；满时 push 返回 false 由生产者计数丢弃，
+    // 两边都不等待，生产者可以是中断
+    template <typename T, uint32_t N>
+    class SpscQueue
+    {
+        static_assert(N >= 2 && (N & (N - 1)) == 0, "N 必须是 2 的幂");
+
+    public:
+        // 仅生产者调用
+        bool push(const T &v)
+        {
+            const uint32_t head = head_.load(std::memory_order_relaxed);
+            if (head - tail_.load(std::memory_order_acquire) >= N)
+                return false;
+            buf_[head & (N - 1)] = v;
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 仅消费者调用
+        bool pop(T &out)
+        {
+            const uint32_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire))
+                return false;
+            out = buf_[tail & (N - 1)];
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        static constexpr uint32_t capacity() { return N; }
+
+    private:
+        T buf_[N];
+        std::atomic<uint32_t> head_{0};
+        std::atomic<uint32_t> tail_{0};
+    };
+}
@@ -0,0 +1,119 @@
+#include "my_telem_codec.h"
+#include <math.h>
+#include <string.h>
+
+namespace
+{
+    int32_t quantize(float v, float step)
+    {
+        if (!isfinite(v) || step <= 0.0f)
+            return 0;
+        const float q = roundf(v / step);
+        if (q > 2.0e9f)
+            return 2000000000;
+        if (q < -2.0e9f)
+            return -2000000000;
+        return static_cast<int32_t>(q);
+    }
+
+    size_t put_varint(uint8_t *p, int32_t d)
+    {
+        uint32_t z = (static_cast<uint32_t>(d) << 1) ^ static_cast<uint32_t>(d >> 31);
+        size_t n = 0;
+        while (z >= 0x80)
+        {
+            p[n++] = static_cast<uint8_t>(z | 0x80);
+            z >>= 7;
+        }
+        p[n++] = static_cast<uint8_t>(z);
+        return n;
+    }
+
+    bool get_varint(const uint8_t *p, size_t len, size_t &pos, int32_t &d)
+    {
+        uint32_t z = 0;
+        for (int shift = 0; shift < 35; shift += 7)
+        {
+            if (pos >= len)
+                return false;
+            const uint8_t b = p[pos++];
+            z |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+            {
+                d = static_cast<int32_t>(z >> 1) ^ -static_cast<int32_t>(z & 1);
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+size_t TelemEncoder::encode(const float *v, const float *step, uint8_t n, bool key, uint8_t *out, bool &is_key)
+{
+    if (n > TELEM_CODEC_MAX_CHANNELS)
+        n = TELEM_CODEC_MAX_CHANNELS;
+    is_key = key || !valid_ || n != ref_n_;
+    size_t len = 0;
+    for (uint8_t i = 0; i < n; ++i)
+    {
+        const int32_t q = quantize(v[i], step[i]);
+        pending_[i] = q;
+        if (is_key)
+        {
+            memcpy(out + len, &q, sizeof(q));
+            len += sizeof(q);
+        }
+        else
+        {
+            // 差值按 uint32 回绕计算，解码端同样回绕，不会溢出
+            len += put_varint(out + len, static_cast<int32_t>(static_cast<uint32_t>(q) - static_cast<uint32_t>(ref_[i])));
+        }
+    }
+    pending_n_ = n;
+    return len;
+}
+
+void TelemEncoder::commit()
+{
+    memcpy(ref_, pending_, sizeof(ref_[0]) * pending_n_);
+    ref_n_ = pending_n_;
+    valid_ = true;
+}
+
+void TelemEncoder::invalidate()
+{
+    valid_ = false;
+}
+
+bool TelemDecoder::decode(const uint8_t *body, size_t len, const float *step, uint8_t n, bool is_key, float *v)
+{
+    if (n > TELEM_CODEC_MAX_CHANNELS)
+        return false;
+    if (!is_key && (!valid_ || n != ref_n_))
+        return false;
+    int32_t q[TELEM_CODEC_MAX_CHANNELS];
+    size_t pos = 0;
+    for (uint8_t i = 0; i < n; ++i)
+    {
+        if (is_key)
+        {
+            if (pos + sizeof(int32_t) > len)
+                return false;
+            memcpy(&q[i], body + pos, sizeof(int32_t));
+            pos += sizeof(int32_t);
+        }
+        else
+        {
+            int32_t d;
+            if (!get_varint(body, len, pos, d))
+                return false;
+            q[i] = static_cast<int32_t>(static_cast<uint32_t>(ref_[i]) + static_cast<uint32_t>(d));
+        }
+    }
+    memcpy(ref_, q, sizeof(q[0]) * n);
+    ref_n_ = n;
+    valid_ = true;
+    for (uint8_t i = 0; i < n; ++i)
+        v[i] = q[i] * step[i];
+    return true;
+}
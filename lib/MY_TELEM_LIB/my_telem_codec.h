@@ -0,0 +1,39 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// 遥测帧体编解码：各通道按自身精度（step）量化为整数
+//   关键帧：每通道 int32 小端
+//   差分帧：每通道相对参考值的差，zigzag + LEB128 变长（|差| < 64 个 step 时 1 字节）
+// 参考值只在帧确认送达全部客户端后更新（commit），未发出的帧不影响解码端
+
+#define TELEM_CODEC_MAX_CHANNELS 16
+#define TELEM_CODEC_MAX_BODY (TELEM_CODEC_MAX_CHANNELS * 5)
+
+class TelemEncoder
+{
+public:
+    // 编码 n 个通道到 out（至少 n*5 字节），返回帧体长度；key 为 false 时也可能因参考无效而输出关键帧
+    size_t encode(const float *v, const float *step, uint8_t n, bool key, uint8_t *out, bool &is_key);
+    void commit();     // 上一次 encode 的帧已送达全部客户端
+    void invalidate(); // 部分客户端未收到，下一帧必须是关键帧
+
+private:
+    int32_t ref_[TELEM_CODEC_MAX_CHANNELS] = {};
+    int32_t pending_[TELEM_CODEC_MAX_CHANNELS] = {};
+    uint8_t ref_n_ = 0;
+    uint8_t pending_n_ = 0;
+    bool valid_ = false;
+};
+
+class TelemDecoder
+{
+public:
+    // 解码帧体到 v，差分帧在参考无效或通道数不符时返回 false
+    bool decode(const uint8_t *body, size_t len, const float *step, uint8_t n, bool is_key, float *v);
+
+private:
+    int32_t ref_[TELEM_CODEC_MAX_CHANNELS] = {};
+    uint8_t ref_n_ = 0;
+    bool valid_ = false;
+};
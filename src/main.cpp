@@ -9,26 +9,68 @@
 #include "my_inspect.h"
 #include "my_group.h"
 #include "my_params.h"
+#include "my_motor.h"
+#include "my_state.h"
+#include "my_heap_trace.h"
+#include "esp_timer.h"
 
 static TaskHandle_t control_TaskHandle = nullptr;   // 运动控制
 static TaskHandle_t data_send_TaskHandle = nullptr; // 网页任务
 static TaskHandle_t screen_TaskHandle = nullptr; // 屏幕刷新任务
 static TaskHandle_t rgb_TaskHandle = nullptr; // RGB任务
+static hw_timer_t *control_timer = nullptr;         // 控制节拍硬件定时器
+
+#define CONTROL_TIMER_ID 0           // 硬件定时器编号
+#define CONTROL_TIMER_DIV 80         // 80MHz APB / 80 = 1us 计数
+#define CONTROL_TICK_TIMEOUT_MS 20   // 定时器失效时的兜底等待
+
+// 定时器中断只负责唤醒控制任务，相位固定，不随执行时间漂移
+static void IRAM_ATTR control_timer_isr()
+{
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(control_TaskHandle, &woken);
+    if (woken)
+        portYIELD_FROM_ISR();
+}
+
 // put function declarations here:
 void robot_control_Task(void *)
 {
     for (;;)
     {
+        // 通知计数 >1 说明上一拍执行超时，错过了节拍
+        const uint32_t pending = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CONTROL_TICK_TIMEOUT_MS));
+        if (pending == 0)
+            robot.tick.overrun++; // 定时器未触发，照常执行一拍保证电机指令刷新
+        else if (pending > 1)
+            robot.tick.overrun += pending - 1;
+
+        const int64_t start_us = esp_timer_get_time();
         my_motion_update();
-        vTaskDelay(pdMS_TO_TICKS(robot.dt_ms));
+        robot.tick.exec_us = static_cast<uint32_t>(esp_timer_get_time() - start_us);
+        if (robot.tick.exec_us > robot.tick.exec_max_us)
+            robot.tick.exec_max_us = robot.tick.exec_us;
     }
 }
 
+// 启动控制节拍：周期 = robot.dt_ms，硬件定时器中断驱动
+static void control_timer_init()
+{
+    control_timer = timerBegin(CONTROL_TIMER_ID, CONTROL_TIMER_DIV, true);
+    timerAttachInterrupt(control_timer, &control_timer_isr, true);
+    timerAlarmWrite(control_timer, static_cast<uint64_t>(robot.dt_ms) * 1000, true);
+    timerAlarmEnable(control_timer);
+}
+
 void data_send_Task(void *)
 {
+    my_heap_trace_watch(); // 统计遥测路径的堆分配次数
     for (;;)
     {
         my_web_data_update();
+        my_motor_service(); // 死区标定结果写 NVS（不在控制任务中写 flash）
+        if (my_state_take_save_request())
+            my_params_save(); // 网页改的参数已在控制任务中生效
         vTaskDelay(pdMS_TO_TICKS(robot.data_ms));
     }
 }
@@ -61,7 +103,7 @@ void setup() {
   //I2C初始化
   my_i2c_init();
   
-  //初始化运动（包括电机死区校准）
+  //初始化运动（死区读 NVS，标定在控制任务中后台进行）
   my_motion_init();
   
   //加载保存的PID参数和pitch零点
@@ -87,6 +129,7 @@ void setup() {
 
 
   xTaskCreatePinnedToCore(robot_control_Task, "ctrl_2ms", 8192, nullptr, 15, &control_TaskHandle, 0); // 初始化运动任务
+  control_timer_init(); // 任务创建后再启动定时器，保证中断里任务句柄有效
   xTaskCreatePinnedToCore(data_send_Task, "telem", 8192, nullptr, 5, &data_send_TaskHandle, 1);
   // 屏幕刷新放低优先级，避免阻塞网络/灯效任务
   xTaskCreatePinnedToCore(screen_Task, "screen", 8192, nullptr, 3, &screen_TaskHandle, 1);
@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+
+// 主机基准：pio run -e native_bench -t exec -- <子命令> [选项]
+// 每个子命令返回进程退出码，0 表示通过
+int bench_attitude(int argc, char **argv);
+int bench_telem(int argc, char **argv);
+int bench_pid(int argc, char **argv);
+int bench_lqr(int argc, char **argv);
+int bench_sched(int argc, char **argv);
+int bench_encoder(int argc, char **argv);
+int bench_sync(int argc, char **argv);
+int bench_joy(int argc, char **argv);
+int bench_fleet(int argc, char **argv);
+int bench_deadzone(int argc, char **argv);
+
+// 单调时钟（纳秒），用于统计每次调用耗时
+double bench_now_ns();
@@ -0,0 +1,263 @@
+// 姿态解算基准：同一组 IMU 数据依次喂给各估计器，比较每次 update 的耗时、pitch 跟踪误差和滞后
+// 滞后按平移误差平方和的最小点取抛物线插值，精度低于一个采样周期；有参考值时另测一条已知延迟 5ms 的参考作校验
+//   --csv FILE    读取实录数据：t_s,ax,ay,az,gx,gy,gz[,pitch_ref]（首行为表头）；无 pitch_ref 列时不计误差
+//   --seconds N   合成数据时长（默认 60）
+//   --rate HZ     合成数据采样率（默认 1000，与 MPU6050_SAMPLE_RATE_HZ 一致）
+// 合成数据模拟平衡车：pitch 低频摆动 + 周期性推扰，前向加速度与倾角同向（加速度计倾角被削弱），
+// 陀螺带缓慢漂移的残余零偏，噪声量级取 MPU6050 数据手册典型值（188Hz DLPF）
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "my_bench.h"
+#include "my_attitude.h"
+
+namespace
+{
+    constexpr float Pi = 3.14159265358979f;
+    constexpr float SettleSeconds = 2.0f; // 前 2 秒视为收敛过程，不计误差
+    constexpr int MaxLagSamples = 100;
+    constexpr float CheckDelayMs = 5.0f;  // 校验行：参考值本身延迟 5ms
+
+    struct bench_sample
+    {
+        float dt;
+        attitude_input in;
+        float pitch_ref;
+    };
+
+    struct bench_data
+    {
+        std::vector<bench_sample> samples;
+        bool has_ref = false;
+        float rate_hz = 0.0f;
+    };
+
+    float pitch_truth_deg(float t)
+    {
+        float p = 2.0f * sinf(2.0f * Pi * 0.7f * t) + 0.8f * sinf(2.0f * Pi * 3.1f * t);
+        // 每 5 秒一次 0.15s 的推扰（升余弦脉冲，峰值 6°）
+        const float tp = fmodf(t, 5.0f) - 2.5f;
+        if (tp >= 0.0f && tp < 0.15f)
+            p += 3.0f * (1.0f - cosf(2.0f * Pi * tp / 0.15f));
+        return p;
+    }
+
+    void synthesize(bench_data &data, float seconds, float rate_hz)
+    {
+        std::mt19937 rng(1);
+        std::normal_distribution<float> acc_noise(0.0f, 0.005f);
+        std::normal_distribution<float> gyro_noise(0.0f, 0.07f);
+        const float dt = 1.0f / rate_hz;
+        const size_t n = static_cast<size_t>(seconds * rate_hz);
+        data.samples.resize(n);
+        data.has_ref = true;
+        data.rate_hz = rate_hz;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const float t = i * dt;
+            const float pitch = pitch_truth_deg(t);
+            const float pitch_rate = (pitch_truth_deg(t + 0.5f * dt) - pitch_truth_deg(t - 0.5f * dt)) / dt;
+            const float roll = 0.5f * sinf(2.0f * Pi * 0.3f * t);
+            const float roll_rate = 0.5f * 2.0f * Pi * 0.3f * cosf(2.0f * Pi * 0.3f * t);
+            const float th = pitch * Pi / 180.0f;
+            const float ph = roll * Pi / 180.0f;
+            const float lin = 0.6f * sinf(th); // 前向加速度（g），平衡时与倾角同向
+
+            bench_sample &s = data.samples[i];
+            s.dt = dt;
+            s.in.ax = -sinf(th) + lin * cosf(th) + acc_noise(rng);
+            s.in.ay = sinf(ph) * cosf(th) + acc_noise(rng);
+            s.in.az = cosf(ph) * cosf(th) + lin * sinf(th) + acc_noise(rng);
+            s.in.gx = roll_rate + 0.3f + gyro_noise(rng);
+            s.in.gy = pitch_rate + 0.4f + 0.2f * t / seconds + gyro_noise(rng);
+            s.in.gz = 0.1f + gyro_noise(rng);
+            s.pitch_ref = pitch;
+        }
+    }
+
+    bool load_csv(bench_data &data, const char *path)
+    {
+        FILE *f = fopen(path, "r");
+        if (!f)
+        {
+            fprintf(stderr, "无法打开 %s\n", path);
+            return false;
+        }
+        char line[256];
+        float t_last = 0.0f;
+        bool first = true;
+        if (!fgets(line, sizeof(line), f)) // 表头
+        {
+            fclose(f);
+            return false;
+        }
+        data.has_ref = true;
+        while (fgets(line, sizeof(line), f))
+        {
+            float t, ref = 0.0f;
+            bench_sample s = {};
+            const int cols = sscanf(line, "%f,%f,%f,%f,%f,%f,%f,%f", &t, &s.in.ax, &s.in.ay, &s.in.az,
+                                    &s.in.gx, &s.in.gy, &s.in.gz, &ref);
+            if (cols < 7)
+                continue;
+            if (cols < 8)
+                data.has_ref = false;
+            s.dt = first ? 0.0f : t - t_last;
+            s.pitch_ref = ref;
+            t_last = t;
+            first = false;
+            data.samples.push_back(s);
+        }
+        fclose(f);
+        if (data.samples.size() > 1)
+            data.rate_hz = (data.samples.size() - 1) / t_last;
+        if (!data.samples.empty())
+            data.samples[0].dt = data.rate_hz > 0.0f ? 1.0f / data.rate_hz : 0.001f;
+        return !data.samples.empty();
+    }
+
+    struct bench_result
+    {
+        double ns_per_update;
+        double rms_deg;
+        double max_deg;
+        double lag_ms;
+    };
+
+    // 估计值相对参考平移 lag 个样本后的误差平方和（lag 可为负，即估计超前）
+    double shifted_sq(const std::vector<float> &pitch, const bench_data &data, size_t start, int lag)
+    {
+        const size_t n = pitch.size();
+        double s = 0.0;
+        for (size_t i = start + MaxLagSamples; i + MaxLagSamples < n; ++i)
+        {
+            const double e = pitch[i + lag] - data.samples[i].pitch_ref;
+            s += e * e;
+        }
+        return s;
+    }
+
+    // 滞后 (ms)：取误差平方和最小的整数平移，再用两侧相邻点拟合抛物线求顶点
+    double measure_lag_ms(const std::vector<float> &pitch, const bench_data &data, size_t start)
+    {
+        double sq[2 * MaxLagSamples + 1];
+        int best = 0;
+        for (int lag = -MaxLagSamples; lag <= MaxLagSamples; ++lag)
+        {
+            sq[lag + MaxLagSamples] = shifted_sq(pitch, data, start, lag);
+            if (sq[lag + MaxLagSamples] < sq[best + MaxLagSamples])
+                best = lag;
+        }
+        double frac = 0.0;
+        if (best > -MaxLagSamples && best < MaxLagSamples)
+        {
+            const double l = sq[best + MaxLagSamples - 1], c = sq[best + MaxLagSamples], r = sq[best + MaxLagSamples + 1];
+            const double den = l - 2.0 * c + r;
+            if (den > 0.0)
+                frac = 0.5 * (l - r) / den;
+        }
+        return (best + frac) * 1000.0 / data.rate_hz;
+    }
+
+    bench_result run_estimator(AttitudeEstimator &est, const bench_data &data)
+    {
+        const size_t n = data.samples.size();
+        std::vector<float> pitch(n);
+        est.reset(data.samples[0].in);
+
+        const double t0 = bench_now_ns();
+        for (size_t i = 0; i < n; ++i)
+        {
+            est.update(data.samples[i].in, data.samples[i].dt);
+            pitch[i] = est.output().angley;
+        }
+        const double t1 = bench_now_ns();
+
+        bench_result r = {(t1 - t0) / n, 0.0, 0.0, 0.0};
+        if (!data.has_ref)
+            return r;
+
+        const size_t start = static_cast<size_t>(SettleSeconds * data.rate_hz);
+        double sq = 0.0;
+        size_t cnt = 0;
+        for (size_t i = start; i < n; ++i)
+        {
+            const double e = pitch[i] - data.samples[i].pitch_ref;
+            sq += e * e;
+            if (fabs(e) > r.max_deg)
+                r.max_deg = fabs(e);
+            ++cnt;
+        }
+        r.rms_deg = cnt ? sqrt(sq / cnt) : 0.0;
+
+        r.lag_ms = measure_lag_ms(pitch, data, start);
+        return r;
+    }
+
+    // 校验滞后测量：参考值按线性插值延迟 CheckDelayMs，测出的滞后应与之相符
+    double check_lag_ms(const bench_data &data)
+    {
+        const size_t n = data.samples.size();
+        const double d = CheckDelayMs * 1e-3 * data.rate_hz;
+        const size_t whole = static_cast<size_t>(d);
+        const float frac = static_cast<float>(d - whole);
+        std::vector<float> delayed(n, data.samples[0].pitch_ref);
+        for (size_t i = whole + 1; i < n; ++i)
+            delayed[i] = (1.0f - frac) * data.samples[i - whole].pitch_ref + frac * data.samples[i - whole - 1].pitch_ref;
+        return measure_lag_ms(delayed, data, static_cast<size_t>(SettleSeconds * data.rate_hz));
+    }
+}
+
+int bench_attitude(int argc, char **argv)
+{
+    const char *csv = nullptr;
+    float seconds = 60.0f;
+    float rate = 1000.0f;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool has_val = i + 1 < argc;
+        if (!strcmp(argv[i], "--csv") && has_val)
+            csv = argv[++i];
+        else if (!strcmp(argv[i], "--seconds") && has_val)
+            seconds = static_cast<float>(atof(argv[++i]));
+        else if (!strcmp(argv[i], "--rate") && has_val)
+            rate = static_cast<float>(atof(argv[++i]));
+        else
+        {
+            fprintf(stderr, "未知参数: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    bench_data data;
+    if (csv)
+    {
+        if (!load_csv(data, csv))
+            return 2;
+    }
+    else
+    {
+        synthesize(data, seconds, rate);
+    }
+    printf("samples=%zu rate=%.0f Hz source=%s\n", data.samples.size(), data.rate_hz, csv ? csv : "synthetic");
+    printf("%-14s %10s %10s %10s %8s\n", "estimator", "ns/update", "rms(deg)", "max(deg)", "lag(ms)");
+    if (data.has_ref)
+    {
+        char name[16];
+        snprintf(name, sizeof(name), "ref+%.0fms", CheckDelayMs);
+        printf("%-14s %10s %10s %10s %8.2f\n", name, "-", "-", "-", check_lag_ms(data));
+    }
+    for (uint8_t m = 0; m < static_cast<uint8_t>(AttitudeMode::COUNT); ++m)
+    {
+        AttitudeEstimator &est = my_attitude_estimator(static_cast<AttitudeMode>(m));
+        const bench_result r = run_estimator(est, data);
+        if (data.has_ref)
+            printf("%-14s %10.1f %10.3f %10.3f %8.2f\n", est.name(), r.ns_per_update, r.rms_deg, r.max_deg, r.lag_ms);
+        else
+            printf("%-14s %10.1f %10s %10s %8s\n", est.name(), r.ns_per_update, "-", "-", "-");
+    }
+    return 0;
+}
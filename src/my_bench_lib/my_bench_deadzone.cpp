@@ -0,0 +1,207 @@
+// 起转死区后台标定：lib/MY_MOTOR_LIB/my_deadzone_cal.h 的状态机对着带静摩擦的车轮模型逐拍运行（2ms），
+// 外层与 my_motor.cpp 相同：Pending 时按有无 NVS 值选 Verify/Search，完成后置待保存，
+// 由 20ms 一次的低优先级任务（my_motor_service）写 NVS；依次经过以下场景，NVS 在场景间保留：
+//   search   首次上电（NVS 无值）：完整二分标定，写一次 NVS
+//   pause    完整标定期间两次启动平衡：运行时交还输出，停下后从当前轮继续，结果不变
+//   verify   用已保存的值重启：快速校验通过，不写 NVS
+//   rise     阈值整体升高 0.05 后重启：上界试探不转，校验不符转完整标定，写入新值
+//   drop     阈值回落 0.05 后重启：下界试探即转，同样转完整标定
+//   dead     右轮未接：标定失败，右轮记为 1.0，不写 NVS
+//   --jitter D   每次起转的静摩擦阈值随机偏差（标准差，默认 0.002）
+// 结果偏离真实阈值超过二分分辨率 + 4 倍偏差、阶段或 NVS 写入次数不符返回 1
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "my_bench.h"
+#include "my_config.h"
+#include "my_deadzone_cal.h"
+
+namespace
+{
+    constexpr uint32_t TickMs = 2;
+    constexpr uint32_t ServiceMs = 20;      // data_send_Task 周期量级
+    constexpr uint32_t TimeoutMs = 20000;
+    constexpr float Gain = 20.0f;           // 计数/ms 每单位占空比（超出动摩擦部分）
+    constexpr float KineticRatio = 0.8f;    // 动摩擦阈值 / 静摩擦阈值
+    constexpr float TauMs = 30.0f;          // 驱动时轮速时间常数
+    constexpr float CoastTauMs = 60.0f;     // 滑行衰减时间常数
+
+    // 一个车轮：静止时占空比超过（带随机偏差的）静摩擦阈值才起转，转动后按动摩擦阈值驱动或滑行
+    struct wheel_model
+    {
+        float omega = 0.0f; // 计数/ms
+        float pos = 0.0f;
+        float stick = -1.0f; // 本次静止的起转阈值，停下时重新抽样
+
+        uint32_t step(float duty, float th, std::normal_distribution<float> &jit, std::mt19937 &rng)
+        {
+            if (stick < 0.0f)
+                stick = th + jit(rng);
+            if (omega == 0.0f && duty < stick)
+                return 0;
+            const float target = duty >= KineticRatio * th ? Gain * (duty - KineticRatio * th) : 0.0f;
+            const float tau = target > 0.0f ? TauMs : CoastTauMs;
+            omega += (target - omega) * TickMs / tau;
+            if (target == 0.0f && omega < 0.01f)
+            {
+                omega = 0.0f;
+                stick = -1.0f;
+            }
+            const float before = pos;
+            pos += omega * TickMs;
+            return static_cast<uint32_t>(floorf(pos) - floorf(before));
+        }
+    };
+
+    struct nvs_model
+    {
+        bool has = false;
+        float v[DeadzoneCal::Curves] = {};
+        int writes = 0;
+    };
+
+    struct run_pause
+    {
+        uint32_t from_ms, to_ms;
+    };
+
+    struct scenario_result
+    {
+        DzPhase phase;
+        uint32_t ms;
+        float v[DeadzoneCal::Curves];
+        int writes;
+        bool released; // 运行平衡的每一拍都交还了输出
+    };
+
+    // 模拟一次上电到标定结束：th 为真实阈值（左正/左反/右正/右反，>1 表示不转）
+    scenario_result run(const float (&th)[DeadzoneCal::Curves], nvs_model &nvs, const run_pause *pauses, int n_pauses,
+                        float jitter, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::normal_distribution<float> jit(0.0f, jitter);
+        DeadzoneCal cal({MOTOR_DZ_MAX, MOTOR_DZ_ITERS, MOTOR_DZ_PROBE_MS, MOTOR_DZ_REST_MS, MOTOR_DZ_MOVE_COUNTS,
+                         MOTOR_DZ_VERIFY_MARGIN});
+        // my_motor_init：NVS 有值则立即使用，否则按默认 0.1
+        float start[DeadzoneCal::Curves] = {0.1f, 0.1f, 0.1f, 0.1f};
+        const bool loaded = nvs.has;
+        if (loaded)
+            memcpy(start, nvs.v, sizeof(start));
+        const int writes0 = nvs.writes;
+        bool save_pending = false;
+        bool released = true;
+        wheel_model w[2];
+        uint32_t delta[2] = {0, 0};
+        uint32_t now = 0;
+        for (; now < TimeoutMs; now += TickMs)
+        {
+            bool running = false;
+            for (int k = 0; k < n_pauses; ++k)
+                running |= now >= pauses[k].from_ms && now < pauses[k].to_ms;
+
+            if (cal.phase() == DzPhase::Pending)
+                cal.begin(loaded && MOTOR_DZ_VERIFY ? DzPhase::Verify : (loaded ? DzPhase::Done : DzPhase::Search), now);
+            float duty[2] = {0.0f, 0.0f};
+            const bool active = cal.update(now, running, delta, start, duty);
+            if (running && active)
+                released = false;
+            if (cal.event() == DzEvent::Done || cal.event() == DzEvent::Failed)
+            {
+                memcpy(start, cal.result(), sizeof(start));
+                save_pending = cal.event() == DzEvent::Done;
+            }
+            if (now % ServiceMs == 0 && save_pending)
+            {
+                save_pending = false;
+                memcpy(nvs.v, start, sizeof(start));
+                nvs.has = true;
+                nvs.writes++;
+            }
+            if (!cal.active() && !save_pending && cal.phase() != DzPhase::Pending)
+                break;
+
+            // 运行平衡时控制器接管，车轮这里按不动处理
+            const bool probing = active && cal.probing();
+            const bool fwd = cal.forward();
+            for (int i = 0; i < 2; ++i)
+                delta[i] = w[i].step(probing ? duty[i] : 0.0f, th[i * 2 + (fwd ? 0 : 1)], jit, rng);
+        }
+        scenario_result r = {cal.phase(), now, {}, nvs.writes - writes0, released};
+        memcpy(r.v, start, sizeof(start));
+        return r;
+    }
+
+    // 逐条检查：期望的阶段、NVS 写入次数、结果与真实阈值的偏差（不转的曲线应为 1.0）
+    bool report(const char *name, const scenario_result &r, const float (&th)[DeadzoneCal::Curves], DzPhase expect_phase,
+                int expect_writes, float tol)
+    {
+        static const char *const Phases[] = {"pending", "verify", "search", "done", "failed"};
+        float max_err = 0.0f;
+        bool ok = r.phase == expect_phase && r.writes == expect_writes && r.released;
+        for (int c = 0; c < DeadzoneCal::Curves; ++c)
+        {
+            if (th[c] > 1.0f)
+            {
+                ok &= r.v[c] == 1.0f;
+                continue;
+            }
+            const float err = r.v[c] - th[c];
+            if (fabsf(err) > fabsf(max_err))
+                max_err = err;
+        }
+        ok &= fabsf(max_err) <= tol;
+        printf("  %-8s %-7s %6.2f s  L %.3f/%.3f R %.3f/%.3f  err %+.4f  nvs writes %d%s  %s\n", name,
+               Phases[static_cast<int>(r.phase)], r.ms * 0.001, r.v[0], r.v[1], r.v[2], r.v[3], max_err, r.writes,
+               r.released ? "" : "  (held output while running)", ok ? "ok" : "FAIL");
+        return ok;
+    }
+}
+
+int bench_deadzone(int argc, char **argv)
+{
+    float jitter = 0.002f;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool has_val = i + 1 < argc;
+        if (!strcmp(argv[i], "--jitter") && has_val)
+            jitter = static_cast<float>(atof(argv[++i]));
+        else
+        {
+            fprintf(stderr, "未知参数: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    const float res = MOTOR_DZ_MAX / static_cast<float>(1u << MOTOR_DZ_ITERS);
+    const float tol = res + 4.0f * jitter;
+    printf("threshold jitter %.4f, search resolution %.4f, tolerance %.4f\n", jitter, res, tol);
+
+    const float th[DeadzoneCal::Curves] = {0.12f, 0.15f, 0.10f, 0.13f};
+    bool ok = true;
+
+    nvs_model nvs;
+    const scenario_result search = run(th, nvs, nullptr, 0, jitter, 1);
+    ok &= report("search", search, th, DzPhase::Done, 1, tol);
+
+    // 标定中途两次启动平衡（其中一次跨过方向切换）
+    nvs_model fresh;
+    const run_pause pauses[2] = {{700, 1300}, {search.ms / 2 - 100, search.ms / 2 + 400}};
+    ok &= report("pause", run(th, fresh, pauses, 2, jitter, 2), th, DzPhase::Done, 1, tol);
+
+    ok &= report("verify", run(th, nvs, nullptr, 0, jitter, 3), th, DzPhase::Done, 0, tol);
+
+    float drift[DeadzoneCal::Curves];
+    for (int c = 0; c < DeadzoneCal::Curves; ++c)
+        drift[c] = th[c] + 0.05f;
+    ok &= report("rise", run(drift, nvs, nullptr, 0, jitter, 4), drift, DzPhase::Done, 1, tol);
+    ok &= report("drop", run(th, nvs, nullptr, 0, jitter, 6), th, DzPhase::Done, 1, tol);
+
+    nvs_model none;
+    const float dead[DeadzoneCal::Curves] = {0.12f, 0.15f, 2.0f, 2.0f};
+    ok &= report("dead", run(dead, none, nullptr, 0, jitter, 5), dead, DzPhase::Failed, 0, tol);
+
+    printf("%s\n", ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
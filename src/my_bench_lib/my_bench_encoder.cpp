@@ -0,0 +1,144 @@
+// 编码器累计计数校验：模拟 PCNT 回绕计数器 + 溢出中断 + 控制节拍读数，对比两种读法
+//   clear    旧写法：读计数后 pcnt_counter_clear，读与清之间到达的脉冲丢失
+//   accum    my_enc_accum.h：不清零，中断累加 ±limit，读数按差值补偿未执行的中断
+// 脉冲流为随机变速正反转（含高速与来回穿越 ±limit），中断随机延迟若干个脉冲才执行，
+// 读与清之间随机到达 0~2 个脉冲（模拟 read→clear 的几微秒窗口）
+//   --seconds N   仿真时长（默认 600）
+//   --limit N     硬件计数上下限（默认 30000，与 my_encoder.cpp 一致；取小值可加速回绕，
+//                 但须大于每拍最大增量的 2 倍，35 rad/s 下约 600）
+// accum 任一拍与真值不符返回 1
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "my_bench.h"
+#include "my_enc_accum.h"
+
+namespace
+{
+    // 硬件计数器：到 ±limit 归零并挂起一次事件
+    struct pcnt_model
+    {
+        int32_t limit;
+        int32_t count = 0;
+        int pending = 0;       // 已归零但中断尚未执行的事件（+1 H_LIM，-1 L_LIM）
+        int pending_delay = 0; // 中断还需等待的脉冲数
+        int64_t overflow = 0;  // 中断累计
+
+        void pulse(int dir, std::mt19937 &rng)
+        {
+            count += dir;
+            if (count >= limit || count <= -limit)
+            {
+                pending += count > 0 ? 1 : -1;
+                count = 0;
+                pending_delay = static_cast<int>(rng() % 8);
+            }
+            service(false);
+        }
+
+        // 中断服务：延迟到期或读方退出临界区后执行
+        void service(bool force)
+        {
+            if (!pending)
+                return;
+            if (!force && pending_delay-- > 0)
+                return;
+            overflow += static_cast<int64_t>(pending) * limit;
+            pending = 0;
+        }
+    };
+}
+
+int bench_encoder(int argc, char **argv)
+{
+    float seconds = 600.0f;
+    int32_t limit = 30000;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool has_val = i + 1 < argc;
+        if (!strcmp(argv[i], "--seconds") && has_val)
+            seconds = static_cast<float>(atof(argv[++i]));
+        else if (!strcmp(argv[i], "--limit") && has_val)
+            limit = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "未知参数: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    constexpr double TickS = 0.002;
+    constexpr double CountsPerRad = 26950.0 / 6.283185307179586; // 与 my_encoder.cpp 一致
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+
+    pcnt_model hw_accum{limit};
+    pcnt_model hw_clear{limit};
+    EncoderAccum acc;
+    acc.limit = limit;
+    acc.reset(0, 0);
+
+    int64_t truth = 0;
+    int64_t clear_total = 0;
+    double phase = 0.0;
+    double speed = 0.0; // rad/s
+    uint64_t ticks = static_cast<uint64_t>(seconds / TickS);
+    uint64_t mismatches = 0;
+    uint64_t wraps = 0;
+    int64_t last_overflow = 0;
+
+    for (uint64_t k = 0; k < ticks; ++k)
+    {
+        // 变速：每 0.5s 换一个目标速度，偶尔满速，速度在 ±35 rad/s 内
+        if (k % 250 == 0)
+            speed = (uni(rng) < 0.1 ? 35.0 : 20.0) * (2.0 * uni(rng) - 1.0);
+        phase += speed * CountsPerRad * TickS;
+        const int64_t target = static_cast<int64_t>(phase);
+        // 节拍抖动：偶尔晚到（本拍脉冲在下一次读之前全部到达）
+        while (truth != target)
+        {
+            const int dir = target > truth ? 1 : -1;
+            truth += dir;
+            hw_accum.pulse(dir, rng);
+            hw_clear.pulse(dir, rng);
+        }
+
+        // accum：临界区内读 overflow 与计数，挂起的中断在退出后才执行
+        const int64_t total = acc.update(hw_accum.overflow, hw_accum.count);
+        hw_accum.service(true);
+        if (total != truth)
+            ++mismatches;
+        wraps += static_cast<uint64_t>(llabs(hw_accum.overflow - last_overflow) / limit);
+        last_overflow = hw_accum.overflow;
+
+        // clear：读 -> (窗口内到达的脉冲) -> 清零
+        clear_total += hw_clear.count + hw_clear.overflow;
+        hw_clear.overflow = 0;
+        const int window = static_cast<int>(rng() % 3);
+        const int dir = speed >= 0 ? 1 : -1;
+        for (int i = 0; i < window && i < llabs(static_cast<long long>(speed * CountsPerRad * TickS)); ++i)
+        {
+            // 窗口内的脉冲属于下一拍的运动，提前计入真值，但被清零丢掉
+            truth += dir;
+            phase += dir;
+            hw_accum.pulse(dir, rng);
+        }
+        hw_clear.count = 0;
+        hw_clear.service(true);
+    }
+
+    // 末拍窗口内的脉冲还没读，补读一次再比较
+    acc.update(hw_accum.overflow, hw_accum.count);
+    clear_total += hw_clear.count + hw_clear.overflow;
+
+    printf("ticks=%llu limit=%d wraps=%llu\n", static_cast<unsigned long long>(ticks), limit,
+           static_cast<unsigned long long>(wraps));
+    printf("  accum  total=%lld  error=%lld counts  mismatched reads=%llu\n", static_cast<long long>(acc.total),
+           static_cast<long long>(acc.total - truth), static_cast<unsigned long long>(mismatches));
+    printf("  clear  total=%lld  error=%lld counts (%.3f rad drift)\n", static_cast<long long>(clear_total),
+           static_cast<long long>(clear_total - truth), (clear_total - truth) / CountsPerRad);
+    const bool ok = mismatches == 0 && acc.total == truth;
+    printf("%s\n", ok ? "match" : "MISMATCH");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,399 @@
+// 车队 ESP-NOW 帧：my_fleet_proto.h 的 CRC16 帧与旧 XOR 校验对损坏帧的漏检，以及链路统计的准确性
+//   corrupt  随机运动指令帧分别翻转 1/2/3 位、16 位内突发翻转、随机改写 2 字节，统计校验仍通过且内容已变的帧
+//            旧格式：motion_command{L, R, timestamp, group_id} + 1 字节 XOR
+//   link     500Hz 指令流经 Gilbert-Elliott 突发丢包、乱序、重复与指数延迟到达，
+//            FleetLink 估计的丢包/晚到/重复与真实值对比，RFC 3550 抖动应接近延迟抖动均值
+//   sched    头车 500Hz 占空比指令流（随机推杆、松杆各半）经 FleetTxSchedule 变化即发 + 保活 + 限速，
+//            与每拍都发对比帧数，以及从车保持的占空比与头车的偏差（同样的随机丢包）
+//   --frames N    每种损坏的帧数（默认 200000）
+//   --seconds N   链路流与指令流时长（默认 60）
+//   --loss P      平均丢包率（默认 0.05）
+//   --tx-hz N     sched 的最高发送频率（默认 GROUP_TX_MAX_HZ）
+// CRC 漏检 3 位以内错误、丢包计数不符、抖动偏差超过 25%、发送间隔低于限速或超过保活间隔返回 1
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "my_bench.h"
+#include "my_fleet_proto.h"
+#include "my_fleet_tx.h"
+#include "my_config.h"
+
+namespace
+{
+    struct old_motion_command
+    {
+        float L_duty;
+        float R_duty;
+        uint32_t timestamp;
+        uint8_t group_id;
+        uint8_t checksum;
+    } __attribute__((packed));
+
+    struct motion_payload
+    {
+        float L_duty;
+        float R_duty;
+    } __attribute__((packed));
+
+    uint8_t old_checksum(const uint8_t *p, size_t len)
+    {
+        uint8_t sum = 0;
+        for (size_t i = 0; i + 1 < len; ++i)
+            sum ^= p[i];
+        return sum;
+    }
+
+    bool old_accepts(const uint8_t *p, size_t len)
+    {
+        return p[len - 1] == old_checksum(p, len);
+    }
+
+    bool new_accepts(const uint8_t *p, size_t len)
+    {
+        fleet_header h;
+        const uint8_t *payload;
+        size_t n;
+        return fleet_decode(p, len, h, payload, n) == FLEET_OK && h.type == FLEET_MSG_MOTION && n == sizeof(motion_payload);
+    }
+
+    enum corrupt_kind
+    {
+        FLIP1,
+        FLIP2,
+        FLIP3,
+        BURST16,
+        BYTES2,
+        KIND_COUNT
+    };
+    const char *const KindNames[KIND_COUNT] = {"1-bit", "2-bit", "3-bit", "burst<=16", "2-byte"};
+
+    void corrupt(uint8_t *p, size_t len, corrupt_kind k, std::mt19937 &rng)
+    {
+        const size_t bits = len * 8;
+        std::uniform_int_distribution<size_t> bit(0, bits - 1);
+        switch (k)
+        {
+        case FLIP1:
+        case FLIP2:
+        case FLIP3:
+        {
+            // 不重复的位
+            size_t used[3];
+            const int n = k == FLIP1 ? 1 : k == FLIP2 ? 2 : 3;
+            for (int i = 0; i < n; ++i)
+            {
+                size_t b;
+                bool dup;
+                do
+                {
+                    b = bit(rng);
+                    dup = false;
+                    for (int j = 0; j < i; ++j)
+                        dup |= used[j] == b;
+                } while (dup);
+                used[i] = b;
+                p[b / 8] ^= static_cast<uint8_t>(1u << (b % 8));
+            }
+            break;
+        }
+        case BURST16:
+        {
+            // 首尾两位必翻，中间随机
+            std::uniform_int_distribution<size_t> width(2, 16);
+            const size_t w = width(rng);
+            const size_t start = std::uniform_int_distribution<size_t>(0, bits - w)(rng);
+            for (size_t i = 0; i < w; ++i)
+                if (i == 0 || i == w - 1 || (rng() & 1))
+                    p[(start + i) / 8] ^= static_cast<uint8_t>(1u << ((start + i) % 8));
+            break;
+        }
+        default:
+        {
+            std::uniform_int_distribution<size_t> pos(0, len - 1);
+            const size_t a = pos(rng);
+            size_t b;
+            do
+                b = pos(rng);
+            while (b == a);
+            p[a] = static_cast<uint8_t>(p[a] ^ (1 + rng() % 255));
+            p[b] = static_cast<uint8_t>(p[b] ^ (1 + rng() % 255));
+            break;
+        }
+        }
+    }
+
+    bool run_corrupt(long frames)
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> duty(-1.0f, 1.0f);
+        printf("  %-10s %12s %12s\n", "corrupt", "xor missed", "crc16 missed");
+        bool ok = true;
+        for (int k = 0; k < KIND_COUNT; ++k)
+        {
+            long old_missed = 0, new_missed = 0;
+            for (long i = 0; i < frames; ++i)
+            {
+                old_motion_command oc = {duty(rng), duty(rng), static_cast<uint32_t>(rng()), 1, 0};
+                uint8_t old_frame[sizeof(oc)];
+                memcpy(old_frame, &oc, sizeof(oc));
+                old_frame[sizeof(oc) - 1] = old_checksum(old_frame, sizeof(oc));
+                uint8_t old_copy[sizeof(oc)];
+                memcpy(old_copy, old_frame, sizeof(oc));
+                corrupt(old_copy, sizeof(oc), static_cast<corrupt_kind>(k), rng);
+                if (memcmp(old_copy, old_frame, sizeof(oc)) && old_accepts(old_copy, sizeof(oc)))
+                    ++old_missed;
+
+                const motion_payload mp = {oc.L_duty, oc.R_duty};
+                const fleet_header h = {FLEET_MAGIC, FLEET_VERSION, FLEET_MSG_MOTION, 1, static_cast<uint16_t>(i), oc.timestamp};
+                uint8_t frame[FLEET_MAX_FRAME], copy[FLEET_MAX_FRAME];
+                const size_t len = fleet_encode(h, &mp, sizeof(mp), frame);
+                memcpy(copy, frame, len);
+                corrupt(copy, len, static_cast<corrupt_kind>(k), rng);
+                if (memcmp(copy, frame, len) && new_accepts(copy, len))
+                    ++new_missed;
+            }
+            printf("  %-10s %12ld %12ld\n", KindNames[k], old_missed, new_missed);
+            if (k <= FLIP3 || k == BURST16)
+                ok &= new_missed == 0;
+        }
+
+        // 编解码耗时
+        const motion_payload mp = {0.1f, -0.2f};
+        uint8_t frame[FLEET_MAX_FRAME];
+        constexpr int Steps = 1000000;
+        volatile size_t sink = 0;
+        const double t0 = bench_now_ns();
+        for (int i = 0; i < Steps; ++i)
+        {
+            const fleet_header h = {FLEET_MAGIC, FLEET_VERSION, FLEET_MSG_MOTION, 1, static_cast<uint16_t>(i), static_cast<uint32_t>(i)};
+            const size_t len = fleet_encode(h, &mp, sizeof(mp), frame);
+            sink = sink + new_accepts(frame, len);
+        }
+        printf("  %zu-byte frame: encode + decode %.0f ns\n", sizeof(fleet_header) + sizeof(mp) + 2, (bench_now_ns() - t0) / Steps);
+        return ok;
+    }
+
+    struct arrival
+    {
+        uint16_t seq;
+        uint32_t tx_us;
+        uint32_t rx_us;
+    };
+
+    bool run_link(double seconds, double loss)
+    {
+        constexpr uint32_t PeriodUs = 2000;
+        constexpr double DelayMeanUs = 500.0;
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<double> uni(0.0, 1.0);
+        std::exponential_distribution<double> delay(1.0 / DelayMeanUs);
+
+        // Gilbert-Elliott：坏状态丢包 50%，平均停留 10 帧；按目标平均丢包率反推进入坏状态的概率
+        const double p_bad_loss = 0.5, p_leave = 0.1;
+        const double bad_share = fmin(loss / p_bad_loss, 0.9);
+        const double p_enter = bad_share * p_leave / (1.0 - bad_share);
+
+        const long n = static_cast<long>(seconds * 1e6 / PeriodUs);
+        std::vector<arrival> rx;
+        std::vector<bool> got(n, false);
+        long dups = 0;
+        bool bad = false;
+        const uint32_t sender_offset = 0x80000000u; // 两端时钟任意偏移
+        const uint16_t seq0 = 65000;               // 跨越序号回绕
+        for (long i = 0; i < n; ++i)
+        {
+            bad = bad ? uni(rng) >= p_leave : uni(rng) < p_enter;
+            if (uni(rng) < (bad ? p_bad_loss : 0.0))
+                continue;
+            const uint32_t t = static_cast<uint32_t>(i * PeriodUs);
+            const arrival a = {static_cast<uint16_t>(seq0 + i), sender_offset + t, t + 1000 + static_cast<uint32_t>(delay(rng))};
+            rx.push_back(a);
+            got[i] = true;
+            if (uni(rng) < 0.001)
+            {
+                rx.push_back(a); // 重复
+                ++dups;
+            }
+        }
+        // 0.5% 的帧与后一帧交换顺序（不拆开重复帧，否则重复的那份会算作晚到）
+        long swaps = 0;
+        const auto is_dup = [&](size_t i) { return i + 1 < rx.size() && rx[i].seq == rx[i + 1].seq; };
+        for (size_t i = 0; i + 1 < rx.size(); ++i)
+            if (!is_dup(i) && !is_dup(i + 1) && (i == 0 || !is_dup(i - 1)) && uni(rng) < 0.005)
+            {
+                std::swap(rx[i], rx[i + 1]);
+                ++swaps;
+                ++i;
+            }
+
+        FleetLink link;
+        FleetLossWindow window;
+        double window_max = 0.0;
+        for (size_t i = 0; i < rx.size(); ++i)
+        {
+            link.on_frame(rx[i].seq, rx[i].tx_us, rx[i].rx_us);
+            if (i % 500 == 499) // 约 1s 一次读方取样
+                window_max = fmax(window_max, window.update(link.stats()));
+        }
+        const fleet_link_stats &s = link.stats();
+
+        // 最后一个收到的帧之后丢的无法得知，真实丢失按其之前计
+        long last = n - 1;
+        while (last > 0 && !got[last])
+            --last;
+        long true_lost = 0;
+        for (long i = 0; i <= last; ++i)
+            true_lost += !got[i];
+        const long true_rx = (last + 1) - true_lost;
+
+        printf("  link      frames=%ld lost=%ld (%.2f%%) swapped=%ld dup=%ld\n", n, true_lost, 100.0 * true_lost / (last + 1), swaps, dups);
+        printf("  FleetLink received=%u lost=%u late=%u dup=%u restarts=%u jitter=%u us (delay jitter mean %.0f us)\n",
+               s.received, s.lost, s.late, s.dup, s.restarts, s.jitter_us, DelayMeanUs);
+        printf("  1s window loss max %.1f%%\n", window_max * 100.0);
+        const bool counts_ok = static_cast<long>(s.received) == true_rx && static_cast<long>(s.lost) == true_lost &&
+                               static_cast<long>(s.late) == swaps && static_cast<long>(s.dup) == dups && s.restarts == 0;
+        const bool jitter_ok = fabs(s.jitter_us - DelayMeanUs) < 0.25 * DelayMeanUs;
+        return counts_ok && jitter_ok;
+    }
+
+    struct sched_result
+    {
+        long sent;
+        double err_rms;
+        double err_max;
+        double gap_max_ms; // 从车两次收到之间的最长间隔
+        uint32_t tx_gap_min_us;
+        uint32_t tx_gap_max_us;
+    };
+
+    // 每拍投递一次；schedule 为空时每拍都发（原方式）
+    sched_result run_stream(const std::vector<float> &duty, FleetTxSchedule *schedule, double loss, uint32_t seed)
+    {
+        constexpr uint32_t TickUs = 2000;
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> uni(0.0, 1.0);
+        sched_result r = {0, 0.0, 0.0, 0.0, UINT32_MAX, 0};
+        float sent_val = 0.0f, held = 0.0f;
+        bool has_sent = false;
+        uint32_t last_tx = 0, last_rx = 0;
+        double err_sq = 0.0;
+        for (size_t i = 0; i < duty.size(); ++i)
+        {
+            const uint32_t now = static_cast<uint32_t>(i * TickUs);
+            bool send = true;
+            if (schedule)
+            {
+                schedule->offer(!has_sent || fabsf(duty[i] - sent_val) > GROUP_TX_DUTY_EPS);
+                send = schedule->due(now);
+                if (send)
+                    schedule->sent(now);
+            }
+            if (send)
+            {
+                if (has_sent)
+                {
+                    r.tx_gap_min_us = now - last_tx < r.tx_gap_min_us ? now - last_tx : r.tx_gap_min_us;
+                    r.tx_gap_max_us = now - last_tx > r.tx_gap_max_us ? now - last_tx : r.tx_gap_max_us;
+                }
+                sent_val = duty[i];
+                has_sent = true;
+                last_tx = now;
+                ++r.sent;
+                if (uni(rng) >= loss)
+                {
+                    held = sent_val;
+                    r.gap_max_ms = fmax(r.gap_max_ms, (now - last_rx) / 1000.0);
+                    last_rx = now;
+                }
+            }
+            const double e = fabs(static_cast<double>(duty[i]) - held);
+            err_sq += e * e;
+            r.err_max = fmax(r.err_max, e);
+        }
+        r.err_rms = sqrt(err_sq / duty.size());
+        return r;
+    }
+
+    bool run_sched(double seconds, double loss, int tx_hz)
+    {
+        // 头车占空比：随机保持 0.5~3s 的推杆目标（一半为松杆），一阶 0.15s 平滑（代替 my_joy 的平滑）
+        const long n = static_cast<long>(seconds * 500.0);
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+        std::vector<float> duty(n);
+        float target = 0.0f, y = 0.0f;
+        long next_change = 0;
+        for (long i = 0; i < n; ++i)
+        {
+            if (i == next_change)
+            {
+                target = uni(rng) < 0.5f ? 0.0f : uni(rng) * 2.0f - 1.0f;
+                next_change = i + static_cast<long>((0.5f + 2.5f * uni(rng)) * 500.0f);
+            }
+            y += (target - y) * (0.002f / 0.15f);
+            duty[i] = fabsf(y - target) < 1e-4f ? target : y;
+        }
+
+        const uint32_t min_us = 1000000u / static_cast<uint32_t>(tx_hz);
+        const uint32_t keepalive_us = GROUP_TX_KEEPALIVE_MS * 1000;
+        FleetTxSchedule schedule(min_us, keepalive_us);
+        const sched_result every = run_stream(duty, nullptr, loss, 5);
+        const sched_result gated = run_stream(duty, &schedule, loss, 5);
+        const fleet_tx_counts &c = schedule.counts();
+
+        printf("  sched     %.0fs at 500Hz, loss %.1f%%, max %dHz, keepalive %ums, eps %.3f\n",
+               seconds, loss * 100.0, tx_hz, GROUP_TX_KEEPALIVE_MS, GROUP_TX_DUTY_EPS);
+        printf("  %-10s %10s %8s %10s %10s %12s\n", "mode", "frames/s", "share", "held rms", "held max", "rx gap max");
+        const sched_result *rows[2] = {&every, &gated};
+        const char *names[2] = {"every", "sched"};
+        for (int k = 0; k < 2; ++k)
+            printf("  %-10s %10.1f %7.1f%% %10.4f %10.4f %9.0f ms\n", names[k], rows[k]->sent / seconds,
+                   100.0 * rows[k]->sent / every.sent, rows[k]->err_rms, rows[k]->err_max, rows[k]->gap_max_ms);
+        printf("  sched     offered=%u skipped=%u coalesced=%u sent=%u keepalive=%u  tx gap %.1f..%.1f ms\n",
+               c.offered, c.skipped, c.coalesced, c.sent, c.keepalive, gated.tx_gap_min_us / 1000.0, gated.tx_gap_max_us / 1000.0);
+        // 每拍 2ms 才检查一次，间隔按拍取整；丢包下从车收到的最长间隔不得触发摇杆失联
+        return gated.tx_gap_min_us >= min_us && gated.tx_gap_max_us <= keepalive_us + 2000 &&
+               gated.gap_max_ms < JOY_DEADMAN_MS;
+    }
+}
+
+int bench_fleet(int argc, char **argv)
+{
+    long frames = 200000;
+    double seconds = 60.0;
+    double loss = 0.05;
+    int tx_hz = GROUP_TX_MAX_HZ;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool has_val = i + 1 < argc;
+        if (!strcmp(argv[i], "--frames") && has_val)
+            frames = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && has_val)
+            seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--loss") && has_val)
+            loss = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--tx-hz") && has_val)
+            tx_hz = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "未知参数: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (tx_hz < 1 || tx_hz > GROUP_TX_MAX_HZ_LIMIT)
+    {
+        fprintf(stderr, "--tx-hz 须在 1 ~ %d\n", GROUP_TX_MAX_HZ_LIMIT);
+        return 2;
+    }
+
+    const bool crc_ok = run_corrupt(frames);
+    const bool link_ok = run_link(seconds, loss);
+    const bool sched_ok = run_sched(seconds, loss, tx_hz);
+    const bool ok = crc_ok && link_ok && sched_ok;
+    printf("%s\n", ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+// 摇杆设定值生成：my_setpoint.h 与旧写法在 WiFi 抖动下的跟踪误差、滞后与平滑度
+//   raw    控制任务直接用最新到达的一帧（旧 x 轴）
+//   lpf    最新到达的一帧再经 0.2s 一阶低通（旧 y 轴 LQF_JOY）
+//   gen    TimedSetpoint：发送端时间戳对齐 + 外推 + 限加加速度跟踪（参数与 my_config.h 中 JOY_* 一致）
+// 摇杆轨迹为随机的平滑推杆/回中，网页每 50ms 发一帧；到达延迟 = 基础 + 指数抖动，偶发 WiFi 卡顿，
+// TCP 按序交付（卡顿后的帧一起到达）；发送端时钟带任意偏移与 50ppm 漂移
+// 误差对真实摇杆位置求 RMS；滞后为使 |out(t) - s(t - d)| RMS 最小的 d；步长为单拍最大变化量
+// 最后检查失联保护：推杆保持后停止发送，输出须在 deadman 后 0.5s 内归零
+//   --seconds N   仿真时长（默认 120）
+//   --jitter MS   指数抖动均值（默认 15）
+// gen 的误差不小于 lpf 或失联未归零返回 1
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "my_bench.h"
+#include "my_pid.h"
+#include "my_setpoint.h"
+
+namespace
+{
+    constexpr uint32_t TickUs = 2000;
+    constexpr uint32_t SendUs = 50000;
+
+    // 与 my_config.h 中 JOY_* 一致
+    const ctl::SetpointParams Params = {60000, 250000, 20, 500000, 0.03f, 20.0f, 400.0f, 20000.0f, -1.0f, 1.0f};
+
+    struct frame
+    {
+        float v;
+        uint32_t sender_us;
+        uint32_t rx_us;
+    };
+
+    struct metrics
+    {
+        std::vector<float> out;
+        double max_step = 0.0;
+    };
+
+    // 真实摇杆位置：每 0.3~1.5s 换一个目标（三分之一概率回中），0.1~0.3s 余弦过渡
+    std::vector<float> stick_path(size_t ticks, std::mt19937 &rng)
+    {
+        std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+        std::vector<float> s(ticks);
+        float from = 0.0f, to = 0.0f;
+        size_t seg_start = 0, seg_len = 1, ramp = 1;
+        for (size_t k = 0; k < ticks; ++k)
+        {
+            if (k - seg_start >= seg_len)
+            {
+                from = to;
+                to = uni(rng) < 0.33f ? 0.0f : 2.0f * uni(rng) - 1.0f;
+                seg_start = k;
+                seg_len = static_cast<size_t>((0.3f + 1.2f * uni(rng)) * 1e6f / TickUs);
+                ramp = static_cast<size_t>((0.1f + 0.2f * uni(rng)) * 1e6f / TickUs);
+            }
+            const size_t i = k - seg_start;
+            const float f = i >= ramp ? 1.0f : 0.5f - 0.5f * cosf(3.14159265f * i / ramp);
+            s[k] = from + (to - from) * f;
+        }
+        return s;
+    }
+
+    std::vector<frame> send_frames(const std::vector<float> &s, float jitter_ms, std::mt19937 &rng)
+    {
+        std::exponential_distribution<float> jitter(1.0f / jitter_ms);
+        std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+        std::vector<frame> f;
+        const uint32_t sender_offset = 123456789u;
+        uint32_t last_rx = 0;
+        for (size_t k = 0; k < s.size(); k += SendUs / TickUs)
+        {
+            const uint32_t t = static_cast<uint32_t>(k * TickUs);
+            float lat_ms = 8.0f + jitter(rng);
+            if (uni(rng) < 0.03f)
+                lat_ms += 150.0f; // WiFi 卡顿
+            uint32_t rx = t + static_cast<uint32_t>(lat_ms * 1000.0f);
+            if (rx < last_rx)
+                rx = last_rx; // TCP 按序交付
+            last_rx = rx;
+            const uint32_t sender = sender_offset + static_cast<uint32_t>(t * (1.0 + 50e-6));
+            // 网页端时间戳为毫秒
+            f.push_back({s[k], (sender / 1000u) * 1000u, rx});
+        }
+        return f;
+    }
+
+    double rms_at_delay(const std::vector<float> &s, const std::vector<float> &out, size_t d)
+    {
+        double sum = 0.0;
+        size_t n = 0;
+        for (size_t k = d; k < s.size(); ++k, ++n)
+            sum += (out[k] - s[k - d]) * (out[k] - s[k - d]);
+        return n ? sqrt(sum / n) : 0.0;
+    }
+
+    void report(const char *name, const std::vector<float> &s, const metrics &m, double &rms)
+    {
+        rms = rms_at_delay(s, m.out, 0);
+        size_t best_d = 0;
+        double best = rms;
+        for (size_t d = 1; d < 200; ++d)
+        {
+            const double r = rms_at_delay(s, m.out, d);
+            if (r < best)
+            {
+                best = r;
+                best_d = d;
+            }
+        }
+        printf("%-6s %10.4f %9.0f %10.4f %10.4f\n", name, rms, best_d * TickUs * 1e-3, best, m.max_step);
+    }
+
+    template <typename F>
+    metrics run(const std::vector<float> &s, const std::vector<frame> &frames, F step)
+    {
+        metrics m;
+        m.out.resize(s.size());
+        size_t next = 0;
+        float prev = 0.0f;
+        for (size_t k = 0; k < s.size(); ++k)
+        {
+            const uint32_t now = static_cast<uint32_t>(k * TickUs);
+            const frame *arrived = nullptr;
+            float out = 0.0f;
+            while (next < frames.size() && static_cast<int32_t>(frames[next].rx_us - now) <= 0)
+            {
+                arrived = &frames[next++];
+                step(arrived, now, out, false);
+            }
+            step(nullptr, now, out, true);
+            m.out[k] = out;
+            m.max_step = fmax(m.max_step, fabs(out - prev));
+            prev = out;
+        }
+        return m;
+    }
+
+    // 推杆 0.8 保持 1s 后停止发送，返回输出归零所用时间（s），未归零返回负数
+    float deadman_time()
+    {
+        ctl::TimedSetpoint<1> gen(Params);
+        const uint32_t stop_us = 1000000;
+        for (uint32_t now = 0; now < 3000000; now += TickUs)
+        {
+            if (now < stop_us && now % SendUs == 0)
+            {
+                const float v[1] = {0.8f};
+                gen.push(v, now - 10000, now); // 发送后 10ms 到达
+            }
+            float out[1];
+            gen.update(now, TickUs * 1e-6f, out);
+            if (now > stop_us && out[0] == 0.0f)
+                return (now - stop_us) * 1e-6f;
+        }
+        return -1.0f;
+    }
+}
+
+int bench_joy(int argc, char **argv)
+{
+    float seconds = 120.0f;
+    float jitter_ms = 15.0f;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool has_val = i + 1 < argc;
+        if (!strcmp(argv[i], "--seconds") && has_val)
+            seconds = static_cast<float>(atof(argv[++i]));
+        else if (!strcmp(argv[i], "--jitter") && has_val)
+            jitter_ms = static_cast<float>(atof(argv[++i]));
+        else
+        {
+            fprintf(stderr, "未知参数: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    std::mt19937 rng(11);
+    const size_t ticks = static_cast<size_t>(seconds * 1e6f / TickUs);
+    const std::vector<float> s = stick_path(ticks, rng);
+    const std::vector<frame> frames = send_frames(s, jitter_ms, rng);
+    printf("frames=%zu interval=%u ms jitter=%.0f ms\n", frames.size(), SendUs / 1000, jitter_ms);
+    printf("path     rms err  lag (ms)  rms@lag  max step\n");
+
+    float latest = 0.0f;
+    const metrics raw = run(s, frames, [&](const frame *f, uint32_t, float &out, bool tick) {
+        if (f)
+            latest = f->v;
+        if (tick)
+            out = latest;
+    });
+
+    LowPassFilter lpf(0.2f);
+    latest = 0.0f;
+    const metrics low = run(s, frames, [&](const frame *f, uint32_t, float &out, bool tick) {
+        if (f)
+            latest = f->v;
+        if (tick)
+            out = lpf.apply(latest, TickUs * 1e-6f);
+    });
+
+    ctl::TimedSetpoint<1> gen(Params);
+    const metrics smooth = run(s, frames, [&](const frame *f, uint32_t now, float &out, bool tick) {
+        if (f)
+        {
+            const float v[1] = {f->v};
+            gen.push(v, f->sender_us, f->rx_us);
+        }
+        if (tick)
+        {
+            float o[1];
+            gen.update(now, TickUs * 1e-6f, o);
+            out = o[0];
+        }
+    });
+
+    double rms_raw, rms_lpf, rms_gen;
+    report("raw", s, raw, rms_raw);
+    report("lpf", s, low, rms_lpf);
+    report("gen", s, smooth, rms_gen);
+
+    const float dm = deadman_time();
+    printf("deadman: output zero %.3f s after last frame (limit %.3f s)\n", dm, Params.deadman_us * 1e-6f + 0.5f);
+    const bool ok = rms_gen < rms_lpf && dm >= 0.0f && dm <= Params.deadman_us * 1e-6f + 0.5f;
+    printf("%s\n", ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
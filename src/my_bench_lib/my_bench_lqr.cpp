@@ -0,0 +1,86 @@
+// LQR 增益设计：由物理参数算出固件使用的 2x5 增益矩阵，并检查闭环离散系统谱半径
+//   --mass KG --com M --inertia KGM2 --wheel-mass KG --wheel-radius M --track M --yaw-inertia KGM2
+//   --stall NM --no-load RADS --vratio R      物理参数（默认与仿真模型一致）
+//   --q "a,b,c,d,e"  --r "a,b"                 权重（theta, theta_dot, phi, phi_dot, yaw_rate / 共模, 差模）
+//   --dt S                                     控制周期（默认 0.002）
+// 输出可直接粘贴进 my_motion.cpp 的 .lqr 默认值，或经网页 lqr_set 写入 NVS；不稳定或未收敛返回 1
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "my_bench.h"
+#include "my_lqr.h"
+
+namespace
+{
+    constexpr float DutySumLim = 10.0f; // 与 my_control.h 中 DUTY_SUM_LIM 一致
+
+    int parse_list(const char *s, float *out, int n)
+    {
+        int i = 0;
+        while (s && *s && i < n)
+        {
+            char *end;
+            out[i++] = strtof(s, &end);
+            s = (*end == ',') ? end + 1 : nullptr;
+        }
+        return i;
+    }
+}
+
+int bench_lqr(int argc, char **argv)
+{
+    lqr_plant p = lqr_default_plant();
+    lqr_weights w = lqr_default_weights();
+    float dt = 0.002f;
+    struct opt
+    {
+        const char *name;
+        float *v;
+    };
+    const opt opts[] = {
+        {"--mass", &p.body_mass}, {"--com", &p.body_com}, {"--inertia", &p.body_inertia},
+        {"--wheel-mass", &p.wheel_mass}, {"--wheel-radius", &p.wheel_radius}, {"--track", &p.track_width},
+        {"--yaw-inertia", &p.yaw_inertia}, {"--stall", &p.stall_torque}, {"--no-load", &p.no_load_speed},
+        {"--vratio", &p.voltage_ratio}, {"--dt", &dt},
+    };
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool has_val = i + 1 < argc;
+        bool known = false;
+        for (const opt &o : opts)
+            if (!strcmp(argv[i], o.name) && has_val)
+            {
+                *o.v = static_cast<float>(atof(argv[++i]));
+                known = true;
+                break;
+            }
+        if (known)
+            continue;
+        if (!strcmp(argv[i], "--q") && has_val && parse_list(argv[i + 1], w.q, LQR_STATES) == LQR_STATES)
+            ++i;
+        else if (!strcmp(argv[i], "--r") && has_val && parse_list(argv[i + 1], w.r, LQR_INPUTS) == LQR_INPUTS)
+            ++i;
+        else
+        {
+            fprintf(stderr, "未知参数: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    lqr_result res;
+    const bool ok = lqr_design(p, w, dt, DutySumLim, res);
+    printf("dt=%.4f s  mass=%.3f kg  com=%.3f m  stall=%.2f Nm  vratio=%.2f\n", dt, p.body_mass, p.body_com,
+           p.stall_torque, p.voltage_ratio);
+    printf("riccati: %s after %d iterations\n", res.converged ? "converged" : "NOT converged", res.iterations);
+    printf("closed-loop spectral radius: balance=%.6f yaw=%.6f\n", res.rho_balance, res.rho_yaw);
+    printf("K (pitch deg, rate deg/s, pos rad, spd rad/s, yaw deg/s):\n");
+    for (int i = 0; i < LQR_INPUTS; ++i)
+    {
+        printf("  {");
+        for (int j = 0; j < LQR_STATES; ++j)
+            printf("%s%.6ff", j ? ", " : "", res.k[i][j]);
+        printf("}%s\n", i + 1 < LQR_INPUTS ? "," : "");
+    }
+    printf("%s\n", ok ? "stable" : "UNSTABLE");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+// 主机基准入口：pio run -e native_bench -t exec -- <子命令> [选项]
+//   attitude [--csv FILE] [--seconds N] [--rate HZ]   姿态解算耗时与跟踪误差对比
+//   telem [--seconds N] [--rate HZ] [--key N]         遥测差分编码字节数与重建误差
+//   pid [--steps N] [--dt S]                          PID/低通单步耗时：micros() 自算 dt、逐步重算系数、固定 dt 缓存系数
+//   lqr [--mass KG ...] [--q LIST] [--r LIST]           由物理参数设计 LQR 增益并校验闭环稳定
+//   sched [--steps N]                                  增益调度表双线性插值耗时与正确性
+//   encoder [--seconds N] [--limit N]                  模拟脉冲流校验 64 位累计计数（不清零 + 溢出中断）
+//   sync [--seconds N] [--readers N]                   多线程校验快照/命令邮箱无拼接读
+//   joy [--seconds N] [--jitter MS]                    摇杆设定值生成与旧写法在网络抖动下的误差/滞后/平滑度
+//   fleet [--frames N] [--seconds N] [--loss P]        车队帧 CRC16 与旧 XOR 的漏检对比、链路统计准确性
+//   deadzone [--jitter D]                              起转死区后台标定状态机对静摩擦车轮模型：标定/暂停/校验/重标/失败
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include "my_bench.h"
+
+namespace
+{
+    struct bench_entry
+    {
+        const char *name;
+        int (*run)(int argc, char **argv);
+    };
+
+    const bench_entry Benches[] = {
+        {"attitude", bench_attitude},
+        {"telem", bench_telem},
+        {"pid", bench_pid},
+        {"lqr", bench_lqr},
+        {"sched", bench_sched},
+        {"encoder", bench_encoder},
+        {"sync", bench_sync},
+        {"joy", bench_joy},
+        {"fleet", bench_fleet},
+        {"deadzone", bench_deadzone},
+    };
+}
+
+double bench_now_ns()
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char **argv)
+{
+    const char *which = argc > 1 ? argv[1] : nullptr;
+    int rc = 0;
+    bool ran = false;
+    for (const bench_entry &b : Benches)
+    {
+        // 不带子命令时全部运行（默认参数）
+        if (which && strcmp(which, b.name) != 0)
+            continue;
+        printf("==== %s ====\n", b.name);
+        rc |= which ? b.run(argc - 1, argv + 1) : b.run(1, argv);
+        ran = true;
+    }
+    if (!ran)
+    {
+        fprintf(stderr, "未知子命令: %s\n", which);
+        return 2;
+    }
+    return rc;
+}
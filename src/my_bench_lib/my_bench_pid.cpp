@@ -0,0 +1,218 @@
+// PID 单步耗时基准：同一误差序列分别走几条路径，比较每步耗时
+//   legacy   compute(e)，每次调用读 micros() 自算 dt
+//   jitter   compute(e, dt)，dt 每拍抖动，系数每步重算
+//   fixed    compute(e, dt)，固定 dt，系数只在首拍计算
+//   lpf_auto / lpf_fixed   LowPassFilter 的 apply_auto 与 apply(input, dt)
+//   cascade_call / cascade_pipe   pitch_control 的三级串级：逐个调用 compute() 与 my_lim（改造前写法）
+//                                 对比 my_pipeline.h 编译期流水线（整条链内联）；二者应在噪声内持平，主要检查输出逐步一致
+//   --steps N   每条路径的步数（默认 1000000，每条路径跑 5 轮取最快）
+//   --dt S      固定周期（默认 0.002，与 robot.dt_ms 一致）
+// x86 上同时给出 rdtsc 周期数（TSC 频率下的周期，非核心周期）
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "my_bench.h"
+#include "my_pid.h"
+#include "my_pipeline.h"
+
+// 主机上没有 Arduino 时钟，legacy 路径读取的 micros() 由这里提供
+uint32_t micros()
+{
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+namespace
+{
+    volatile float Sink; // 防止结果被优化掉
+
+    uint64_t cycles_now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    struct path_result
+    {
+        double ns_per_step;
+        double cycles_per_step;
+    };
+
+    // 重复 Repeats 轮取最快一轮，压低主机调度噪声
+    constexpr int Repeats = 5;
+
+    template <typename Step>
+    path_result run_path(size_t steps, Step step)
+    {
+        path_result best = {1e30, 1e30};
+        for (int r = 0; r < Repeats; ++r)
+        {
+            const double t0 = bench_now_ns();
+            const uint64_t c0 = cycles_now();
+            float acc = 0.0f;
+            for (size_t i = 0; i < steps; ++i)
+                acc += step(i);
+            const uint64_t c1 = cycles_now();
+            const double t1 = bench_now_ns();
+            Sink = acc;
+            if ((t1 - t0) / steps < best.ns_per_step)
+                best = {(t1 - t0) / steps, static_cast<double>(c1 - c0) / steps};
+        }
+        return best;
+    }
+
+    // 与 PID_SPD 同量级的参数，带微分低通与斜率限制，走完整分支
+    MyPID make_pid()
+    {
+        return MyPID(0.8f, 0.05f, 0.01f, 100.0f, 50.0f, 5000.0f, 0.004f);
+    }
+
+    // 串级对比用：参数与 my_motion.cpp 默认值同量级，死区同 my_config.h（0）
+    constexpr float RadToDegF = 57.29577951308232f;
+    constexpr float PitchOffsetLimit = 10.0f;
+    constexpr float SpdDeadband = 0.0f;
+    constexpr float AngDeadband = 0.0f;
+    constexpr float TorDeadband = 0.0f;
+
+    // 固件中 my_lim 在 my_tool.cpp，对控制文件是外部调用
+    __attribute__((noinline)) float ext_lim(float v, float lim)
+    {
+        return v > lim ? lim : (v < -lim ? -lim : v);
+    }
+
+    struct cascade_in
+    {
+        float pos_err, spd_now, ang_now, gyro;
+    };
+}
+
+MyPID BenchPos{0.6f, 0.0f, 0.2f, 10.0f, 5.0f};
+MyPID BenchSpd{0.02f, 0.001f, 0.0f, 0.3f, 0.2f};
+MyPID BenchAng{0.9f, 0.0f, 0.0f, 10.0f, 5.0f};
+
+namespace
+{
+    CTL_CONST(BSpdDeadband, SpdDeadband);
+    CTL_CONST(BAngDeadband, AngDeadband);
+    CTL_CONST(BTorDeadband, TorDeadband);
+    CTL_CONST(BRadToDeg, RadToDegF);
+    CTL_CONST(BOffsetLimit, PitchOffsetLimit);
+    using BPos = ctl::Pipeline<ctl::PID<BenchPos>>;
+    using BSpd = ctl::Pipeline<ctl::Deadband<BSpdDeadband>, ctl::PID<BenchSpd>, ctl::Scale<BRadToDeg>, ctl::Clamp<BOffsetLimit>>;
+    using BAng = ctl::Pipeline<ctl::Deadband<BAngDeadband>, ctl::PID<BenchAng>>;
+    using BTor = ctl::Pipeline<ctl::Deadband<BTorDeadband>>;
+
+    float cascade_call(const cascade_in &in, float dt)
+    {
+        const float pos_duty = BenchPos.compute(in.pos_err, dt);
+        float spd_err = in.spd_now + pos_duty;
+        if (fabsf(spd_err) < SpdDeadband)
+            spd_err = 0.0f;
+        const float spd_duty = BenchSpd.compute(spd_err, dt);
+        const float offset = ext_lim(spd_duty * RadToDegF, PitchOffsetLimit);
+        float ang_err = in.ang_now + offset;
+        if (fabsf(ang_err) < AngDeadband)
+            ang_err = 0.0f;
+        float duty = BenchAng.compute(ang_err, dt) + ext_lim(0.05f * in.gyro, 10.0f);
+        if (fabsf(duty) < TorDeadband)
+            duty = 0.0f;
+        return duty;
+    }
+
+    float cascade_pipe(const cascade_in &in, float dt)
+    {
+        const float pos_duty = BPos::run(in.pos_err, dt);
+        const float offset = BSpd::run(in.spd_now + pos_duty, dt);
+        return BTor::run(BAng::run(in.ang_now + offset, dt) + ext_lim(0.05f * in.gyro, 10.0f), dt);
+    }
+}
+
+int bench_pid(int argc, char **argv)
+{
+    size_t steps = 1000000;
+    float dt = 0.002f;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool has_val = i + 1 < argc;
+        if (!strcmp(argv[i], "--steps") && has_val)
+            steps = static_cast<size_t>(atol(argv[++i]));
+        else if (!strcmp(argv[i], "--dt") && has_val)
+            dt = static_cast<float>(atof(argv[++i]));
+        else
+        {
+            fprintf(stderr, "未知参数: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (steps == 0 || dt <= 0.0f)
+        return 2;
+
+    // 误差序列与抖动 dt 预先生成，计时段内只有被测调用
+    const size_t n = 4096;
+    std::vector<float> err(n), dt_jit(n);
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0.0f, 0.2f);
+    std::uniform_real_distribution<float> jit(-0.05f, 0.05f);
+    for (size_t i = 0; i < n; ++i)
+    {
+        err[i] = 3.0f * sinf(0.01f * i) + noise(rng);
+        dt_jit[i] = dt * (1.0f + jit(rng));
+    }
+
+    MyPID legacy = make_pid(), jitter = make_pid(), fixed = make_pid();
+    LowPassFilter lpf_auto{0.2f}, lpf_fixed{0.2f};
+
+    struct row
+    {
+        const char *name;
+        path_result r;
+    };
+    std::vector<cascade_in> cin(n);
+    for (size_t i = 0; i < n; ++i)
+        cin[i] = {0.1f * err[i], err[(i + 7) & (n - 1)], 0.5f * err[(i + 13) & (n - 1)], 10.0f * err[(i + 29) & (n - 1)]};
+
+    const row rows[] = {
+        {"legacy", run_path(steps, [&](size_t i) { return legacy.compute(err[i & (n - 1)]); })},
+        {"jitter", run_path(steps, [&](size_t i) { return jitter.compute(err[i & (n - 1)], dt_jit[i & (n - 1)]); })},
+        {"fixed", run_path(steps, [&](size_t i) { return fixed.compute(err[i & (n - 1)], dt); })},
+        {"lpf_auto", run_path(steps, [&](size_t i) { return lpf_auto.apply_auto(err[i & (n - 1)]); })},
+        {"lpf_fixed", run_path(steps, [&](size_t i) { return lpf_fixed.apply(err[i & (n - 1)], dt); })},
+        {"cascade_call", run_path(steps, [&](size_t i) { return cascade_call(cin[i & (n - 1)], dt); })},
+        {"cascade_pipe", run_path(steps, [&](size_t i) { return cascade_pipe(cin[i & (n - 1)], dt); })},
+    };
+
+    printf("steps=%zu dt=%.4f s\n", steps, dt);
+    printf("%-12s %10s %12s\n", "path", "ns/step", "cycles/step");
+    for (const row &r : rows)
+    {
+        if (r.r.cycles_per_step > 0.0)
+            printf("%-12s %10.2f %12.1f\n", r.name, r.r.ns_per_step, r.r.cycles_per_step);
+        else
+            printf("%-12s %10.2f %12s\n", r.name, r.r.ns_per_step, "-");
+    }
+
+
+    // 两种写法必须逐步给出相同输出
+    BenchPos.reset();
+    BenchSpd.reset();
+    BenchAng.reset();
+    std::vector<float> ref(n);
+    for (size_t i = 0; i < n; ++i)
+        ref[i] = cascade_call(cin[i], dt);
+    BenchPos.reset();
+    BenchSpd.reset();
+    BenchAng.reset();
+    float max_diff = 0.0f;
+    for (size_t i = 0; i < n; ++i)
+        max_diff = fmaxf(max_diff, fabsf(cascade_pipe(cin[i], dt) - ref[i]));
+    printf("cascade call vs pipeline: max |diff| = %.3g\n", max_diff);
+    return max_diff == 0.0f ? 0 : 1;
+}
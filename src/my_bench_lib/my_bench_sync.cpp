@@ -0,0 +1,239 @@
+// 任务间无锁交换校验：my_seqlock.h 的快照、命令邮箱与环形队列在真实多线程下是否读到拼接值
+//   snapshot  1 个写线程不限速连续发布 1KB 记录（远快于 2ms 节拍），多个读线程不停读取，
+//             每条记录所有字都等于其序号，读到的序号单调不减，并与 read() 返回的发布序号一致
+//   mailbox   投递线程约每微秒投递一条递增记录（远快于网页/ESP-NOW），取件线程不停取出，
+//             同样检查整条一致且严格递增
+//   queue     SpscQueue 单线程先确认恰好存满 N 条，再由生产线程不限速推入递增序号、消费线程不停取出，
+//             取出的序号必须连续（推入失败的由生产者重试，不丢不重）
+//   另测单线程下发布与读取一次的耗时（与固件 robot_state 同量级）
+//   --seconds N   每项运行时长（默认 1）
+//   --readers N   快照读线程数（默认 3）
+// 出现拼接或回退返回 1
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "my_bench.h"
+#include "my_seqlock.h"
+
+namespace
+{
+    constexpr int Words = 256; // 1KB，略大于 robot_state（约 0.8KB）
+
+    struct record
+    {
+        uint32_t w[Words];
+        void fill(uint32_t n)
+        {
+            for (uint32_t &x : w)
+                x = n;
+        }
+        bool consistent() const
+        {
+            for (const uint32_t x : w)
+                if (x != w[0])
+                    return false;
+            return true;
+        }
+    };
+
+    struct reader_stats
+    {
+        uint64_t reads = 0;
+        uint64_t torn = 0;
+        uint64_t backwards = 0;
+    };
+
+    volatile uint32_t Sink;
+
+    bool run_snapshot(double seconds, int readers)
+    {
+        static lockfree::Snapshot<record> snap;
+        std::atomic<bool> stop{false};
+        std::vector<reader_stats> stats(readers);
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r)
+            threads.emplace_back([&, r] {
+                record rec;
+                uint32_t last = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    const uint32_t n = snap.read(rec);
+                    if (n == 0)
+                        continue;
+                    stats[r].reads++;
+                    if (!rec.consistent() || rec.w[0] != n)
+                        stats[r].torn++;
+                    if (n < last)
+                        stats[r].backwards++;
+                    last = n;
+                }
+            });
+
+        record rec;
+        uint32_t n = 0;
+        const double t_end = bench_now_ns() + seconds * 1e9;
+        while (bench_now_ns() < t_end)
+        {
+            rec.fill(++n);
+            snap.publish(rec);
+        }
+        stop.store(true);
+        for (std::thread &t : threads)
+            t.join();
+
+        reader_stats sum;
+        for (const reader_stats &s : stats)
+        {
+            sum.reads += s.reads;
+            sum.torn += s.torn;
+            sum.backwards += s.backwards;
+        }
+        printf("  snapshot  publishes=%u reads=%llu torn=%llu backwards=%llu\n", n,
+               static_cast<unsigned long long>(sum.reads), static_cast<unsigned long long>(sum.torn),
+               static_cast<unsigned long long>(sum.backwards));
+        return sum.reads > 0 && sum.torn == 0 && sum.backwards == 0;
+    }
+
+    bool run_mailbox(double seconds)
+    {
+        static lockfree::Mailbox<record> box;
+        std::atomic<bool> stop{false};
+        reader_stats st;
+        std::thread consumer([&] {
+            record rec;
+            uint32_t last = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                if (!box.take(rec))
+                    continue;
+                st.reads++;
+                if (!rec.consistent())
+                    st.torn++;
+                if (rec.w[0] <= last)
+                    st.backwards++;
+                last = rec.w[0];
+            }
+        });
+
+        record rec;
+        uint32_t n = 0;
+        const double t_end = bench_now_ns() + seconds * 1e9;
+        for (double t = bench_now_ns(); t < t_end; t = bench_now_ns())
+        {
+            rec.fill(++n);
+            box.post(rec);
+            while (bench_now_ns() < t + 1000.0)
+                std::this_thread::yield();
+        }
+        stop.store(true);
+        consumer.join();
+        printf("  mailbox   posts=%u takes=%llu torn=%llu not-newer=%llu\n", n,
+               static_cast<unsigned long long>(st.reads), static_cast<unsigned long long>(st.torn),
+               static_cast<unsigned long long>(st.backwards));
+        return st.reads > 0 && st.torn == 0 && st.backwards == 0;
+    }
+
+    bool run_queue(double seconds)
+    {
+        constexpr uint32_t N = 32; // 与 IMU 环形缓冲相同
+        static lockfree::SpscQueue<uint32_t, N> fill_q;
+        uint32_t stored = 0;
+        while (fill_q.push(stored))
+            stored++;
+        const bool full_ok = stored == fill_q.capacity();
+
+        static lockfree::SpscQueue<uint32_t, N> q;
+        std::atomic<bool> stop{false};
+        uint64_t pops = 0, gaps = 0;
+        std::thread consumer([&] {
+            uint32_t expect = 1, v;
+            for (;;)
+            {
+                // 先读停止标志再取：看到停止后取空即说明生产者推入的都已取完
+                const bool last = stop.load(std::memory_order_acquire);
+                if (!q.pop(v))
+                {
+                    if (last)
+                        break;
+                    std::this_thread::yield();
+                    continue;
+                }
+                pops++;
+                if (v != expect)
+                    gaps++;
+                expect = v + 1;
+            }
+        });
+
+        uint32_t n = 0;
+        uint64_t full = 0;
+        const double t_end = bench_now_ns() + seconds * 1e9;
+        while (bench_now_ns() < t_end)
+        {
+            ++n;
+            while (!q.push(n))
+            {
+                full++;
+                std::this_thread::yield();
+            }
+        }
+        stop.store(true, std::memory_order_release);
+        consumer.join();
+        printf("  queue     capacity %u/%u  pushes=%u pops=%llu full=%llu gaps=%llu\n", stored, N, n,
+               static_cast<unsigned long long>(pops), static_cast<unsigned long long>(full),
+               static_cast<unsigned long long>(gaps));
+        return full_ok && pops == n && gaps == 0;
+    }
+
+    void time_single_thread()
+    {
+        static lockfree::Snapshot<record> snap;
+        record rec, out;
+        constexpr int Steps = 200000;
+        rec.fill(1);
+        double t0 = bench_now_ns();
+        for (int i = 0; i < Steps; ++i)
+        {
+            rec.w[0] = i;
+            snap.publish(rec);
+        }
+        const double publish_ns = (bench_now_ns() - t0) / Steps;
+        t0 = bench_now_ns();
+        for (int i = 0; i < Steps; ++i)
+            Sink = snap.read(out) + out.w[i % Words];
+        const double read_ns = (bench_now_ns() - t0) / Steps;
+        printf("  %zu-byte record: publish %.0f ns  read %.0f ns\n", sizeof(record), publish_ns, read_ns);
+    }
+}
+
+int bench_sync(int argc, char **argv)
+{
+    double seconds = 1.0;
+    int readers = 3;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool has_val = i + 1 < argc;
+        if (!strcmp(argv[i], "--seconds") && has_val)
+            seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--readers") && has_val)
+            readers = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "未知参数: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (readers < 1)
+        readers = 1;
+
+    time_single_thread();
+    const bool snap_ok = run_snapshot(seconds, readers);
+    const bool box_ok = run_mailbox(seconds);
+    const bool queue_ok = run_queue(seconds);
+    const bool ok = snap_ok && box_ok && queue_ok;
+    printf("%s\n", ok ? "consistent" : "TORN");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+// 遥测编码基准：按平衡车典型波形合成 4 路姿态/电量 + 9 路曲线，比较每帧字节数与编码耗时
+//   --seconds N   时长（默认 60）
+//   --rate HZ     遥测频率（默认 100）
+//   --key N       关键帧间隔（默认 100，与 TELEM_KEY_INTERVAL 一致）
+// 同时用 TelemDecoder 解码，检查重建误差不超过半个量化步长
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "my_bench.h"
+#include "my_telem_codec.h"
+
+namespace
+{
+    constexpr float Pi = 3.14159265358979f;
+    constexpr int Channels = 13;
+    constexpr size_t HeadBytes = 12; // telem_frame_head
+    // 与 TELEM_FIELD_STEPS、CHART_STEP1~3 一致
+    const float Steps[Channels] = {0.01f, 0.01f, 0.01f, 0.01f,
+                                   0.01f, 0.01f, 0.01f,
+                                   0.1f, 0.1f, 0.1f,
+                                   0.01f, 0.01f, 0.01f};
+
+    void synth(float t, std::mt19937 &rng, float v[Channels])
+    {
+        std::normal_distribution<float> noise(0.0f, 1.0f);
+        const float ang = 1.5f * sinf(2.0f * Pi * 0.7f * t) + 0.05f * noise(rng);
+        const float ang_tar = 0.5f * sinf(2.0f * Pi * 0.2f * t);
+        const float spd = 4.0f * sinf(2.0f * Pi * 0.25f * t) + 0.2f * noise(rng);
+        const float spd_tar = 4.0f * sinf(2.0f * Pi * 0.25f * t - 0.3f);
+        v[0] = ang;                                   // pitch
+        v[1] = 0.3f * sinf(2.0f * Pi * 0.3f * t);      // roll
+        v[2] = fmodf(12.0f * t, 360.0f);               // yaw
+        v[3] = 11.8f + 0.02f * noise(rng);             // battery
+        v[4] = ang_tar;
+        v[5] = ang;
+        v[6] = ang_tar - ang;
+        v[7] = 30.0f * (ang_tar - ang) + 3.0f * noise(rng); // ang.duty
+        v[8] = 10.0f * 0.8f * (spd_tar - spd);
+        v[9] = 10.0f * 0.2f * sinf(2.0f * Pi * 0.1f * t);
+        v[10] = spd;
+        v[11] = spd_tar;
+        v[12] = 10.0f * 0.1f * sinf(2.0f * Pi * 0.1f * t);
+    }
+}
+
+int bench_telem(int argc, char **argv)
+{
+    float seconds = 60.0f;
+    float rate = 100.0f;
+    int key_interval = 100;
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool has_val = i + 1 < argc;
+        if (!strcmp(argv[i], "--seconds") && has_val)
+            seconds = static_cast<float>(atof(argv[++i]));
+        else if (!strcmp(argv[i], "--rate") && has_val)
+            rate = static_cast<float>(atof(argv[++i]));
+        else if (!strcmp(argv[i], "--key") && has_val)
+            key_interval = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "未知参数: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    std::mt19937 rng(1);
+    TelemEncoder enc;
+    TelemDecoder dec;
+    const int frames = static_cast<int>(seconds * rate);
+    uint8_t body[TELEM_CODEC_MAX_BODY];
+    float v[Channels], out[Channels];
+    size_t bytes = 0, max_frame = 0, keys = 0;
+    double err_ratio = 0.0, enc_ns = 0.0;
+    int since_key = 0;
+    bool ok = true;
+
+    for (int f = 0; f < frames; ++f)
+    {
+        synth(f / rate, rng, v);
+        bool is_key;
+        const double t0 = bench_now_ns();
+        const size_t len = enc.encode(v, Steps, Channels, since_key >= key_interval, body, is_key);
+        enc.commit();
+        enc_ns += bench_now_ns() - t0;
+        since_key = is_key ? 0 : since_key + 1;
+        keys += is_key;
+        bytes += HeadBytes + len;
+        if (HeadBytes + len > max_frame)
+            max_frame = HeadBytes + len;
+
+        if (!dec.decode(body, len, Steps, Channels, is_key, out))
+        {
+            fprintf(stderr, "帧 %d 解码失败\n", f);
+            ok = false;
+            break;
+        }
+        for (int c = 0; c < Channels; ++c)
+        {
+            const double r = fabs(out[c] - v[c]) / Steps[c];
+            if (r > err_ratio)
+                err_ratio = r;
+        }
+    }
+
+    const double per_frame = static_cast<double>(bytes) / frames;
+    const size_t raw = HeadBytes + Channels * sizeof(float);
+    printf("frames=%d rate=%.0f Hz channels=%d key_interval=%d keys=%zu\n", frames, rate, Channels, key_interval, keys);
+    printf("%-18s %10s %12s\n", "format", "bytes/frame", "kbit/s");
+    printf("%-18s %10d %12.1f\n", "json (v0, est.)", 250, 250 * 8 * rate / 1000.0);
+    printf("%-18s %10zu %12.1f\n", "float32 (v1)", raw, raw * 8 * rate / 1000.0);
+    printf("%-18s %10.1f %12.1f   max %zu B\n", "key+delta (v2)", per_frame, per_frame * 8 * rate / 1000.0, max_frame);
+    printf("encode %.0f ns/frame, max error %.3f step\n", enc_ns / frames, err_ratio);
+    // 重建误差只来自量化（≤0.5 step，留 float 舍入余量）
+    if (err_ratio > 0.51)
+    {
+        fprintf(stderr, "重建误差超过半个量化步长\n");
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
@@ -4,6 +4,8 @@
 #include "my_motion.h"
 #include "driver/gpio.h"  
 #include "driver/pcnt.h" 
+#include "my_vel_observer.h"
+#include "my_enc_accum.h"
 
 volatile int32_t Encoder_Left_Delta = 0; 
 volatile int32_t Encoder_Right_Delta = 0;
@@ -22,9 +24,49 @@ namespace
     constexpr float RadPerCount = (2.0f * PI) / CountsPerWheelRev; // 单个脉冲对应的轮子转角(rad)
 
     bool encoder_ready = false;                     // 记录初始化是否完成
+    bool isr_ready = false;                         // PCNT 中断服务只安装一次
     int64_t LeftTotalCount = 0;                     // 左轮累计脉冲数
     int64_t RightTotalCount = 0;                    // 右轮累计脉冲数
 
+    // 硬件计数器从不清零：计到 ±CountLimit 时自动归零，中断把 ±CountLimit 累加到 overflow，
+    // 读数时在同一临界区内取 overflow 与计数，相减得到增量（见 my_enc_accum.h）
+    portMUX_TYPE OverflowMux = portMUX_INITIALIZER_UNLOCKED;
+    volatile int64_t LeftOverflow = 0;
+    volatile int64_t RightOverflow = 0;
+    EncoderAccum LeftAccum;
+    EncoderAccum RightAccum;
+
+    void IRAM_ATTR pcnt_overflow_isr(void *arg)
+    {
+        const pcnt_unit_t unit = static_cast<pcnt_unit_t>(reinterpret_cast<intptr_t>(arg));
+        uint32_t status = 0;
+        pcnt_get_event_status(unit, &status);
+        int64_t step = 0;
+        if (status & PCNT_EVT_H_LIM)
+            step += CountLimit;
+        if (status & PCNT_EVT_L_LIM)
+            step -= CountLimit;
+        portENTER_CRITICAL_ISR(&OverflowMux);
+        if (unit == LeftUnit)
+            LeftOverflow += step;
+        else
+            RightOverflow += step;
+        portEXIT_CRITICAL_ISR(&OverflowMux);
+    }
+
+    // 同一临界区内读取两轮的 overflow 与硬件计数
+    void read_counts(int64_t &left_ov, int16_t &left_cnt, int64_t &right_ov, int16_t &right_cnt)
+    {
+        portENTER_CRITICAL(&OverflowMux);
+        left_ov = LeftOverflow;
+        right_ov = RightOverflow;
+        (void)pcnt_get_counter_value(LeftUnit, &left_cnt);
+        (void)pcnt_get_counter_value(RightUnit, &right_cnt);
+        portEXIT_CRITICAL(&OverflowMux);
+    }
+    VelObserver LeftObserver;                       // 左轮速度观测器（计数/s）
+    VelObserver RightObserver;                      // 右轮速度观测器（计数/s）
+
     bool my_pcnt_init(pcnt_unit_t unit, gpio_num_t pin_a, gpio_num_t pin_b) // 配置某个 PCNT 单元
     {
         pcnt_config_t channel_config = {};
@@ -41,7 +83,7 @@ namespace
         channel_config.lctrl_mode = PCNT_MODE_KEEP;
         channel_config.hctrl_mode = PCNT_MODE_REVERSE; 
 
-        // 设置上下限，避免硬件溢出
+        // 上下限：到达时硬件归零并产生 H_LIM / L_LIM 事件，由中断累加
         channel_config.counter_h_lim = CountLimit;  
         channel_config.counter_l_lim = -CountLimit; 
 
@@ -60,8 +102,22 @@ namespace
 
         (void)pcnt_set_filter_value(unit, FilterValue); // 设置毛刺滤波阈值
         (void)pcnt_filter_enable(unit);                  // 打开滤波单元
+        (void)pcnt_event_enable(unit, PCNT_EVT_H_LIM);   // 上溢事件
+        (void)pcnt_event_enable(unit, PCNT_EVT_L_LIM);   // 下溢事件
         (void)pcnt_counter_pause(unit);                  // 暂停计数器以确保清零
-        (void)pcnt_counter_clear(unit);                  // 将当前计数清零
+        (void)pcnt_counter_clear(unit);                  // 将当前计数清零（仅初始化时，运行中从不清零）
+        if (!isr_ready)
+        {
+            // 首次：中断服务已安装（ESP_ERR_INVALID_STATE）也视为成功
+            const esp_err_t isr_ret = pcnt_isr_service_install(0);
+            if (isr_ret != ESP_OK && isr_ret != ESP_ERR_INVALID_STATE)
+            {
+                Serial.printf("[ENC] pcnt_isr_service_install failed (%d)\n", isr_ret);
+                return false;
+            }
+        }
+        (void)pcnt_isr_handler_remove(unit); // 重复初始化时先移除旧回调
+        (void)pcnt_isr_handler_add(unit, pcnt_overflow_isr, reinterpret_cast<void *>(static_cast<intptr_t>(unit)));
         (void)pcnt_counter_resume(unit);                 // 重新启动计数器 
         return true;
     }
@@ -76,15 +132,29 @@ void my_encoder_init()
 
     const bool left_ok = my_pcnt_init(LeftUnit, ENCODER_B1A_PIN, ENCODER_B1B_PIN);
     const bool right_ok = my_pcnt_init(RightUnit, ENCODER_B2A_PIN, ENCODER_B2B_PIN);
+    isr_ready = left_ok && right_ok;
+
+    portENTER_CRITICAL(&OverflowMux);
+    LeftOverflow = 0;
+    RightOverflow = 0;
+    portEXIT_CRITICAL(&OverflowMux);
+    LeftAccum.limit = CountLimit;
+    RightAccum.limit = CountLimit;
+    LeftAccum.reset(0, 0);
+    RightAccum.reset(0, 0);
 
     Encoder_Left_Delta = 0;  // 清零左轮增量缓存
     Encoder_Right_Delta = 0; // 清零右轮增量缓存
     LeftTotalCount = 0;
     RightTotalCount = 0;
+    LeftObserver.configure(ENCODER_OBS_ACCEL / RadPerCount, robot.dt_ms * 0.001f);
+    RightObserver.configure(ENCODER_OBS_ACCEL / RadPerCount, robot.dt_ms * 0.001f);
+    LeftObserver.reset(0);
+    RightObserver.reset(0);
     encoder_ready = left_ok && right_ok;    
 }
 
-// 刷新并清零编码器计数
+// 读取累计计数，增量 = 本拍累计 - 上拍累计（硬件计数器不清零，读与清之间不会丢脉冲）
 void my_encoder_update() 
 { 
     if (!encoder_ready)
@@ -92,19 +162,21 @@ void my_encoder_update()
         return; 
     } 
 
-    int16_t left_count = 0;  // 临时变量存储左轮读数
-    int16_t right_count = 0; // 临时变量存储右轮读数
-    (void)pcnt_get_counter_value(LeftUnit, &left_count);   
-    (void)pcnt_get_counter_value(RightUnit, &right_count); 
-    LeftTotalCount += left_count;
-    RightTotalCount += right_count;
-
-    Encoder_Left_Delta = left_count;
-    Encoder_Right_Delta = right_count; 
-
-    (void)pcnt_counter_clear(LeftUnit);
-    (void)pcnt_counter_clear(RightUnit); 
-    const float dt_s = robot.dt_ms * 0.001f;
+    int64_t left_ov = 0, right_ov = 0;
+    int16_t left_count = 0, right_count = 0;
+    read_counts(left_ov, left_count, right_ov, right_count);
+    const int64_t left_total = LeftAccum.update(left_ov, left_count);
+    const int64_t right_total = RightAccum.update(right_ov, right_count);
+
+    Encoder_Left_Delta = static_cast<int32_t>(left_total - LeftTotalCount);
+    Encoder_Right_Delta = static_cast<int32_t>(right_total - RightTotalCount);
+    LeftTotalCount = left_total;
+    RightTotalCount = right_total;
+    const float dt_s = robot.tick.dt; // 实测周期，避免节拍抖动变成速度噪声
+#if ENCODER_VEL_OBSERVER
+    robot.wel.spd1 = LeftObserver.update(LeftTotalCount, dt_s) * RadPerCount;
+    robot.wel.spd2 = RightObserver.update(RightTotalCount, dt_s) * RadPerCount;
+#else
     if (dt_s > 0.0f)
     {
         robot.wel.spd1 = static_cast<float>(Encoder_Left_Delta) * RadPerCount / dt_s;
@@ -115,6 +187,7 @@ void my_encoder_update()
         robot.wel.spd1 = 0.0f;
         robot.wel.spd2 = 0.0f;
     }
+#endif
 
     robot.wel.pos1 = static_cast<float>(LeftTotalCount) * RadPerCount;
     robot.wel.pos2 = static_cast<float>(RightTotalCount) * RadPerCount;
@@ -3,130 +3,438 @@
 #include "my_config.h"
 #include "my_encoder.h"
 #include "my_motion.h"
+#include "my_sched.h"
+#include "my_perf.h"
+#include "my_duty_map.h"
+#include "my_deadzone_cal.h"
+#include "my_params.h"
+#include <atomic>
+#if !MOTOR_OUTPUT_LEGACY
+#include "soc/gpio_reg.h"
+#include "soc/soc.h"
+#if MOTOR_PWM_BACKEND == MOTOR_PWM_MCPWM
+#include "driver/mcpwm.h"
+#endif
+#endif
 
 volatile float motor_left_u = 0.0f;
 volatile float motor_right_u = 0.0f;
 
 namespace
 {
-    enum class MotorSide
+    enum class MotorSide : uint8_t
     {
-        Left,
-        Right
+        Left = 0,
+        Right = 1
     };
 
-    enum class MotorState
+    enum class MotorState : uint8_t
     {
         Brake = 0,
         Forward,
-        Reverse
+        Reverse,
+        Unknown // 缓存初值，保证首次一定写出
     };
 
-    // LEDC 通道分配
-    constexpr uint8_t LEFT_PWM_CH = 0;
-    constexpr uint8_t RIGHT_PWM_CH = 1;
-    constexpr float CALI_STEP = 0.05f;   // 起转测试步长（占空比）
-    constexpr uint32_t CALI_DELAY_MS = 40; // 每档等待时间
+    // 起转死区占空比（按 motor_curve_index：左正/左反/右正/右反），运行中用于补偿
+    float start_duties[MOTOR_CURVE_COUNT] = {0.1f, 0.1f, 0.1f, 0.1f};
 
-    // 起转死区占空比（正向/反向），运行中用于补偿
-    float left_forward_start = 0.1f;
-    float left_reverse_start = 0.1f;
-    float right_forward_start = 0.1f;
-    float right_reverse_start = 0.1f;
+    // 输出缓存：方向与占空比只在变化时写硬件
+    MotorState dir_cache[2] = {MotorState::Unknown, MotorState::Unknown};
+    float duty_cache[2] = {-1.0f, -1.0f};
+    motor_out_stats out_stats = {};
 
     bool is_left_side(MotorSide side)
     {
         return side == MotorSide::Left;
     }
 
-    // 设置方向：正转/反转/制动
-    void set_dir(MotorSide side, MotorState state)
+#if MOTOR_OUTPUT_LEGACY
+    // 改造前写法：每拍两次 digitalWrite + ledcWrite（固定 LEDC，忽略 MOTOR_PWM_BACKEND），仅用于对比耗时
+    constexpr uint8_t LEFT_PWM_CH = 0;
+    constexpr uint8_t RIGHT_PWM_CH = 1;
+
+    void pwm_init()
+    {
+        ledcSetup(LEFT_PWM_CH, PWM_FREQ, PWM_RESOLUTION);
+        ledcSetup(RIGHT_PWM_CH, PWM_FREQ, PWM_RESOLUTION);
+        ledcAttachPin(MOTOR_A_PWM_PIN, LEFT_PWM_CH);
+        ledcAttachPin(MOTOR_B_PWM_PIN, RIGHT_PWM_CH);
+    }
+
+    void write_dir(MotorSide side, MotorState state)
     {
         const int in1 = is_left_side(side) ? MOTOR_A_IN1_PIN : MOTOR_B_IN1_PIN;
         const int in2 = is_left_side(side) ? MOTOR_A_IN2_PIN : MOTOR_B_IN2_PIN;
-        switch (state)
-        {
-        case MotorState::Forward:
-            digitalWrite(in1, HIGH);
-            digitalWrite(in2, LOW);
-            break;
-        case MotorState::Reverse:
-            digitalWrite(in1, LOW);
-            digitalWrite(in2, HIGH);
-            break;
-        case MotorState::Brake:
-        default:
-            digitalWrite(in1, LOW);
-            digitalWrite(in2, LOW); // 悬空/滑行
-            break;
-        }
+        digitalWrite(in1, state == MotorState::Forward ? HIGH : LOW);
+        digitalWrite(in2, state == MotorState::Reverse ? HIGH : LOW); // 制动：两路均低（悬空/滑行）
     }
 
-    void write_pwm(MotorSide side, float duty)
+    void write_duty(MotorSide side, float duty)
     {
-        duty = constrain(duty, 0.0f, 1.0f);
         const uint32_t counts = static_cast<uint32_t>(duty * static_cast<float>(MAX_DUTY));
         ledcWrite(is_left_side(side) ? LEFT_PWM_CH : RIGHT_PWM_CH, counts);
     }
 
-    // 逐级递增占空比，检测到编码器有脉冲即返回当前占空比
-    float calibrate_duty(MotorSide side, MotorState state)
+    void apply_outputs(const MotorState (&state)[2], const float (&duty)[2])
     {
-        // 设定方向
-        set_dir(side, state);
-
-        // 清零编码器
-        my_encoder_update();
-        float duty = CALI_STEP;
-        while (duty <= 1.0f)
+        for (uint8_t i = 0; i < 2; ++i)
         {
-            write_pwm(side, duty);
+            write_dir(static_cast<MotorSide>(i), state[i]);
+            write_duty(static_cast<MotorSide>(i), duty[i]);
+            dir_cache[i] = state[i];
+            duty_cache[i] = duty[i];
+        }
+        out_stats.dir_writes += 2;
+        out_stats.duty_writes += 2;
+    }
+#else
+    // 方向脚直接写 GPIO_OUT_W1TS/W1TC 寄存器（只覆盖 GPIO0~31）
+    static_assert(MOTOR_A_IN1_PIN < 32 && MOTOR_A_IN2_PIN < 32 && MOTOR_B_IN1_PIN < 32 && MOTOR_B_IN2_PIN < 32,
+                  "方向引脚须在 GPIO0~31");
+    constexpr uint32_t IN1_MASK[2] = {1UL << MOTOR_A_IN1_PIN, 1UL << MOTOR_B_IN1_PIN};
+    constexpr uint32_t IN2_MASK[2] = {1UL << MOTOR_A_IN2_PIN, 1UL << MOTOR_B_IN2_PIN};
 
-            delay(CALI_DELAY_MS);
-            my_encoder_update(); // 读出增量
+#if MOTOR_PWM_BACKEND == MOTOR_PWM_MCPWM
+    constexpr float PwmHz = MCPWM_FREQ;
+#else
+    constexpr float PwmHz = PWM_FREQ;
+#endif
+    // 驱动死区按占空比计与 PWM 频率成正比：300ns 在 5kHz 约 0.15%，20kHz 约 0.6%。非零脉冲加上这段，
+    // 起转死区与实测曲线就不随后端/频率变化；0 仍为 0（滑行），满占空比不变
+    constexpr float PwmDeadDuty = MOTOR_DEADTIME_NS * 1e-9f * PwmHz;
 
-            const int32_t delta = is_left_side(side) ? Encoder_Left_Delta : Encoder_Right_Delta;
-            if (abs(delta) > 0)
-            {
-                // 一旦检测到有转动，立即停转并返回当前 duty
-                write_pwm(side, 0.0f);
-                set_dir(side, MotorState::Brake);
-                return duty;
-            }
+    float pulse_duty(float duty)
+    {
+        return duty > 0.0f ? fminf(duty + PwmDeadDuty, 1.0f) : 0.0f;
+    }
+
+#if MOTOR_PWM_BACKEND == MOTOR_PWM_MCPWM
+    // 左右共用 MCPWM0 的一个定时器：A 路左轮、B 路右轮。增减计数（中心对齐），
+    // 比较值写入影子寄存器，计数归零（TEZ）时两路一起生效，两侧新占空比落在同一个 PWM 周期
+    constexpr mcpwm_unit_t PwmUnit = MCPWM_UNIT_0;
+    constexpr mcpwm_timer_t PwmTimer = MCPWM_TIMER_0;
+    // 增减计数一个周期走两遍计数范围。分辨率须在 mcpwm_init() 之前设置，否则定时器按驱动默认的 1MHz 计数，
+    // 20kHz 下每周期只剩 25 级
+    constexpr uint32_t PwmSteps = MCPWM_RESOLUTION_HZ / (2UL * MCPWM_FREQ);
+    static_assert(PwmSteps >= 1000, "MCPWM 每周期至少 1000 级，须提高 MCPWM_RESOLUTION_HZ 或降低 MCPWM_FREQ");
+
+    void pwm_init()
+    {
+        mcpwm_group_set_resolution(PwmUnit, MCPWM_RESOLUTION_HZ);
+        mcpwm_timer_set_resolution(PwmUnit, PwmTimer, MCPWM_RESOLUTION_HZ);
+        mcpwm_gpio_init(PwmUnit, MCPWM0A, MOTOR_A_PWM_PIN);
+        mcpwm_gpio_init(PwmUnit, MCPWM0B, MOTOR_B_PWM_PIN);
+        mcpwm_config_t cfg = {};
+        cfg.frequency = MCPWM_FREQ;
+        cfg.cmpr_a = 0.0f;
+        cfg.cmpr_b = 0.0f;
+        cfg.counter_mode = MCPWM_UP_DOWN_COUNTER;
+        cfg.duty_mode = MCPWM_DUTY_MODE_0; // 高电平有效
+        mcpwm_init(PwmUnit, PwmTimer, &cfg);
+        Serial.printf("[MOTOR] MCPWM %u Hz center-aligned, %u steps\n",
+                      static_cast<unsigned>(mcpwm_get_frequency(PwmUnit, PwmTimer)), static_cast<unsigned>(PwmSteps));
+    }
+
+    void pwm_write(uint8_t i, float duty)
+    {
+        mcpwm_set_duty(PwmUnit, PwmTimer, i == 0 ? MCPWM_GEN_A : MCPWM_GEN_B, pulse_duty(duty) * 100.0f);
+    }
+#else
+    // LEDC：两通道分别写入，各自在本通道周期结束时生效
+    constexpr uint8_t LEFT_PWM_CH = 0;
+    constexpr uint8_t RIGHT_PWM_CH = 1;
+
+    void pwm_init()
+    {
+        ledcSetup(LEFT_PWM_CH, PWM_FREQ, PWM_RESOLUTION);
+        ledcSetup(RIGHT_PWM_CH, PWM_FREQ, PWM_RESOLUTION);
+        ledcAttachPin(MOTOR_A_PWM_PIN, LEFT_PWM_CH);
+        ledcAttachPin(MOTOR_B_PWM_PIN, RIGHT_PWM_CH);
+    }
+
+    void pwm_write(uint8_t i, float duty)
+    {
+        ledcWrite(i == 0 ? LEFT_PWM_CH : RIGHT_PWM_CH, static_cast<uint32_t>(pulse_duty(duty) * static_cast<float>(MAX_DUTY)));
+    }
+#endif
+
+    void apply_outputs(const MotorState (&state)[2], const float (&duty)[2])
+    {
+        // 两侧方向合并成一次清零 + 一次置位；先清后置，切换方向时经过滑行态
+        uint32_t set = 0, clr = 0;
+        for (uint8_t i = 0; i < 2; ++i)
+        {
+            if (state[i] == dir_cache[i])
+                continue;
+            dir_cache[i] = state[i];
+            ++out_stats.dir_writes;
+            clr |= (state[i] == MotorState::Forward ? 0 : IN1_MASK[i]) | (state[i] == MotorState::Reverse ? 0 : IN2_MASK[i]);
+            set |= (state[i] == MotorState::Forward ? IN1_MASK[i] : 0) | (state[i] == MotorState::Reverse ? IN2_MASK[i] : 0);
+        }
+        if (clr)
+            REG_WRITE(GPIO_OUT_W1TC_REG, clr);
+        if (set)
+            REG_WRITE(GPIO_OUT_W1TS_REG, set);
 
-            duty += CALI_STEP;
+        for (uint8_t i = 0; i < 2; ++i)
+        {
+            if (duty[i] == duty_cache[i])
+                continue;
+            duty_cache[i] = duty[i];
+            ++out_stats.duty_writes;
+            pwm_write(i, duty[i]);
         }
+    }
+#endif
 
-        // 没检测到脉冲，则返回最大值，防止后续补偿时超限
-        write_pwm(side, 0.0f);
-        set_dir(side, MotorState::Brake);
-        return 1.0f;
+    uint8_t curve_index(MotorSide side, bool forward)
+    {
+        return (is_left_side(side) ? MOTOR_CURVE_L_FWD : MOTOR_CURVE_R_FWD) + (forward ? 0 : 1);
     }
 
-    // 施加死区补偿并输出 PWM，返回实际写入的占空比（带符号）
-    float drive_motor(MotorSide side, float cmd)
+    float start_duty(uint8_t curve)
+    {
+        return start_duties[curve];
+    }
+
+    void publish_deadzone()
+    {
+        robot.motor.L_deadzone_fwd = start_duties[MOTOR_CURVE_L_FWD];
+        robot.motor.L_deadzone_rev = start_duties[MOTOR_CURVE_L_REV];
+        robot.motor.R_deadzone_fwd = start_duties[MOTOR_CURVE_R_FWD];
+        robot.motor.R_deadzone_rev = start_duties[MOTOR_CURVE_R_REV];
+    }
+
+    // 施加死区与电压补偿，得到方向与占空比（不写硬件），返回带符号占空比
+    float command_to_duty(MotorSide side, float cmd, MotorState &state, float &duty)
     {
         cmd = constrain(cmd, -1.0f, 1.0f);
         if (abs(cmd) < 1e-5f)
         {
             // 停车
-            set_dir(side, MotorState::Brake);
-            write_pwm(side, 0.0f);
+            state = MotorState::Brake;
+            duty = 0.0f;
             return 0.0f;
         }
 
         const bool forward = cmd > 0;
         const float mag = abs(cmd);
-        const float start = forward
-                                ? (is_left_side(side) ? left_forward_start : right_forward_start)
-                                : (is_left_side(side) ? left_reverse_start : right_reverse_start);
-        const float duty = start + (1.0f - start) * mag;
-
-        // 设置方向与 PWM
-        set_dir(side, forward ? MotorState::Forward : MotorState::Reverse);
-        write_pwm(side, duty);
+        const uint8_t curve = curve_index(side, forward);
+        const motor_map_config &map = robot.motor_map;
+        float base;
+        if (map.enable && ctl::duty_map_valid(map.duty[curve], map.speed[curve]))
+            base = ctl::duty_map(map.duty[curve], map.speed[curve], mag); // 实测曲线：指令正比于空载轮速
+        else
+            base = start_duty(curve) + (1.0f - start_duty(curve)) * mag; // 起转占空比 + 直线
+        // 指令按标称电压定义：电池电压下降时按 v_nom / v_bat 放大（死区与曲线同样在标称电压附近测得）
+        duty = fminf(base * sched_vcomp, 1.0f);
+        state = forward ? MotorState::Forward : MotorState::Reverse;
         return forward ? duty : -duty;
     }
+
+    // 死区标定：未运行时在控制任务中逐拍推进，不阻塞启动（状态机见 lib/MY_MOTOR_LIB/my_deadzone_cal.h）
+    DeadzoneCal cal({MOTOR_DZ_MAX, MOTOR_DZ_ITERS, MOTOR_DZ_PROBE_MS, MOTOR_DZ_REST_MS, MOTOR_DZ_MOVE_COUNTS,
+                     MOTOR_DZ_VERIFY_MARGIN}); // 仅控制任务访问
+
+    std::atomic<uint8_t> cal_phase{static_cast<uint8_t>(DzPhase::Pending)}; // 控制任务发布给网络任务
+    std::atomic<bool> cal_request{false};      // 网页要求重新标定
+    std::atomic<bool> cal_save_pending{false}; // 标定完成，待低优先级任务写 NVS
+    std::atomic<bool> cal_loaded{false};       // NVS 中有标定值
+
+    uint32_t cal_now_ms()
+    {
+        return robot.tick.count * static_cast<uint32_t>(robot.dt_ms);
+    }
+
+    void cal_finish(bool ok)
+    {
+        for (uint8_t c = 0; c < MOTOR_CURVE_COUNT; ++c)
+            start_duties[c] = cal.result()[c];
+        publish_deadzone();
+        if (ok)
+            cal_save_pending.store(true, std::memory_order_release);
+        Serial.printf("[MOTOR] 死区标定%s: L %.3f/%.3f R %.3f/%.3f\n", ok ? "完成" : "失败（未检测到转动）",
+                      start_duties[MOTOR_CURVE_L_FWD], start_duties[MOTOR_CURVE_L_REV], start_duties[MOTOR_CURVE_R_FWD],
+                      start_duties[MOTOR_CURVE_R_REV]);
+    }
+
+    // 标定进行中返回 true 并给出本拍输出（不经映射与电压补偿）；运行平衡时暂停，停下后从当前轮重新开始
+    bool cal_update(MotorState (&state)[2], float (&duty)[2])
+    {
+        const uint32_t now_ms = cal_now_ms();
+        if (cal_request.exchange(false))
+            cal.begin(DzPhase::Search, now_ms);
+        if (cal.phase() == DzPhase::Pending)
+        {
+            const bool loaded = cal_loaded.load();
+            cal.begin(loaded && MOTOR_DZ_VERIFY ? DzPhase::Verify : (loaded ? DzPhase::Done : DzPhase::Search), now_ms);
+        }
+
+        const uint32_t delta[2] = {static_cast<uint32_t>(abs(Encoder_Left_Delta)), static_cast<uint32_t>(abs(Encoder_Right_Delta))};
+        const bool active = cal.update(now_ms, robot.run, delta, start_duties, duty);
+        switch (cal.event())
+        {
+        case DzEvent::VerifyMismatch:
+            Serial.println("[MOTOR] 死区校验不符，重新标定");
+            break;
+        case DzEvent::VerifyPassed:
+            Serial.println("[MOTOR] 死区校验通过");
+            break;
+        case DzEvent::Done:
+        case DzEvent::Failed:
+            cal_finish(cal.event() == DzEvent::Done);
+            break;
+        default:
+            break;
+        }
+        cal_phase.store(static_cast<uint8_t>(cal.phase()), std::memory_order_release);
+        if (!active)
+            return false;
+        const MotorState dir = cal.forward() ? MotorState::Forward : MotorState::Reverse;
+        state[0] = state[1] = cal.probing() ? dir : MotorState::Brake;
+        return true;
+    }
+
+    // 曲线测量：网络任务置请求，控制任务在 my_motor_update() 中推进，状态经原子量发布
+    std::atomic<uint8_t> map_start_request{0};
+    std::atomic<bool> map_abort_request{false};
+    std::atomic<uint8_t> map_state{MM_IDLE};
+    std::atomic<uint8_t> map_point{0};
+    std::atomic<const char *> map_error{nullptr};
+
+    // 以下仅控制任务访问
+    uint8_t sweep_dir = 0;      // 0 正向，1 反向
+    uint8_t sweep_k = 0;        // 当前点
+    bool sweep_coast = false;   // 正反向之间滑行停转
+    bool sweep_latched = false; // 已记下测量窗口起点
+    uint32_t sweep_tick = 0;    // 进入当前阶段的节拍
+    float sweep_pos[2] = {};
+    motor_map_config sweep_map = {};
+
+    uint32_t sweep_ms(uint32_t since)
+    {
+        return (robot.tick.count - since) * static_cast<uint32_t>(robot.dt_ms);
+    }
+
+    void sweep_fail(const char *why)
+    {
+        map_error.store(why);
+        map_state.store(MM_FAILED, std::memory_order_release);
+        Serial.printf("[MOTOR] 曲线测量失败：%s\n", why);
+    }
+
+    void sweep_finish()
+    {
+        for (uint8_t c = 0; c < MOTOR_CURVE_COUNT; ++c)
+        {
+            // 低速段测量噪声可能使轮速回落，按单调不减修正
+            for (uint8_t k = 1; k < MOTOR_MAP_POINTS; ++k)
+                sweep_map.speed[c][k] = fmaxf(sweep_map.speed[c][k], sweep_map.speed[c][k - 1]);
+            if (sweep_map.speed[c][MOTOR_MAP_POINTS - 1] < MOTOR_MAP_MIN_SPEED)
+            {
+                sweep_fail("车轮未转动（请架空车轮并接电池）");
+                return;
+            }
+        }
+        sweep_map.enable = 1;
+        robot.motor_map = sweep_map;
+        map_state.store(MM_DONE, std::memory_order_release);
+        for (uint8_t c = 0; c < MOTOR_CURVE_COUNT; ++c)
+        {
+            Serial.printf("[MOTOR] curve %u:", c);
+            for (uint8_t k = 0; k < MOTOR_MAP_POINTS; ++k)
+                Serial.printf(" %.3f/%.1f", sweep_map.duty[c][k], sweep_map.speed[c][k]);
+            Serial.println();
+        }
+    }
+
+    // 测量进行中返回 true 并给出本拍输出（不经映射与电压补偿）
+    bool sweep_update(MotorState (&state)[2], float (&duty)[2])
+    {
+        if (map_abort_request.exchange(false) && map_state.load() == MM_RUNNING)
+            sweep_fail("已取消");
+        if (map_start_request.exchange(0))
+        {
+            const DzPhase phase = cal.phase();
+            if (phase != DzPhase::Done)
+            {
+                sweep_fail(phase == DzPhase::Failed ? "死区标定失败" : "死区标定尚未完成");
+                return false;
+            }
+            sweep_dir = 0;
+            sweep_k = 0;
+            sweep_coast = false;
+            sweep_latched = false;
+            sweep_tick = robot.tick.count;
+            sweep_map = {};
+            map_error.store(nullptr);
+            map_point.store(0);
+            map_state.store(MM_RUNNING, std::memory_order_release);
+        }
+        if (map_state.load(std::memory_order_relaxed) != MM_RUNNING)
+            return false;
+        if (robot.run)
+        {
+            sweep_fail("测量期间不能启动平衡");
+            return false;
+        }
+
+        state[0] = state[1] = MotorState::Brake;
+        duty[0] = duty[1] = 0.0f;
+        if (sweep_coast)
+        {
+            if (sweep_ms(sweep_tick) >= MOTOR_MAP_COAST_MS)
+            {
+                sweep_coast = false;
+                sweep_tick = robot.tick.count;
+            }
+            return true;
+        }
+
+        const bool forward = sweep_dir == 0;
+        const float pos[2] = {robot.wel.pos1, robot.wel.pos2};
+        for (uint8_t i = 0; i < 2; ++i)
+        {
+            const uint8_t c = curve_index(static_cast<MotorSide>(i), forward);
+            const float start = start_duty(c);
+            sweep_map.duty[c][sweep_k] = start + (1.0f - start) * sweep_k / (MOTOR_MAP_POINTS - 1);
+            state[i] = forward ? MotorState::Forward : MotorState::Reverse;
+            duty[i] = sweep_map.duty[c][sweep_k];
+        }
+
+        if (!sweep_latched && sweep_ms(sweep_tick) >= MOTOR_MAP_SETTLE_MS)
+        {
+            sweep_latched = true;
+            sweep_tick = robot.tick.count;
+            sweep_pos[0] = pos[0];
+            sweep_pos[1] = pos[1];
+        }
+        else if (sweep_latched && sweep_ms(sweep_tick) >= MOTOR_MAP_MEASURE_MS)
+        {
+            const float window_s = sweep_ms(sweep_tick) * 0.001f;
+            for (uint8_t i = 0; i < 2; ++i)
+                sweep_map.speed[curve_index(static_cast<MotorSide>(i), forward)][sweep_k] = fabsf(pos[i] - sweep_pos[i]) / window_s;
+            map_point.store(map_point.load() + 1);
+            sweep_latched = false;
+            sweep_tick = robot.tick.count;
+            if (++sweep_k >= MOTOR_MAP_POINTS)
+            {
+                sweep_k = 0;
+                if (++sweep_dir >= 2)
+                {
+                    sweep_finish();
+                    state[0] = state[1] = MotorState::Brake;
+                    duty[0] = duty[1] = 0.0f;
+                    return true;
+                }
+                sweep_coast = true;
+                state[0] = state[1] = MotorState::Brake;
+                duty[0] = duty[1] = 0.0f;
+            }
+        }
+        return true;
+    }
 }
 
 void my_motor_init()
@@ -137,36 +445,25 @@ void my_motor_init()
     pinMode(MOTOR_B_IN1_PIN, OUTPUT);
     pinMode(MOTOR_B_IN2_PIN, OUTPUT);
 
-    // PWM 配置
-    ledcSetup(LEFT_PWM_CH, PWM_FREQ, PWM_RESOLUTION);
-    ledcSetup(RIGHT_PWM_CH, PWM_FREQ, PWM_RESOLUTION);
-    ledcAttachPin(MOTOR_A_PWM_PIN, LEFT_PWM_CH);
-    ledcAttachPin(MOTOR_B_PWM_PIN, RIGHT_PWM_CH);
+    // PWM 配置，输出为 0
+    pwm_init();
+    dir_cache[0] = dir_cache[1] = MotorState::Unknown;
+    duty_cache[0] = duty_cache[1] = -1.0f;
+    const MotorState brake[2] = {MotorState::Brake, MotorState::Brake};
+    const float zero[2] = {0.0f, 0.0f};
+    apply_outputs(brake, zero);
 
     // 确保编码器可用并清零
     my_encoder_init();
-    my_encoder_update();
 
-    // 起转死区校准：左/右轮正反向
-    left_forward_start = calibrate_duty(MotorSide::Left, MotorState::Forward);
-    left_reverse_start = calibrate_duty(MotorSide::Left, MotorState::Reverse);
-    right_forward_start = calibrate_duty(MotorSide::Right, MotorState::Forward);
-    right_reverse_start = calibrate_duty(MotorSide::Right, MotorState::Reverse);
-
-    // 记录死区占空比，方便遥测查看
-    robot.motor.L_deadzone_fwd = left_forward_start;
-    robot.motor.L_deadzone_rev = left_reverse_start;
-    robot.motor.R_deadzone_fwd = right_forward_start;
-    robot.motor.R_deadzone_rev = right_reverse_start;
-
-    // 校准后重置编码器计数，避免位置有偏移
-    my_encoder_init();
-
-    // 初始化输出为 0
-    set_dir(MotorSide::Left, MotorState::Brake);
-    set_dir(MotorSide::Right, MotorState::Brake);
-    write_pwm(MotorSide::Left, 0.0f);
-    write_pwm(MotorSide::Right, 0.0f);
+    // 起转死区：NVS 中有标定值则立即使用（控制任务启动后按 MOTOR_DZ_VERIFY 快速校验），否则后台标定
+    cal_loaded.store(my_params_load_deadzone(start_duties));
+    publish_deadzone();
+    cal.begin(DzPhase::Pending, 0);
+    cal_phase.store(static_cast<uint8_t>(DzPhase::Pending));
+    Serial.printf("[MOTOR] 死区%s: L %.3f/%.3f R %.3f/%.3f\n", cal_loaded.load() ? "（NVS）" : "（默认，待标定）",
+                  start_duties[MOTOR_CURVE_L_FWD], start_duties[MOTOR_CURVE_L_REV], start_duties[MOTOR_CURVE_R_FWD],
+                  start_duties[MOTOR_CURVE_R_REV]);
 
     motor_left_u = 0.0f;
     motor_right_u = 0.0f;
@@ -174,17 +471,102 @@ void my_motor_init()
     robot.motor.R_duty = 0.0f;
     robot.motor.L_cmd = 0.0f;
     robot.motor.R_cmd = 0.0f;
+    out_stats = {};
 }
 
 void my_motor_update()
 {
-    // 读取指令并驱动，两侧互不干扰
+    // 读取指令，两侧先算好再一起写出
     robot.motor.L_cmd = motor_left_u;
     robot.motor.R_cmd = motor_right_u;
-    const float left_applied = drive_motor(MotorSide::Left, motor_left_u);
-    const float right_applied = drive_motor(MotorSide::Right, motor_right_u);
+    MotorState state[2];
+    float duty[2];
+    float left_applied, right_applied;
+    if (cal_update(state, duty) || sweep_update(state, duty))
+    {
+        // 死区标定 / 曲线测量接管输出（未运行时控制指令本为 0）
+        left_applied = state[0] == MotorState::Reverse ? -duty[0] : duty[0];
+        right_applied = state[1] == MotorState::Reverse ? -duty[1] : duty[1];
+    }
+    else
+    {
+        left_applied = command_to_duty(MotorSide::Left, robot.motor.L_cmd, state[0], duty[0]);
+        right_applied = command_to_duty(MotorSide::Right, robot.motor.R_cmd, state[1], duty[1]);
+    }
+
+    const uint32_t t0 = my_perf_now();
+    apply_outputs(state, duty);
+    const uint32_t cycles = my_perf_now() - t0;
+    out_stats.updates++;
+    out_stats.cycles_last = cycles;
+    out_stats.cycles_sum += cycles;
+    if (cycles > out_stats.cycles_max)
+        out_stats.cycles_max = cycles;
 
     // 存入全局状态，便于监控/上报
     robot.motor.L_duty = left_applied;
     robot.motor.R_duty = right_applied;
 }
+
+const motor_out_stats &my_motor_stats()
+{
+    return out_stats;
+}
+
+void my_motor_map_measure()
+{
+    map_abort_request.store(false);
+    map_start_request.store(1, std::memory_order_release);
+}
+
+void my_motor_map_abort()
+{
+    map_abort_request.store(true, std::memory_order_release);
+}
+
+void my_motor_map_status(motor_map_status &out)
+{
+    out.state = static_cast<motor_map_state>(map_state.load(std::memory_order_acquire));
+    out.point = map_point.load();
+    out.points_total = 2 * MOTOR_MAP_POINTS;
+    out.error = map_error.load();
+}
+
+const char *my_motor_map_state_name(motor_map_state s)
+{
+    static const char *const Names[] = {"idle", "running", "done", "failed"};
+    return s <= MM_FAILED ? Names[s] : "?";
+}
+
+const char *my_motor_pwm_backend_name()
+{
+#if MOTOR_OUTPUT_LEGACY || MOTOR_PWM_BACKEND == MOTOR_PWM_LEDC
+    return "ledc";
+#else
+    return "mcpwm";
+#endif
+}
+
+void my_motor_calibrate()
+{
+    cal_request.store(true, std::memory_order_release);
+}
+
+void my_motor_cal_status(motor_cal_status &out)
+{
+    static const char *const Names[] = {"pending", "verify", "search", "done", "failed"};
+    const uint8_t phase = cal_phase.load(std::memory_order_acquire);
+    out.state = phase < 5 ? Names[phase] : "?";
+    out.loaded = cal_loaded.load();
+    out.active = phase == static_cast<uint8_t>(DzPhase::Verify) || phase == static_cast<uint8_t>(DzPhase::Search);
+}
+
+void my_motor_service()
+{
+    if (!cal_save_pending.exchange(false))
+        return;
+    float dz[MOTOR_CURVE_COUNT] = {robot.motor.L_deadzone_fwd, robot.motor.L_deadzone_rev, robot.motor.R_deadzone_fwd,
+                                   robot.motor.R_deadzone_rev};
+    if (my_params_save_deadzone(dz))
+        cal_loaded.store(true);
+}
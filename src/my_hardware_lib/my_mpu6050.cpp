@@ -1,9 +1,265 @@
 #include "my_motion.h"
 #include "my_mpu6050.h"
+#include "my_seqlock.h"
+#include "my_attitude.h"
 #include "Arduino.h"
+#include <MPU6050_tockn.h>
+#include <atomic>
 
 
-MPU6050 mpu6050 = MPU6050(Wire);
+MPU6050 mpu6050 = MPU6050(Wire); // MPU6050实例
+static AttitudeEstimator &attitude = my_attitude_estimator(static_cast<AttitudeMode>(ATTITUDE_ESTIMATOR));
+
+#if MPU6050_ASYNC
+// 异步模式：MPU6050 以 MPU6050_SAMPLE_RATE_HZ 写片上 FIFO，INT 引脚数据就绪时唤醒采样任务，
+// 采样任务批量读出 FIFO、按采样率做姿态解算后推入无锁环形缓冲；控制任务每拍只出队，不再占用 I2C
+namespace
+{
+    // 寄存器（MPU6050_tockn.h 未定义的部分）
+    constexpr uint8_t REG_FIFO_EN = 0x23;
+    constexpr uint8_t REG_INT_PIN_CFG = 0x37;
+    constexpr uint8_t REG_INT_ENABLE = 0x38;
+    constexpr uint8_t REG_INT_STATUS = 0x3A;
+    constexpr uint8_t REG_USER_CTRL = 0x6A;
+    constexpr uint8_t REG_FIFO_COUNT_H = 0x72;
+    constexpr uint8_t REG_FIFO_R_W = 0x74;
+
+    constexpr uint8_t FIFO_EN_ACCEL_GYRO = 0x78; // XG/YG/ZG/ACCEL，不含温度
+    constexpr uint8_t USER_CTRL_FIFO_EN = 0x40;
+    constexpr uint8_t USER_CTRL_FIFO_RESET = 0x04;
+    constexpr uint8_t INT_PIN_CFG_RD_CLEAR = 0x10;   // 任意读操作清中断
+    constexpr uint8_t INT_DATA_RDY = 0x01;
+
+    constexpr uint32_t FrameBytes = 12;              // accel xyz + gyro xyz
+    constexpr uint32_t FifoSize = 1024;
+    constexpr uint32_t FramesPerRead = 10;           // Wire 缓冲 128 字节，一次最多读 10 帧
+    constexpr float GyroScale = 1.0f / 65.5f;        // ±500dps（与 MPU6050_tockn::begin 一致）
+    constexpr float AccScale = 1.0f / 16384.0f;      // ±2g
+
+    static_assert(MPU6050_SAMPLE_RATE_HZ >= 100 && MPU6050_SAMPLE_RATE_HZ <= 2000, "400kHz I2C 读 12 字节帧最多约 2kHz");
+    constexpr bool DlpfOn = MPU6050_SAMPLE_RATE_HZ <= 1000;
+    constexpr uint32_t GyroOutputHz = DlpfOn ? 1000 : 8000;
+    constexpr uint8_t SmplrtDiv = GyroOutputHz / MPU6050_SAMPLE_RATE_HZ - 1;
+    // 采样周期按实际写入的分频计算：采样率除不尽时（如 300Hz 实为 333Hz）积分步长仍与片上一致
+    constexpr float SampleDt = (SmplrtDiv + 1.0f) / GyroOutputHz;
+
+    struct imu_sample
+    {
+        uint32_t t_us;
+        float anglex, angley, anglez;
+        float gyrox, gyroy, gyroz;
+    };
+
+    lockfree::SpscQueue<imu_sample, 32> imu_ring;
+    // 控制循环开始取样本前不入队：开机期间（init 的 1s 等待、WiFi 初始化）环形缓冲不会塞满旧样本
+    std::atomic<bool> ring_open{false};
+    imu_fifo_stats stats = {};
+    TaskHandle_t sampler_handle = nullptr;
+
+    float gyro_off[3] = {0, 0, 0};
+
+    void IRAM_ATTR mpu6050_int_isr()
+    {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(sampler_handle, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+
+    bool read_regs(uint8_t reg, uint8_t *buf, uint8_t len)
+    {
+        Wire.beginTransmission(MPU6050_ADDR);
+        Wire.write(reg);
+        if (Wire.endTransmission(false) != 0)
+            return false;
+        if (Wire.requestFrom(static_cast<uint8_t>(MPU6050_ADDR), len) != len)
+            return false;
+        for (uint8_t i = 0; i < len; ++i)
+            buf[i] = Wire.read();
+        return true;
+    }
+
+    void fifo_reset()
+    {
+        mpu6050.writeMPU6050(REG_USER_CTRL, USER_CTRL_FIFO_RESET);
+        mpu6050.writeMPU6050(REG_USER_CTRL, USER_CTRL_FIFO_EN);
+    }
+
+    void fifo_config()
+    {
+        mpu6050.writeMPU6050(MPU6050_CONFIG, DlpfOn ? 0x01 : 0x00);
+        mpu6050.writeMPU6050(MPU6050_SMPLRT_DIV, SmplrtDiv);
+        mpu6050.writeMPU6050(REG_FIFO_EN, FIFO_EN_ACCEL_GYRO);
+        mpu6050.writeMPU6050(REG_INT_PIN_CFG, INT_PIN_CFG_RD_CLEAR);
+        mpu6050.writeMPU6050(REG_INT_ENABLE, MPU6050_INT_PIN >= 0 ? INT_DATA_RDY : 0);
+        fifo_reset();
+    }
+
+    int16_t be16(const uint8_t *p)
+    {
+        return static_cast<int16_t>(p[0] << 8 | p[1]);
+    }
+
+    // 单帧换算 + 姿态解算，dt 为片上采样周期
+    void process_frame(const uint8_t *f, uint32_t t_us)
+    {
+        attitude_input in;
+        in.ax = be16(f + 0) * AccScale;
+        in.ay = be16(f + 2) * AccScale;
+        in.az = be16(f + 4) * AccScale;
+        in.gx = be16(f + 6) * GyroScale - gyro_off[0];
+        in.gy = be16(f + 8) * GyroScale - gyro_off[1];
+        in.gz = be16(f + 10) * GyroScale - gyro_off[2];
+        attitude.update(in, SampleDt);
+
+        const attitude_output &o = attitude.output();
+        const imu_sample s = {t_us, o.anglex, o.angley, o.anglez, o.gyrox, o.gyroy, o.gyroz};
+        if (ring_open.load(std::memory_order_acquire) && !imu_ring.push(s))
+            stats.ring_drop++;
+        stats.samples++;
+    }
+
+    void drain_fifo()
+    {
+        uint8_t buf[FramesPerRead * FrameBytes];
+        if (!read_regs(REG_FIFO_COUNT_H, buf, 2))
+        {
+            stats.i2c_error++;
+            return;
+        }
+        const uint32_t count = static_cast<uint32_t>(buf[0]) << 8 | buf[1];
+        // 溢出或帧错位后数据不可信，直接复位
+        if (count >= FifoSize - FrameBytes || count % FrameBytes != 0)
+        {
+            uint8_t status = 0;
+            read_regs(REG_INT_STATUS, &status, 1);
+            fifo_reset();
+            stats.fifo_overflow++;
+            return;
+        }
+        uint32_t frames = count / FrameBytes;
+        stats.last_batch = frames;
+        const uint32_t now_us = micros();
+        while (frames > 0)
+        {
+            const uint32_t n = frames > FramesPerRead ? FramesPerRead : frames;
+            if (!read_regs(REG_FIFO_R_W, buf, n * FrameBytes))
+            {
+                stats.i2c_error++;
+                fifo_reset();
+                return;
+            }
+            frames -= n;
+            // 最后一帧对应 now_us，之前的按采样周期倒推
+            for (uint32_t i = 0; i < n; ++i)
+                process_frame(buf + i * FrameBytes, now_us - static_cast<uint32_t>((frames + n - 1 - i) * SampleDt * 1e6f));
+        }
+    }
+
+    void imu_sampler_task(void *)
+    {
+        const TickType_t wait = MPU6050_INT_PIN >= 0 ? pdMS_TO_TICKS(10) : 1;
+        for (;;)
+        {
+            // 有 INT 时等中断，超时兜底；未接 INT 时每个 RTOS 节拍轮询一次
+            ulTaskNotifyTake(pdTRUE, wait);
+            drain_fifo();
+        }
+    }
+}
+
+void my_mpu6050_setzero()
+{
+    // 开机时入队尚未打开：临时打开，等到至少一个新样本再取零点，之后关闭直到控制循环开始
+    const bool was_open = ring_open.exchange(true);
+    const uint32_t before = stats.samples;
+    for (int i = 0; i < 50 && stats.samples == before; ++i)
+        delay(1);
+    my_mpu6050_update();
+    robot.imu_zero = robot.imu;
+    if (!was_open)
+        ring_open.store(false);
+}
+
+void my_mpu6050_init()
+{
+    mpu6050.begin();
+    mpu6050.calcGyroOffsets(true);
+    gyro_off[0] = mpu6050.getGyroXoffset();
+    gyro_off[1] = mpu6050.getGyroYoffset();
+    gyro_off[2] = mpu6050.getGyroZoffset();
+    mpu6050.update();
+    attitude.reset({mpu6050.getAccX(), mpu6050.getAccY(), mpu6050.getAccZ(), 0.0f, 0.0f, 0.0f});
+
+    fifo_config();
+    xTaskCreatePinnedToCore(imu_sampler_task, "imu", 4096, nullptr, 12, &sampler_handle, 1);
+    if (MPU6050_INT_PIN >= 0)
+    {
+        pinMode(MPU6050_INT_PIN, INPUT);
+        attachInterrupt(digitalPinToInterrupt(MPU6050_INT_PIN), mpu6050_int_isr, RISING);
+    }
+    Serial.printf("MPU6050初始化完成（FIFO %.0fHz, INT=%d, %s）\n", 1.0f / SampleDt, MPU6050_INT_PIN, attitude.name());
+    delay(1000);
+    my_mpu6050_setzero();
+    Serial.println("MPU6050初始状态设置完毕");
+}
+
+// 控制任务调用：取出上一拍以来的全部样本，角度取最新值，角速度取平均（抽取前的均值滤波）
+void my_mpu6050_update()
+{
+    robot.imu_l = robot.imu;
+    imu_sample s;
+    // 控制循环第一拍：丢掉 setzero 关闭入队前残留的样本，从此开始入队
+    if (!ring_open.load(std::memory_order_relaxed))
+    {
+        while (imu_ring.pop(s))
+        {
+        }
+        ring_open.store(true, std::memory_order_release);
+    }
+    float gx = 0, gy = 0, gz = 0;
+    uint32_t n = 0;
+    while (imu_ring.pop(s))
+    {
+        gx += s.gyrox;
+        gy += s.gyroy;
+        gz += s.gyroz;
+        n++;
+    }
+    if (n == 0)
+    {
+        stats.stale++; // 本拍无新数据，沿用上一拍
+        return;
+    }
+    const float inv = 1.0f / n;
+    robot.imu.anglex = s.anglex;
+    robot.imu.angley = s.angley;
+    robot.imu.anglez = s.anglez;
+    robot.imu.gyrox = gx * inv;
+    robot.imu.gyroy = gy * inv;
+    robot.imu.gyroz = gz * inv;
+    stats.age_us = micros() - s.t_us;
+}
+
+bool my_mpu6050_probe()
+{
+    // 总线已由采样任务独占，这里只看样本计数是否在增长
+    const uint32_t before = stats.samples;
+    delay(20);
+    return stats.samples != before;
+}
+
+const imu_fifo_stats &my_mpu6050_stats()
+{
+    return stats;
+}
+
+#else
+namespace
+{
+    imu_fifo_stats stats = {};
+    uint32_t last_us = 0;
+}
+
 void my_mpu6050_setzero()
 {
     my_mpu6050_update();
@@ -19,7 +275,10 @@ void my_mpu6050_init()
 {
     mpu6050.begin();
     mpu6050.calcGyroOffsets(true);
-    Serial.println("MPU6050初始化完成");
+    mpu6050.update();
+    attitude.reset({mpu6050.getAccX(), mpu6050.getAccY(), mpu6050.getAccZ(), 0.0f, 0.0f, 0.0f});
+    last_us = micros();
+    Serial.printf("MPU6050初始化完成（%s）\n", attitude.name());
     delay(1000);
     my_mpu6050_setzero();
     Serial.println("MPU6050初始状态设置完毕");
@@ -33,11 +292,31 @@ void my_mpu6050_update()
     robot.imu_l.gyrox = robot.imu.gyrox;
     robot.imu_l.gyroy = robot.imu.gyroy;
     robot.imu_l.gyroz = robot.imu.gyroz;
+    // 只取 MPU6050_tockn 换算后的原始量，姿态由估计器按微秒 dt 解算
     mpu6050.update();
-    robot.imu.anglex = mpu6050.getAngleX();
-    robot.imu.angley = mpu6050.getAngleY();
-    robot.imu.anglez = mpu6050.getAngleZ();
-    robot.imu.gyrox = mpu6050.getGyroX();
-    robot.imu.gyroy = mpu6050.getGyroY();
-    robot.imu.gyroz = mpu6050.getGyroZ();
+    const uint32_t now_us = micros();
+    attitude.update({mpu6050.getAccX(), mpu6050.getAccY(), mpu6050.getAccZ(),
+                     mpu6050.getGyroX(), mpu6050.getGyroY(), mpu6050.getGyroZ()},
+                    (now_us - last_us) * 1e-6f);
+    last_us = now_us;
+    const attitude_output &o = attitude.output();
+    robot.imu.anglex = o.anglex;
+    robot.imu.angley = o.angley;
+    robot.imu.anglez = o.anglez;
+    robot.imu.gyrox = o.gyrox;
+    robot.imu.gyroy = o.gyroy;
+    robot.imu.gyroz = o.gyroz;
+    stats.samples++;
+}
+
+bool my_mpu6050_probe()
+{
+    Wire.beginTransmission(MPU6050_ADDR);
+    return Wire.endTransmission() == 0;
+}
+
+const imu_fifo_stats &my_mpu6050_stats()
+{
+    return stats;
 }
+#endif
@@ -3,11 +3,12 @@
 #include "my_I2C.h"
 #include "my_config.h"
 #include "my_motion.h"
+#include "my_mpu6050.h"
+#include "my_motor.h"
 #include <Arduino.h>
 #include <Wire.h>
 
 // I2C设备地址
-#define MPU6050_ADDRESS     0x68  // MPU6050的I2C地址
 #define SCREEN_ADDRESS_7BIT 0x3C  // 屏幕的7位地址
 
 namespace
@@ -43,7 +44,8 @@ bool my_inspect_check_imu()
 {
     Serial.print("检查IMU(MPU6050)...");
     
-    bool result = check_i2c_device(Wire, MPU6050_ADDRESS);
+    // IMU 总线由 my_mpu6050 独占（异步模式下由采样任务访问），交给驱动自检
+    bool result = my_mpu6050_probe();
     
     if (result)
     {
@@ -62,9 +64,16 @@ bool my_inspect_check_motors()
     Serial.print("检查电机和编码器（死区测量）...");
     
     // 检查电机和编码器的方法：
-    // 在my_motor_init()中会进行死区校准
-    // 如果校准后的死区值接近1.0（最大值），说明没有检测到编码器脉冲
+    // 死区标定在控制任务中后台进行，结果存 NVS；这里检查上次保存的标定值
+    // 如果死区值接近1.0（最大值），说明没有检测到编码器脉冲
     // 这表示电机或编码器未连接
+    motor_cal_status cal;
+    my_motor_cal_status(cal);
+    if (!cal.loaded)
+    {
+        Serial.println(" 尚无标定值，首次标定在后台进行，结果见串口 [MOTOR] 行");
+        return true;
+    }
     
     // 获取死区测量结果
     float l_fwd = robot.motor.L_deadzone_fwd;
@@ -124,7 +133,7 @@ bool my_inspect_check_all()
     
     // 3. 检查电机和编码器
     // 注意：此检查应该在my_motor_init()之后进行
-    // 因为死区校准是在motor_init中完成的
+    // 因为NVS中的死区标定值是在motor_init中读取的
     bool motor_ok = my_inspect_check_motors();
     all_ok = all_ok && motor_ok;
     
@@ -0,0 +1,237 @@
+#include <Arduino.h>
+#include <atomic>
+#include <math.h>
+#include "my_autotune.h"
+#include "my_motion.h"
+#include "my_seqlock.h"
+
+namespace
+{
+    constexpr float Pi = 3.14159265358979f;
+
+    // 网络任务 -> 控制任务的请求
+    std::atomic<uint8_t> start_request{0}; // autotune_target，0 表示无请求
+    std::atomic<bool> abort_request{false};
+
+    const autotune_status Idle = {AT_IDLE, AT_LOOP_NONE, 0, 0, AUTOTUNE_CYCLES, 0, nullptr, {}, {}};
+
+    // 控制任务发布的状态快照（网络/遥测任务读）
+    lockfree::Snapshot<autotune_status> published;
+
+    // 以下仅控制任务访问
+    autotune_status st = Idle;
+    uint32_t start_tick = 0;
+    uint32_t phase_tick = 0;  // 进入当前阶段的节拍
+    uint32_t settle_ticks = 0;
+    float relay_sign = 1.0f;
+    bool have_rise = false;
+    uint32_t last_rise_tick = 0;
+    float err_max = 0.0f, err_min = 0.0f;
+    uint8_t seen_cycles = 0;
+    float sum_period = 0.0f, sum_amp = 0.0f;
+
+    uint32_t ticks_to_ms(uint32_t ticks)
+    {
+        return ticks * static_cast<uint32_t>(robot.dt_ms);
+    }
+
+    void publish()
+    {
+        st.elapsed_ms = st.state == AT_IDLE ? 0 : ticks_to_ms(robot.tick.count - start_tick);
+        published.publish(st);
+    }
+
+    void fail(const char *why)
+    {
+        st.state = AT_FAILED;
+        st.error = why;
+        Serial.printf("[TUNE] %s 整定失败：%s\n", my_autotune_loop_name(st.loop), why);
+    }
+
+    void enter_settle(autotune_loop loop)
+    {
+        st.state = AT_SETTLE;
+        st.loop = loop;
+        st.cycles = 0;
+        settle_ticks = 0;
+        phase_tick = robot.tick.count;
+    }
+
+    void enter_relay()
+    {
+        st.state = AT_RELAY;
+        phase_tick = robot.tick.count;
+        relay_sign = 1.0f;
+        have_rise = false;
+        seen_cycles = 0;
+        sum_period = sum_amp = 0.0f;
+        err_max = -1e9f;
+        err_min = 1e9f;
+    }
+
+    // 由平均周期与幅值得到 Ku/Tu 与建议参数
+    void finish_loop()
+    {
+        const float h = st.loop == AT_LOOP_ANG ? AUTOTUNE_ANG_RELAY : AUTOTUNE_SPD_RELAY;
+        autotune_result &r = st.loop == AT_LOOP_ANG ? st.ang : st.spd;
+        r.tu = sum_period / AUTOTUNE_CYCLES;
+        r.amplitude = sum_amp / AUTOTUNE_CYCLES;
+        r.ku = 4.0f * h / (Pi * r.amplitude);
+        // Tyreus–Luyben PI：Kp = Ku / 3.2，Ti = 2.2 Tu，比 Ziegler–Nichols 保守，平衡车上超调更小；
+        // 角度环激励时陀螺阻尼仍在环内，D 沿用当前值，速度环不用 D
+        r.p = r.ku / 3.2f;
+        r.i = r.p / (2.2f * r.tu);
+        r.d = st.loop == AT_LOOP_ANG ? robot.ang_pid.d : 0.0f;
+        r.valid = true;
+        Serial.printf("[TUNE] %s: Ku=%.4f Tu=%.3fs a=%.3f -> P=%.4f I=%.4f D=%.4f\n", my_autotune_loop_name(st.loop),
+                      r.ku, r.tu, r.amplitude, r.p, r.i, r.d);
+
+        if (st.loop == AT_LOOP_ANG && st.target == AT_TARGET_BOTH)
+            enter_settle(AT_LOOP_SPD);
+        else
+            st.state = AT_DONE;
+    }
+
+    bool balanced()
+    {
+        return fabsf(robot.ang.err) < 2.0f && fabsf(robot.spd.now) < 2.0f;
+    }
+}
+
+void my_autotune_update()
+{
+    bool changed = false;
+    if (abort_request.exchange(false))
+    {
+        if (my_autotune_active())
+            fail("已取消");
+        changed = true;
+    }
+    const uint8_t req = start_request.exchange(0);
+    if (req)
+    {
+        st = {};
+        st.target = req;
+        st.cycles_total = AUTOTUNE_CYCLES;
+        start_tick = robot.tick.count;
+        enter_settle(req == AT_TARGET_SPD ? AT_LOOP_SPD : AT_LOOP_ANG);
+        changed = true;
+    }
+
+    if (my_autotune_active())
+    {
+        const autotune_state before = st.state;
+        const uint8_t cycles_before = st.cycles;
+        if (!robot.run || robot.fallen.is)
+            fail("机器人未运行或已摔倒");
+        else if (robot.ctrl_mode != CTRL_MODE_PID)
+            fail("仅串级 PID 模式可整定");
+        else if (robot.joy.x != 0.0f || robot.joy.y != 0.0f)
+            fail("整定期间请勿操作摇杆");
+        else if (st.state == AT_SETTLE)
+        {
+            settle_ticks = balanced() ? settle_ticks + 1 : 0;
+            if (ticks_to_ms(settle_ticks) >= AUTOTUNE_SETTLE_MS)
+                enter_relay();
+            else if (ticks_to_ms(robot.tick.count - phase_tick) > AUTOTUNE_TIMEOUT_MS)
+                fail("无法稳定平衡");
+        }
+        else if (ticks_to_ms(robot.tick.count - phase_tick) > AUTOTUNE_TIMEOUT_MS)
+            fail("未形成稳定极限环");
+        else if (st.loop == AT_LOOP_ANG && fabsf(robot.ang.err) > AUTOTUNE_ANG_ABORT_DEG)
+            fail("角度振幅超限");
+        else if (st.loop == AT_LOOP_SPD && fabsf(robot.spd.err) > AUTOTUNE_SPD_ABORT)
+            fail("速度振幅超限");
+        changed |= st.state != before || st.cycles != cycles_before;
+    }
+
+    // 激励期间每 100ms 刷新一次进度，状态变化立即发布
+    if (changed || (my_autotune_active() && robot.tick.count % (100 / robot.dt_ms) == 0))
+        publish();
+}
+
+bool my_autotune_relay(autotune_loop loop, float err, float &out)
+{
+    if (st.state != AT_RELAY || st.loop != loop)
+        return false;
+
+    const float h = loop == AT_LOOP_ANG ? AUTOTUNE_ANG_RELAY : AUTOTUNE_SPD_RELAY;
+    const float hyst = loop == AT_LOOP_ANG ? AUTOTUNE_ANG_HYST : AUTOTUNE_SPD_HYST;
+    if (err > err_max)
+        err_max = err;
+    if (err < err_min)
+        err_min = err;
+
+    // 与 PID 同号：误差为正输出 +h；滞环防止噪声来回触发
+    if (relay_sign < 0.0f && err > hyst)
+    {
+        relay_sign = 1.0f;
+        // 上升切换：一个完整周期结束
+        const uint32_t now = robot.tick.count;
+        if (have_rise)
+        {
+            if (seen_cycles >= AUTOTUNE_SKIP_CYCLES)
+            {
+                sum_period += ticks_to_ms(now - last_rise_tick) * 0.001f;
+                sum_amp += 0.5f * (err_max - err_min);
+                st.cycles++;
+            }
+            seen_cycles++;
+        }
+        have_rise = true;
+        last_rise_tick = now;
+        err_max = err_min = err;
+        if (st.cycles >= AUTOTUNE_CYCLES)
+        {
+            finish_loop();
+            publish();
+        }
+    }
+    else if (relay_sign > 0.0f && err < -hyst)
+    {
+        relay_sign = -1.0f;
+    }
+    out = relay_sign * h;
+    return true;
+}
+
+bool my_autotune_active()
+{
+    return st.state == AT_SETTLE || st.state == AT_RELAY;
+}
+
+void my_autotune_start(autotune_target target)
+{
+    abort_request.store(false);
+    start_request.store(target, std::memory_order_release);
+}
+
+void my_autotune_abort()
+{
+    abort_request.store(true, std::memory_order_release);
+}
+
+void my_autotune_status(autotune_status &out)
+{
+    if (published.read(out) == 0)
+        out = Idle; // 控制任务尚未发布过
+}
+
+const char *my_autotune_state_name(autotune_state s)
+{
+    static const char *const Names[] = {"idle", "settle", "relay", "done", "failed"};
+    return s <= AT_FAILED ? Names[s] : "?";
+}
+
+const char *my_autotune_loop_name(autotune_loop l)
+{
+    switch (l)
+    {
+    case AT_LOOP_ANG:
+        return "ang";
+    case AT_LOOP_SPD:
+        return "spd";
+    default:
+        return "none";
+    }
+}
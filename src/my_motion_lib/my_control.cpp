@@ -4,6 +4,9 @@
 #include "my_encoder.h"
 #include "my_tool.h"
 #include "my_motor.h"
+#include "my_pipeline.h"
+#include "my_autotune.h"
+#include "my_sched.h"
 
 PIDController PID_ANG{robot.ang_pid.p, robot.ang_pid.i, 0, robot.ang_pid.k, robot.ang_pid.l};               // 直立控制
 PIDController PID_SPD{robot.spd_pid.p, robot.spd_pid.i, robot.spd_pid.d, robot.spd_pid.k, robot.spd_pid.l}; // 速度控制
@@ -11,7 +14,24 @@ PIDController PID_YAW{robot.yaw_pid.p, robot.yaw_pid.i, 0, robot.yaw_pid.k, robo
 PIDController PID_POS{robot.pos_pid.p, robot.pos_pid.i, robot.pos_pid.d, robot.pos_pid.k, robot.pos_pid.l}; // 位置控制
 
 LowPassFilter LQF_ZEROPOINT{0.1};
-LowPassFilter LQF_JOY{0.2};
+
+namespace
+{
+    CTL_CONST(PitchAngDeadband, PITCH_ANG_DEADBAND);
+    CTL_CONST(PitchSpdDeadband, PITCH_SPD_DEADBAND);
+    CTL_CONST(PitchTorDeadband, PITCH_TOR_DEADBAND);
+    CTL_CONST(RadToDeg, RAD_TO_DEG_F);
+    CTL_CONST(PitchOffsetLimit, PITCH_ANGLE_OFFSET_LIMIT);
+
+    // 串级各段，中间量（err/duty）需要写回 robot 供遥测与黑匣子，因此按段拆开
+    using PosLoop = ctl::Pipeline<ctl::PID<PID_POS>>;                                         // 位置误差 -> 速度目标修正
+    using SpdError = ctl::Pipeline<ctl::Deadband<PitchSpdDeadband>>;                          // 速度误差死区
+    using SpdLoop = ctl::Pipeline<ctl::PID<PID_SPD>, ctl::Gain<sched_spd_gain>>;              // 速度误差 -> 角度修正（rad），按调度倍率缩放
+    using SpdToPitch = ctl::Pipeline<ctl::Scale<RadToDeg>, ctl::Clamp<PitchOffsetLimit>>;     // rad -> 限幅后的角度偏移
+    using AngError = ctl::Pipeline<ctl::Deadband<PitchAngDeadband>>;                          // 角度误差死区
+    using AngLoop = ctl::Pipeline<ctl::PID<PID_ANG>, ctl::Gain<sched_ang_gain>>;              // 角度误差 -> 力矩（D 项另用陀螺）
+    using TorOutput = ctl::Pipeline<ctl::Deadband<PitchTorDeadband>>;                         // 力矩输出死区
+}
 
 namespace
 {
@@ -52,9 +72,7 @@ void robot_state_update()
     robot.spd.last = robot.spd.now;
     robot.pos.last = robot.pos.now;
     robot.yaw.last = robot.yaw.now;
-    // 同步机器人状态，spd 和 pos 状态由编码器更新
-    my_encoder_update();
-    // 更新当前状态
+    // 更新当前状态（spd 和 pos 来自本拍已刷新的编码器数据）
     robot.ang.now = robot.imu.angley;
     robot.spd.now = -0.5f * (robot.wel.spd1 + robot.wel.spd2); // rad/s
     robot.pos.now = -0.5f * (robot.wel.pos1 + robot.wel.pos2); // rad
@@ -78,37 +96,41 @@ void robot_pos_control()
         robot.pos.tar = robot.pos.now; // 位移零点重置
 }
 
+// 控制律使用的周期：定时器节拍足够稳定时用标称值，PID/低通系数保持不变
+static inline float control_dt()
+{
+#if CONTROL_FIXED_DT
+    return robot.dt_ms * 0.001f;
+#else
+    return robot.tick.dt;
+#endif
+}
+
 void pitch_control()
 {
+    const float dt = control_dt();
     // 串级：位置 -> 速度 -> 角度
     robot.pos.err = robot.pos.now - robot.pos.tar;
-    robot.pos.duty = PID_POS(robot.pos.err); // 位置环输出作为速度目标修正量
+    robot.pos.duty = PosLoop::run(robot.pos.err, dt); // 位置环输出作为速度目标修正量
 
-    float joy_spd_tar = robot.joy.y_coef * LQF_JOY(robot.joy.y);
+    float joy_spd_tar = robot.joy.y_coef * robot.joy.y; // 摇杆量已由 my_joy 平滑
     robot.spd.tar = joy_spd_tar - robot.pos.duty; // 速度目标 = 摇杆期望 - 位置环修正
 
-    robot.spd.err = robot.spd.now - robot.spd.tar;
-    if (fabsf(robot.spd.err) < PITCH_SPD_DEADBAND)
-        robot.spd.err = 0.0f;
-    robot.spd.duty = PID_SPD(robot.spd.err); // 速度环输出用作角度目标修正
+    robot.spd.err = SpdError::run(robot.spd.now - robot.spd.tar, dt);
+    if (!my_autotune_relay(AT_LOOP_SPD, robot.spd.err, robot.spd.duty)) // 自整定时由继电输出代替
+        robot.spd.duty = SpdLoop::run(robot.spd.err, dt);                // 速度环输出用作角度目标修正
 
-    float pitch_offset = my_lim(robot.spd.duty * RAD_TO_DEG_F, PITCH_ANGLE_OFFSET_LIMIT);
-    robot.ang.tar = robot.pitch_zero - pitch_offset;
-    robot.ang.err = robot.ang.now - robot.ang.tar;
-    if (fabsf(robot.ang.err) < PITCH_ANG_DEADBAND)
-        robot.ang.err = 0.0f;
-    robot.ang.duty = PID_ANG(robot.ang.err) + my_lim(robot.ang_pid.d * robot.imu.gyroy, robot.ang_pid.l);
+    robot.ang.tar = robot.pitch_zero - SpdToPitch::run(robot.spd.duty, dt);
+    robot.ang.err = AngError::run(robot.ang.now - robot.ang.tar, dt);
+    float ang_out;
+    if (!my_autotune_relay(AT_LOOP_ANG, robot.ang.err, ang_out))
+        ang_out = AngLoop::run(robot.ang.err, dt);
+    robot.ang.duty = ang_out + my_lim(sched_ang_gain * robot.ang_pid.d * robot.imu.gyroy, robot.ang_pid.l);
 
     // 轮部离地检测
     if (abs(robot.spd.now - robot.spd.last) > 10 || abs(robot.spd.now) > 50) // 若轮部角速度、角加速度过大或处于跳跃后的恢复时期，认为出现轮部离地现象，需要特殊处理
-    {
         robot.pos.tar = robot.pos.now; // 位移零点重置
-        robot.motor.base_duty = robot.ang.duty;
-    }
-    else
-        robot.motor.base_duty = robot.ang.duty;
-    if (fabsf(robot.motor.base_duty) < PITCH_TOR_DEADBAND)
-        robot.motor.base_duty = 0.0f;
+    robot.motor.base_duty = TorOutput::run(robot.ang.duty, dt);
 }
 
 void yaw_control()
@@ -137,6 +159,56 @@ void yaw_control()
     robot.motor.yaw_duty = my_lim(yaw_ff - yaw_damp, robot.yaw_pid.l);
 }
 
+// 全状态 LQR：u = K * x，一次 2x5 矩阵乘代替三级串级；位置零点仍由 robot_pos_control() 管理
+void lqr_control()
+{
+    const float dt = control_dt();
+    const float yaw_cmd_rate = robot.joy.x * robot.joy.x_coef * YAW_RATE_MAX_DEG_S;
+
+    robot.ang.tar = robot.pitch_zero;
+    robot.spd.tar = robot.joy.y_coef * robot.joy.y;
+    robot.yaw.tar = yaw_cmd_rate;
+    robot.yaw.now = robot.imu.gyroz;
+    robot.yaw.err = yaw_cmd_rate - robot.imu.gyroz;
+    robot.ang.err = robot.ang.now - robot.ang.tar;
+    robot.spd.err = robot.spd.now - robot.spd.tar;
+    robot.pos.err = robot.pos.now - robot.pos.tar;
+
+    const float x[LQR_STATES] = {robot.ang.err, robot.imu.gyroy, robot.pos.err, robot.spd.err, -robot.yaw.err};
+    float u[LQR_INPUTS];
+    for (int i = 0; i < LQR_INPUTS; ++i)
+    {
+        const float *k = robot.lqr.k[i];
+        u[i] = k[0] * x[0] + k[1] * x[1] + k[2] * x[2] + k[3] * x[3] + k[4] * x[4];
+    }
+
+    // 串级的中间量在 LQR 下没有意义，清零以免图表误读
+    robot.pos.duty = 0.0f;
+    robot.spd.duty = 0.0f;
+    robot.ang.duty = u[0];
+
+    // 轮部离地检测，与串级一致
+    if (abs(robot.spd.now - robot.spd.last) > 10 || abs(robot.spd.now) > 50)
+        robot.pos.tar = robot.pos.now;
+    robot.motor.base_duty = TorOutput::run(u[0], dt);
+    // 转向沿用偏航前馈（yaw_pid.p），LQR 只负责角速度误差
+    robot.motor.yaw_duty = my_lim(robot.yaw_pid.p * yaw_cmd_rate + u[1], robot.yaw_pid.l);
+}
+
+// 切换控制器时清掉另一套的历史状态，避免积分或滤波残留造成冲击
+void control_mode_check()
+{
+    static uint8_t last_mode = CTRL_MODE_PID;
+    if (robot.ctrl_mode == last_mode)
+        return;
+    last_mode = robot.ctrl_mode;
+    PID_ANG.reset();
+    PID_SPD.reset();
+    PID_POS.reset();
+    PID_YAW.reset();
+    robot.pos.tar = robot.pos.now;
+}
+
 void pitch_zero_adapt()
 {
     // 触发条件：遥控器无信号输入、位置环已介入且左右归一化指令均很小
@@ -147,7 +219,7 @@ void pitch_zero_adapt()
 
     if (cmd_abs < 0.1f && robot.joy.y == 0 && fabsf(robot.pos.duty) < 4)
     {
-        robot.pitch_zero -= my_lim(0.002f * LQF_ZEROPOINT(robot.pos.duty), 4); // 重心自适应
+        robot.pitch_zero -= my_lim(0.002f * LQF_ZEROPOINT(robot.pos.duty, control_dt()), 4); // 重心自适应
     }
 }
 
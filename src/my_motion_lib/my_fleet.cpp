@@ -0,0 +1,129 @@
+#include <Arduino.h>
+#include <atomic>
+#include "my_fleet.h"
+#include "my_motion.h"
+#include "my_joy.h"
+#include "my_tool.h"
+
+namespace
+{
+    // 以下仅控制任务访问
+    fleet_setpoint last = {};    // 最近一帧设定值
+    uint32_t last_rx_us = 0;
+    bool tracking = false;       // 队形原点有效
+    float leader_pos0 = 0.0f;    // 队形原点：头车里程
+    float own_pos0 = 0.0f;       // 队形原点：本车里程
+    bool leader_run = false;     // 头车上一帧的运行状态
+    bool sent_any = false;
+    uint32_t last_send_us = 0;
+
+    // 控制任务写，网络任务读
+    std::atomic<uint32_t> setpoints{0};
+    std::atomic<float> pos_err{0.0f};
+    std::atomic<float> spd_corr{0.0f};
+    std::atomic<bool> tracking_pub{false};
+
+    void leader_send(const group_config &cfg)
+    {
+        const uint32_t now = robot.tick.last_us;
+        if (sent_any && now - last_send_us < GROUP_SETPOINT_INTERVAL_MS * 1000)
+            return;
+        sent_any = true;
+        last_send_us = now;
+
+        // 发送物理量，从车按各自的摇杆系数换算
+        fleet_setpoint sp;
+        sp.spd = robot.joy.y_coef * robot.joy.y;
+        sp.yaw_rate = robot.joy.x * robot.joy.x_coef * YAW_RATE_MAX_DEG_S;
+        sp.pos = robot.pos.now;
+        sp.vel = robot.spd.now;
+        sp.offset = cfg.formation_offset;
+        sp.flags = (robot.run && !robot.fallen.is) ? FLEET_SP_RUN : 0;
+        my_group_send_setpoint(sp);
+        setpoints.store(setpoints.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void publish(float err, float corr)
+    {
+        pos_err.store(err, std::memory_order_relaxed);
+        spd_corr.store(corr, std::memory_order_relaxed);
+        tracking_pub.store(tracking, std::memory_order_relaxed);
+    }
+}
+
+bool my_fleet_follower()
+{
+    const group_config &cfg = my_group_get_config();
+    return cfg.espnow_enabled && cfg.role == VehicleRole::FOLLOWER && cfg.fleet_mode == FleetMode::SETPOINT;
+}
+
+void my_fleet_push(const fleet_setpoint &sp, uint32_t tx_us, uint32_t rx_us)
+{
+    // 换算为本车摇杆量，各车摇杆系数不同时物理量仍一致
+    const float y = robot.joy.y_coef != 0.0f ? sp.spd / robot.joy.y_coef : 0.0f;
+    const float x_scale = robot.joy.x_coef * YAW_RATE_MAX_DEG_S;
+    const float x = x_scale != 0.0f ? sp.yaw_rate / x_scale : 0.0f;
+    my_joy_push({my_lim(x, -1.0f, 1.0f), my_lim(y, -1.0f, 1.0f), 0.0f, tx_us, rx_us});
+
+    // 只跟随头车启停的变化，本车网页仍可单独停车
+    const bool run = (sp.flags & FLEET_SP_RUN) != 0;
+    if (run != leader_run)
+    {
+        robot.run = run;
+        leader_run = run;
+    }
+
+    if (!tracking && robot.run && !robot.fallen.is)
+    {
+        leader_pos0 = sp.pos;
+        own_pos0 = robot.pos.now;
+        tracking = true;
+    }
+    last = sp;
+    last_rx_us = rx_us;
+    setpoints.store(setpoints.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void my_fleet_update()
+{
+    const group_config &cfg = my_group_get_config();
+    if (!cfg.espnow_enabled || cfg.fleet_mode != FleetMode::SETPOINT)
+        return;
+    if (cfg.role == VehicleRole::LEADER)
+    {
+        leader_send(cfg);
+        return;
+    }
+    if (cfg.role != VehicleRole::FOLLOWER)
+        return;
+
+    // 失联、停机或摔倒后放弃原点，恢复后从当时的相对位置重新开始
+    const int32_t age_us = static_cast<int32_t>(robot.tick.last_us - last_rx_us);
+    if (!tracking || age_us > static_cast<int32_t>(JOY_DEADMAN_MS * 1000) || !robot.run || robot.fallen.is)
+    {
+        tracking = false;
+        publish(0.0f, 0.0f);
+        return;
+    }
+
+    // 头车里程按其实测轮速外推到当前时刻。平衡车的轮速要先前倾才能跟上目标，
+    // 只按里程差修正会在起停时来回超调，故再按两车实测轮速差阻尼
+    const float leader_pos = last.pos + last.vel * (age_us > 0 ? age_us * 1e-6f : 0.0f);
+    const float err = (leader_pos - leader_pos0 + last.offset) - (robot.pos.now - own_pos0);
+    float corr = 0.0f;
+    if (fabsf(err) > FLEET_FORM_DEADBAND)
+        corr = my_lim(FLEET_FORM_KP * err + FLEET_FORM_KD * (last.vel - robot.spd.now), FLEET_FORM_SPD_MAX);
+    // 修正量叠加到摇杆速度上；误差在死区内时保持 0，松杆后位置环照常锁定
+    if (corr != 0.0f && robot.joy.y_coef != 0.0f)
+        robot.joy.y = my_lim(robot.joy.y + corr / robot.joy.y_coef, -1.0f, 1.0f);
+    publish(err, corr);
+}
+
+void my_fleet_status(fleet_status &out)
+{
+    out.follower = my_fleet_follower();
+    out.tracking = tracking_pub.load(std::memory_order_relaxed);
+    out.setpoints = setpoints.load(std::memory_order_relaxed);
+    out.pos_err = pos_err.load(std::memory_order_relaxed);
+    out.spd_corr = spd_corr.load(std::memory_order_relaxed);
+}
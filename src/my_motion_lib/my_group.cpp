@@ -3,40 +3,74 @@
 #include <esp_now.h>
 #include <esp_wifi.h>
 #include <Preferences.h>
+#include <atomic>
+#include <math.h>
 #include "my_config.h"
+#include "my_state.h"
+#include "my_seqlock.h"
 
 /********** 全局变量 **********/
 group_config g_group_cfg = {
     .role = VehicleRole::STANDALONE,
     .leader_mac = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF},
     .group_id = 0,
-    .espnow_enabled = false
+    .espnow_enabled = false,
+    .fleet_mode = FleetMode::DUTY,
+    .formation_offset = 0.0f,
+    .tx_max_hz = GROUP_TX_MAX_HZ
 };
 
 volatile uint32_t g_last_command_time = 0;
 static bool g_espnow_initialized = false;
 static motion_command g_last_received_cmd = {0};
 
+// 以下在 ESP-NOW 接收回调与混杂模式回调中更新（同在 WiFi 任务）
+static FleetLink g_leader_link;                    // 从车：头车下行链路
+static uint32_t g_rx_errors[FLEET_ERR_COUNT] = {0}; // 错误帧按原因计数
+
+// 发送任务：控制任务经长度 1 的队列投递最新指令（xQueueOverwrite，不阻塞），
+// 所有 esp_now_send 都在发送任务中调用，一次只有一帧在途，发送回调通知完成
+struct tx_item
+{
+    fleet_msg_type type;
+    union
+    {
+        motion_command motion;
+        fleet_setpoint sp;
+    } u;
+};
+static QueueHandle_t g_tx_queue = nullptr;
+static TaskHandle_t g_tx_task = nullptr;
+static uint16_t g_tx_seq = 0; // 本机发送序号，所有类型共用（仅发送任务）
+static std::atomic<uint32_t> g_tx_posted{0};         // 控制任务写
+static std::atomic<uint32_t> g_tx_start_us{0};       // 发送任务写，发送回调读
+static lockfree::Snapshot<fleet_tx_counts> g_tx_counts; // 发送任务发布
+static std::atomic<uint32_t> g_tx_error{0}, g_tx_timeout{0}, g_tx_heartbeats{0}; // 发送任务写
+// 以下发送回调写
+static std::atomic<uint32_t> g_tx_ok{0}, g_tx_fail{0};
+static std::atomic<uint32_t> g_tx_done_mean_us{0}, g_tx_done_max_us{0};
+// 连丢 3 帧时，两次收到之间隔 4 个保活间隔，仍须短于从车的失联判定
+static_assert(GROUP_TX_KEEPALIVE_MS * 4 < JOY_DEADMAN_MS && GROUP_TX_KEEPALIVE_MS * 4 < GROUP_COMMAND_TIMEOUT_MS,
+              "保活间隔须容忍连丢 3 帧");
+
 // 广播地址用于头车发送
 static uint8_t g_broadcast_mac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
 // 从车追踪
 follower_info g_followers[MAX_FOLLOWERS];
 int g_follower_count = 0;
-static uint32_t g_last_heartbeat_time = 0;
 #define HEARTBEAT_INTERVAL_MS 1000  // 从车每1秒发送一次心跳
 #define FOLLOWER_TIMEOUT_MS 3000    // 3秒无心跳视为离线
 
 /********** 内部函数声明 **********/
-static uint8_t calculate_checksum(const motion_command &cmd);
-static bool verify_checksum(const motion_command &cmd);
-static uint8_t calculate_heartbeat_checksum(const follower_heartbeat &hb);
-static bool verify_heartbeat_checksum(const follower_heartbeat &hb);
 static void espnow_send_callback(const uint8_t *mac, esp_now_send_status_t status);
 static void espnow_receive_callback(const uint8_t *mac, const uint8_t *data, int len);
-static void handle_motion_command(const uint8_t *data, int len);
-static void handle_follower_heartbeat(const uint8_t *mac, const uint8_t *data, int len);
+static void handle_motion_command(const uint8_t *mac, const fleet_header &h, const motion_command &cmd, uint32_t rx_us);
+static void handle_setpoint(const uint8_t *mac, const fleet_header &h, const fleet_setpoint &sp, uint32_t rx_us);
+static void handle_follower_heartbeat(const uint8_t *mac, const fleet_header &h, const follower_heartbeat &hb, uint32_t rx_us);
+static int find_follower(const uint8_t *mac);
 static int find_or_add_follower(const uint8_t *mac);
+static FleetLink *peer_link(const uint8_t *mac);
 
 /********** 配置管理 **********/
 bool my_group_config_save(const group_config &cfg)
@@ -52,6 +86,9 @@ bool my_group_config_save(const group_config &cfg)
     pref.putBytes("leader_mac", cfg.leader_mac, 6);
     pref.putUChar("group_id", cfg.group_id);
     pref.putBool("espnow_en", cfg.espnow_enabled);
+    pref.putUChar("fleet_mode", static_cast<uint8_t>(cfg.fleet_mode));
+    pref.putFloat("form_off", cfg.formation_offset);
+    pref.putUShort("tx_hz", cfg.tx_max_hz);
 
     pref.end();
     Serial.println("[GROUP] Configuration saved to NVS");
@@ -77,6 +114,9 @@ bool my_group_config_load(group_config &cfg)
     }
     cfg.group_id = pref.getUChar("group_id", 0);
     cfg.espnow_enabled = pref.getBool("espnow_en", false);
+    cfg.fleet_mode = pref.getUChar("fleet_mode", 0) == 1 ? FleetMode::SETPOINT : FleetMode::DUTY;
+    cfg.formation_offset = pref.getFloat("form_off", 0.0f);
+    cfg.tx_max_hz = constrain(pref.getUShort("tx_hz", GROUP_TX_MAX_HZ), 1, GROUP_TX_MAX_HZ_LIMIT);
 
     pref.end();
     Serial.println("[GROUP] Configuration loaded from NVS");
@@ -93,124 +133,159 @@ void my_group_set_role(VehicleRole role, const uint8_t *leader_mac)
     my_group_config_save(g_group_cfg);
 }
 
-const group_config &my_group_get_config()
+void my_group_set_formation_offset(float offset)
 {
-    return g_group_cfg;
+    g_group_cfg.formation_offset = offset;
 }
 
-void my_group_get_mac(uint8_t *mac)
+void my_group_set_tx_rate(uint16_t hz)
 {
-    esp_wifi_get_mac(WIFI_IF_STA, mac);
+    g_group_cfg.tx_max_hz = constrain(hz, 1, GROUP_TX_MAX_HZ_LIMIT);
 }
 
-/********** 校验和计算 **********/
-static uint8_t calculate_checksum(const motion_command &cmd)
+const group_config &my_group_get_config()
 {
-    const uint8_t *data = reinterpret_cast<const uint8_t *>(&cmd);
-    uint8_t sum = 0;
-    // 计算除checksum字段外的所有字节
-    for (size_t i = 0; i < sizeof(motion_command) - 1; i++)
-    {
-        sum ^= data[i];
-    }
-    return sum;
+    return g_group_cfg;
 }
 
-static bool verify_checksum(const motion_command &cmd)
+void my_group_get_mac(uint8_t *mac)
 {
-    return cmd.checksum == calculate_checksum(cmd);
+    esp_wifi_get_mac(WIFI_IF_STA, mac);
 }
 
-static uint8_t calculate_heartbeat_checksum(const follower_heartbeat &hb)
+/********** 组帧发送 **********/
+static esp_err_t fleet_send(const uint8_t *mac, fleet_msg_type type, const void *payload, size_t n)
 {
-    const uint8_t *data = reinterpret_cast<const uint8_t *>(&hb);
-    uint8_t sum = 0;
-    for (size_t i = 0; i < sizeof(follower_heartbeat) - 1; i++)
-    {
-        sum ^= data[i];
-    }
-    return sum;
+    fleet_header h;
+    h.magic = FLEET_MAGIC;
+    h.version = FLEET_VERSION;
+    h.type = type;
+    h.group_id = g_group_cfg.group_id;
+    h.seq = g_tx_seq++;
+    h.tx_us = micros();
+    uint8_t frame[FLEET_MAX_FRAME];
+    const size_t len = fleet_encode(h, payload, n, frame);
+    return esp_now_send(mac, frame, len);
 }
 
-static bool verify_heartbeat_checksum(const follower_heartbeat &hb)
+/********** ESP-NOW回调函数 **********/
+// WiFi 任务：记录完成结果与耗时，唤醒发送任务发下一帧
+static void espnow_send_callback(const uint8_t *mac, esp_now_send_status_t status)
 {
-    return hb.checksum == calculate_heartbeat_checksum(hb);
+    const uint32_t done_us = micros() - g_tx_start_us.load(std::memory_order_relaxed);
+    (status == ESP_NOW_SEND_SUCCESS ? g_tx_ok : g_tx_fail).fetch_add(1, std::memory_order_relaxed);
+    const int32_t mean = static_cast<int32_t>(g_tx_done_mean_us.load(std::memory_order_relaxed));
+    g_tx_done_mean_us.store(static_cast<uint32_t>(mean + (static_cast<int32_t>(done_us) - mean) / 16), std::memory_order_relaxed);
+    if (done_us > g_tx_done_max_us.load(std::memory_order_relaxed))
+        g_tx_done_max_us.store(done_us, std::memory_order_relaxed);
+    if (g_tx_task)
+        xTaskNotifyGive(g_tx_task);
 }
 
-/********** ESP-NOW回调函数 **********/
-static void espnow_send_callback(const uint8_t *mac, esp_now_send_status_t status)
+static void count_reject(const uint8_t *mac, fleet_decode_result r)
 {
-    // 可选：记录发送状态用于调试
-    // if (status != ESP_NOW_SEND_SUCCESS)
-    // {
-    //     Serial.println("[GROUP] Send failed");
-    // }
+    g_rx_errors[r]++;
+    FleetLink *link = peer_link(mac);
+    if (link)
+        link->on_reject();
 }
 
 static void espnow_receive_callback(const uint8_t *mac, const uint8_t *data, int len)
 {
-    // 判断数据类型并分发
-    if (len == sizeof(motion_command))
-    {
-        handle_motion_command(data, len);
+    // 先校验帧头与 CRC，再按类型分发；负载长度必须与类型一致
+    const uint32_t rx_us = micros();
+    fleet_header h;
+    const uint8_t *payload;
+    size_t n;
+    const fleet_decode_result r = fleet_decode(data, len, h, payload, n);
+    if (r != FLEET_OK)
+    {
+        count_reject(mac, r);
+        return;
     }
-    else if (len == sizeof(follower_heartbeat))
+
+    // 检查车队ID
+    if (h.group_id != g_group_cfg.group_id)
     {
-        handle_follower_heartbeat(mac, data, len);
+        return; // 不是本车队的帧
     }
-}
 
-static void handle_motion_command(const uint8_t *data, int len)
-{
-    motion_command cmd;
-    memcpy(&cmd, data, sizeof(motion_command));
-
-    // 校验数据
-    if (!verify_checksum(cmd))
+    switch (h.type)
+    {
+    case FLEET_MSG_MOTION:
     {
-        Serial.println("[GROUP] Motion command checksum error");
+        motion_command cmd;
+        if (n != sizeof(cmd))
+            break;
+        memcpy(&cmd, payload, sizeof(cmd));
+        handle_motion_command(mac, h, cmd, rx_us);
         return;
     }
-
-    // 检查车队ID
-    if (cmd.group_id != g_group_cfg.group_id)
+    case FLEET_MSG_SETPOINT:
     {
-        return; // 不是本车队的指令
+        fleet_setpoint sp;
+        if (n != sizeof(sp))
+            break;
+        memcpy(&sp, payload, sizeof(sp));
+        handle_setpoint(mac, h, sp, rx_us);
+        return;
     }
+    case FLEET_MSG_HEARTBEAT:
+    {
+        follower_heartbeat hb;
+        if (n != sizeof(hb))
+            break;
+        memcpy(&hb, payload, sizeof(hb));
+        handle_follower_heartbeat(mac, h, hb, rx_us);
+        return;
+    }
+    default:
+        break;
+    }
+    count_reject(mac, FLEET_ERR_LENGTH); // 未知类型或长度不符
+}
 
-    // 保存接收到的指令
-    g_last_received_cmd = cmd;
-    g_last_command_time = millis();
-
-    // 应用到robot状态（仅从车）
-    if (g_group_cfg.role == VehicleRole::FOLLOWER)
+// 仅从车处理头车的帧；两种指令都计入下行链路统计
+static bool from_leader(const uint8_t *mac, const fleet_header &h, uint32_t rx_us)
+{
+    if (g_group_cfg.role != VehicleRole::FOLLOWER || memcmp(mac, g_group_cfg.leader_mac, 6) != 0)
     {
-        extern robot_state robot;
-        robot.motor.L_duty = cmd.L_duty;
-        robot.motor.R_duty = cmd.R_duty;
+        return false;
     }
+    g_leader_link.on_frame(h.seq, h.tx_us, rx_us);
+    g_last_command_time = millis();
+    return true;
 }
 
-static void handle_follower_heartbeat(const uint8_t *mac, const uint8_t *data, int len)
+static void handle_motion_command(const uint8_t *mac, const fleet_header &h, const motion_command &cmd, uint32_t rx_us)
 {
-    // 仅头车处理心跳
-    if (g_group_cfg.role != VehicleRole::LEADER)
+    if (!from_leader(mac, h, rx_us) || g_group_cfg.fleet_mode != FleetMode::DUTY)
     {
         return;
     }
 
-    follower_heartbeat hb;
-    memcpy(&hb, data, sizeof(follower_heartbeat));
+    // 保存接收到的指令
+    g_last_received_cmd = cmd;
 
-    // 校验
-    if (!verify_heartbeat_checksum(hb))
+    // 投递给控制任务，下一拍拍首取出
+    my_cmd_follower(cmd.L_duty, cmd.R_duty);
+}
+
+static void handle_setpoint(const uint8_t *mac, const fleet_header &h, const fleet_setpoint &sp, uint32_t rx_us)
+{
+    if (!from_leader(mac, h, rx_us) || g_group_cfg.fleet_mode != FleetMode::SETPOINT)
     {
-        Serial.println("[GROUP] Heartbeat checksum error");
         return;
     }
 
-    // 检查车队ID
-    if (hb.group_id != g_group_cfg.group_id)
+    // 带头车时间戳投递，控制任务经 my_joy 对齐与平滑
+    my_cmd_fleet_setpoint(sp, h.tx_us, rx_us);
+}
+
+static void handle_follower_heartbeat(const uint8_t *mac, const fleet_header &h, const follower_heartbeat &hb, uint32_t rx_us)
+{
+    // 仅头车处理心跳
+    if (g_group_cfg.role != VehicleRole::LEADER)
     {
         return;
     }
@@ -219,14 +294,17 @@ static void handle_follower_heartbeat(const uint8_t *mac, const uint8_t *data, i
     int idx = find_or_add_follower(mac);
     if (idx >= 0)
     {
-        g_followers[idx].last_seen = millis();
-        g_followers[idx].online = true;
+        follower_info &f = g_followers[idx];
+        f.up.on_frame(h.seq, h.tx_us, rx_us);
+        f.down = hb.down;
+        f.battery_level = hb.battery_level;
+        f.last_seen = millis();
+        f.online = true;
     }
 }
 
-static int find_or_add_follower(const uint8_t *mac)
+static int find_follower(const uint8_t *mac)
 {
-    // 查找现有从车
     for (int i = 0; i < g_follower_count; i++)
     {
         if (memcmp(g_followers[i].mac, mac, 6) == 0)
@@ -234,19 +312,155 @@ static int find_or_add_follower(const uint8_t *mac)
             return i;
         }
     }
+    return -1;
+}
+
+static int find_or_add_follower(const uint8_t *mac)
+{
+    // 查找现有从车
+    const int idx = find_follower(mac);
+    if (idx >= 0)
+    {
+        return idx;
+    }
 
     // 添加新从车
     if (g_follower_count < MAX_FOLLOWERS)
     {
-        memcpy(g_followers[g_follower_count].mac, mac, 6);
-        g_followers[g_follower_count].last_seen = millis();
-        g_followers[g_follower_count].online = true;
+        follower_info &f = g_followers[g_follower_count];
+        f = follower_info();
+        memcpy(f.mac, mac, 6);
+        f.last_seen = millis();
+        f.online = true;
         return g_follower_count++;
     }
 
     return -1; // 已满
 }
 
+// 已知 peer 的链路统计：从车只认头车，头车只认已加入的从车
+static FleetLink *peer_link(const uint8_t *mac)
+{
+    if (g_group_cfg.role == VehicleRole::FOLLOWER)
+        return memcmp(mac, g_group_cfg.leader_mac, 6) == 0 ? &g_leader_link : nullptr;
+    if (g_group_cfg.role == VehicleRole::LEADER)
+    {
+        const int idx = find_follower(mac);
+        return idx >= 0 ? &g_followers[idx].up : nullptr;
+    }
+    return nullptr;
+}
+
+#if GROUP_RSSI_PROMISC
+// ESP-NOW 接收回调不带 RSSI（IDF 4.4），在混杂模式下从同一帧的 rx_ctrl 取得
+// ESP-NOW 帧为 802.11 Action 管理帧：帧控制 0xD0，源地址在偏移 10，帧体以类别 127 + OUI 18:FE:34 开头
+static void promisc_rx_callback(void *buf, wifi_promiscuous_pkt_type_t type)
+{
+    if (type != WIFI_PKT_MGMT)
+        return;
+    const wifi_promiscuous_pkt_t *pkt = static_cast<const wifi_promiscuous_pkt_t *>(buf);
+    const uint8_t *frame = pkt->payload;
+    if (pkt->rx_ctrl.sig_len < 28 || frame[0] != 0xD0 || frame[24] != 127 ||
+        frame[25] != 0x18 || frame[26] != 0xFE || frame[27] != 0x34)
+        return;
+    FleetLink *link = peer_link(frame + 10);
+    if (link)
+        link->on_rssi(static_cast<int8_t>(pkt->rx_ctrl.rssi));
+}
+#endif
+
+/********** 发送任务 **********/
+// 与上次发出的指令相比是否有变化；小于容差的抖动不算，累积超过容差仍会发出
+static bool tx_changed(const tx_item &item, const tx_item &sent)
+{
+    if (item.type != sent.type)
+        return true;
+    if (item.type == FLEET_MSG_MOTION)
+        return fabsf(item.u.motion.L_duty - sent.u.motion.L_duty) > GROUP_TX_DUTY_EPS ||
+               fabsf(item.u.motion.R_duty - sent.u.motion.R_duty) > GROUP_TX_DUTY_EPS;
+    const fleet_setpoint &a = item.u.sp;
+    const fleet_setpoint &b = sent.u.sp;
+    return a.flags != b.flags || a.offset != b.offset ||
+           fabsf(a.spd - b.spd) > GROUP_TX_VEL_EPS || fabsf(a.vel - b.vel) > GROUP_TX_VEL_EPS ||
+           fabsf(a.yaw_rate - b.yaw_rate) > GROUP_TX_YAW_EPS || fabsf(a.pos - b.pos) > GROUP_TX_POS_EPS;
+}
+
+// 发出一帧并等待发送回调，保证同一时刻只有一帧在途
+static void tx_send(const uint8_t *mac, fleet_msg_type type, const void *payload, size_t n)
+{
+    ulTaskNotifyTake(pdTRUE, 0); // 清掉上一帧超时后才到的完成通知
+    g_tx_start_us.store(micros(), std::memory_order_relaxed);
+    if (fleet_send(mac, type, payload, n) != ESP_OK)
+    {
+        g_tx_error.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(GROUP_TX_DONE_TIMEOUT_MS)) == 0)
+        g_tx_timeout.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 从车心跳：下行链路报告，丢包率取上一次心跳以来的区间值
+static void send_heartbeat()
+{
+    static FleetLossWindow loss_window;
+    const fleet_link_stats &st = g_leader_link.stats();
+    follower_heartbeat hb;
+    hb.battery_level = 0; // TODO: 获取实际电池电量
+    hb.down.loss_permille = static_cast<uint16_t>(loss_window.update(st) * 1000.0f + 0.5f);
+    hb.down.jitter_us = static_cast<uint16_t>(st.jitter_us < 0xFFFF ? st.jitter_us : 0xFFFF);
+    hb.down.rssi = st.rssi;
+    hb.down.rssi_min = st.rssi_min;
+    hb.down.rejected = static_cast<uint16_t>(st.rejected < 0xFFFF ? st.rejected : 0xFFFF);
+    tx_send(g_group_cfg.leader_mac, FLEET_MSG_HEARTBEAT, &hb, sizeof(hb));
+    g_tx_heartbeats.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 头车：指令变化即发（不超过 tx_max_hz），不变时每 GROUP_TX_KEEPALIVE_MS 重发最新一帧
+// 从车：每 HEARTBEAT_INTERVAL_MS 发心跳
+static void fleet_tx_task(void *)
+{
+    FleetTxSchedule sched(1000000u / g_group_cfg.tx_max_hz, GROUP_TX_KEEPALIVE_MS * 1000);
+    tx_item item, latest, sent;
+    bool has_latest = false, has_sent = false;
+    uint32_t last_hb_ms = millis();
+    const bool follower = g_group_cfg.role == VehicleRole::FOLLOWER;
+    for (;;)
+    {
+        sched.set_min_interval(1000000u / g_group_cfg.tx_max_hz);
+        uint32_t wait_ms = (sched.wait_us(micros()) + 999) / 1000;
+        if (follower)
+        {
+            const uint32_t since = millis() - last_hb_ms;
+            const uint32_t hb_wait = since >= HEARTBEAT_INTERVAL_MS ? 0 : HEARTBEAT_INTERVAL_MS - since;
+            if (hb_wait < wait_ms)
+                wait_ms = hb_wait;
+        }
+
+        if (xQueueReceive(g_tx_queue, &item, pdMS_TO_TICKS(wait_ms)) == pdTRUE)
+        {
+            sched.offer(!has_sent || tx_changed(item, sent));
+            latest = item; // 保活也发最新的一帧
+            has_latest = true;
+        }
+
+        const uint32_t now = micros();
+        if (has_latest && sched.due(now))
+        {
+            tx_send(g_broadcast_mac, latest.type, &latest.u,
+                    latest.type == FLEET_MSG_MOTION ? sizeof(motion_command) : sizeof(fleet_setpoint));
+            sched.sent(now);
+            sent = latest;
+            has_sent = true;
+        }
+        if (follower && millis() - last_hb_ms >= HEARTBEAT_INTERVAL_MS)
+        {
+            last_hb_ms = millis();
+            send_heartbeat();
+        }
+        g_tx_counts.publish(sched.counts());
+    }
+}
+
 /********** ESP-NOW初始化 **********/
 static bool espnow_init()
 {
@@ -301,6 +515,18 @@ static bool espnow_init()
         Serial.println();
     }
 
+#if GROUP_RSSI_PROMISC
+    // 只收管理帧，ESP-NOW 帧即在其中；数据帧不进回调，不影响 SoftAP 吞吐
+    wifi_promiscuous_filter_t filter = {};
+    filter.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT;
+    esp_wifi_set_promiscuous_filter(&filter);
+    esp_wifi_set_promiscuous_rx_cb(promisc_rx_callback);
+    if (esp_wifi_set_promiscuous(true) != ESP_OK)
+    {
+        Serial.println("[GROUP] Promiscuous mode failed, RSSI unavailable");
+    }
+#endif
+
     g_espnow_initialized = true;
     Serial.println("[GROUP] ESP-NOW initialized successfully");
     return true;
@@ -389,6 +615,10 @@ void my_group_espnow_init()
         g_group_cfg.espnow_enabled = false;
         return;
     }
+
+    // 发送任务：在控制任务创建前建好队列，控制任务只管投递
+    g_tx_queue = xQueueCreate(1, sizeof(tx_item));
+    xTaskCreatePinnedToCore(fleet_tx_task, "fleet_tx", 4096, nullptr, 8, &g_tx_task, 1);
     
     // 打印本机MAC地址
     uint8_t mac[6];
@@ -403,26 +633,54 @@ void my_group_espnow_init()
     Serial.println();
 }
 
+static void tx_post(const tx_item &item)
+{
+    xQueueOverwrite(g_tx_queue, &item); // 发送任务还没取走的旧指令直接被覆盖
+    g_tx_posted.fetch_add(1, std::memory_order_relaxed);
+}
+
 void my_group_send_command(float left_duty, float right_duty)
 {
     // 仅头车发送
-    if (g_group_cfg.role != VehicleRole::LEADER || !g_espnow_initialized)
+    if (g_group_cfg.role != VehicleRole::LEADER || !g_tx_queue)
     {
         return;
     }
 
-    motion_command cmd;
-    cmd.L_duty = left_duty;
-    cmd.R_duty = right_duty;
-    cmd.timestamp = millis();
-    cmd.group_id = g_group_cfg.group_id;
-    cmd.checksum = calculate_checksum(cmd);
+    tx_item item;
+    item.type = FLEET_MSG_MOTION;
+    item.u.motion.L_duty = left_duty;
+    item.u.motion.R_duty = right_duty;
+    tx_post(item);
+}
 
-    esp_err_t result = esp_now_send(g_broadcast_mac, (uint8_t *)&cmd, sizeof(cmd));
-    if (result != ESP_OK)
+void my_group_send_setpoint(const fleet_setpoint &sp)
+{
+    // 仅头车发送
+    if (g_group_cfg.role != VehicleRole::LEADER || !g_tx_queue)
     {
-        // 发送失败（可选：记录错误）
+        return;
     }
+
+    tx_item item;
+    item.type = FLEET_MSG_SETPOINT;
+    item.u.sp = sp;
+    tx_post(item);
+}
+
+void my_group_tx_stats(fleet_tx_stats &out)
+{
+    out.posted = g_tx_posted.load(std::memory_order_relaxed);
+    if (g_tx_counts.read(out.sched) == 0)
+        out.sched = fleet_tx_counts();
+    out.heartbeats = g_tx_heartbeats.load(std::memory_order_relaxed);
+    out.ok = g_tx_ok.load(std::memory_order_relaxed);
+    out.fail = g_tx_fail.load(std::memory_order_relaxed);
+    out.error = g_tx_error.load(std::memory_order_relaxed);
+    out.timeout = g_tx_timeout.load(std::memory_order_relaxed);
+    out.done_mean_us = g_tx_done_mean_us.load(std::memory_order_relaxed);
+    out.done_max_us = g_tx_done_max_us.load(std::memory_order_relaxed);
+    out.max_hz = g_group_cfg.tx_max_hz;
 }
 
 bool my_group_is_command_timeout()
@@ -449,34 +707,6 @@ bool my_group_espnow_is_ready()
     return g_espnow_initialized;
 }
 
-void my_group_send_heartbeat()
-{
-    // 仅从车发送心跳
-    if (g_group_cfg.role != VehicleRole::FOLLOWER || !g_espnow_initialized)
-    {
-        return;
-    }
-
-    uint32_t now = millis();
-    if (now - g_last_heartbeat_time < HEARTBEAT_INTERVAL_MS)
-    {
-        return; // 未到发送时间
-    }
-
-    follower_heartbeat hb;
-    my_group_get_mac(hb.follower_mac);
-    hb.group_id = g_group_cfg.group_id;
-    hb.timestamp = now;
-    hb.battery_level = 0; // TODO: 获取实际电池电量
-    hb.checksum = calculate_heartbeat_checksum(hb);
-
-    esp_err_t result = esp_now_send(g_group_cfg.leader_mac, (uint8_t *)&hb, sizeof(hb));
-    if (result == ESP_OK)
-    {
-        g_last_heartbeat_time = now;
-    }
-}
-
 int my_group_get_followers(follower_info *followers, int max_count)
 {
     if (g_group_cfg.role != VehicleRole::LEADER || followers == nullptr)
@@ -487,15 +717,22 @@ int my_group_get_followers(follower_info *followers, int max_count)
     int count = 0;
     for (int i = 0; i < g_follower_count && count < max_count; i++)
     {
-        if (g_followers[i].online)
-        {
-            followers[count++] = g_followers[i];
-        }
+        followers[count++] = g_followers[i];
     }
 
     return count;
 }
 
+void my_group_leader_link(fleet_link_stats &out)
+{
+    out = g_leader_link.stats();
+}
+
+void my_group_rx_errors(uint32_t (&out)[FLEET_ERR_COUNT])
+{
+    memcpy(out, g_rx_errors, sizeof(g_rx_errors));
+}
+
 void my_group_update_followers_status()
 {
     if (g_group_cfg.role != VehicleRole::LEADER)
@@ -0,0 +1,62 @@
+#include <Arduino.h>
+#include <atomic>
+#include "my_joy.h"
+#include "my_motion.h"
+#include "my_setpoint.h"
+
+namespace
+{
+    const ctl::SetpointParams Params = {
+        JOY_EXTRAP_MS * 1000, JOY_DEADMAN_MS * 1000, JOY_CLOCK_CREEP_US, JOY_CLOCK_RESYNC_MS * 1000,
+        JOY_TRACK_TAU, JOY_RATE_MAX, JOY_ACC_MAX, JOY_JERK_MAX, -1.0f, 1.0f,
+    };
+
+    // 以下仅控制任务访问
+    ctl::TimedSetpoint<2> gen(Params); // x, y
+    float angle = 0.0f;                // 方向角只做显示，取最新一帧
+
+    // 控制任务写，网络任务读
+    std::atomic<uint32_t> samples{0};
+    std::atomic<uint32_t> dropped{0};
+    std::atomic<uint32_t> deadman{0};
+    std::atomic<uint32_t> delay_us{0};
+}
+
+void my_joy_push(const joy_sample &s)
+{
+    const float v[2] = {s.x, s.y};
+    gen.push(v, s.sender_us, s.rx_us);
+    angle = s.a;
+    samples.store(samples.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    delay_us.store(gen.delay_us, std::memory_order_relaxed);
+}
+
+void my_joy_update()
+{
+    // 摔倒后丢弃当前目标，重新推杆才生效（fall_check 同时清零 robot.joy）
+    if (robot.fallen.is)
+        gen.reset();
+
+    float out[2];
+    if (gen.update(robot.tick.last_us, robot.tick.dt, out))
+    {
+        deadman.store(deadman.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        Serial.printf("[JOY] %ums 未收到摇杆帧，目标归零\n", static_cast<unsigned>(JOY_DEADMAN_MS));
+    }
+    robot.joy.x = out[0];
+    robot.joy.y = out[1];
+    robot.joy.a = gen.dead() ? 0.0f : angle;
+}
+
+void my_joy_dropped()
+{
+    dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void my_joy_stats(joy_stats &out)
+{
+    out.samples = samples.load(std::memory_order_relaxed);
+    out.dropped = dropped.load(std::memory_order_relaxed);
+    out.deadman = deadman.load(std::memory_order_relaxed);
+    out.delay_us = delay_us.load(std::memory_order_relaxed);
+}
@@ -4,12 +4,20 @@
 #include "my_control.h"
 #include "my_tool.h"
 #include "my_group.h"
-#include <LittleFS.h>
+#include "my_encoder.h"
+#include "my_perf.h"
+#include "my_blackbox.h"
+#include "my_autotune.h"
+#include "my_sched.h"
+#include "my_state.h"
+#include "my_joy.h"
+#include "my_fleet.h"
 
 robot_state robot = {
     // 状态指示位
     .dt_ms = 2,                // 运动控制频率
     .data_ms = 100,            // 网页推送频率
+    .tick = {0.002f, 0, 0, 0, 0, 0}, // dt, last_us, count, overrun, exec_us, exec_max_us
     .run = false,              // 运行指示位
     .chart_enable = false,     // 图表推送位
     .joy_stop_control = false, // 原地停车标志
@@ -50,26 +58,77 @@ robot_state robot = {
     .spd_pid = {0.003f, 0.00f, 0.00f, 100000, 5}, // 速度环参数
     .pos_pid = {0.00f, 0.00f, 0.00f, 100000, 5}, // 位置环参数
     .yaw_pid = {0.025f, 0.00f, 0.00f, 100000, 5}, // 偏航环参数：P为转向力度，D为阻尼
+    // 控制器选择与 LQR 增益（native_bench lqr 按默认物理参数算出）
+    .ctrl_mode = CTRL_MODE_PID,
+    .lqr = {{{0.690363f, 0.043111f, 0.764786f, 1.067670f, 0.0f},
+             {0.0f, 0.0f, 0.0f, 0.0f, -0.027088f}}},
+    // 增益调度：默认表全为 1（与手调参数一致），只开电压补偿；速度轴 0~30 rad/s，电压轴按 3S 电池
+    .sched = {1, 1, 30.0f, 10.5f, 12.6f, 12.0f,
+              {{1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}},
+              {{1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}}},
+    // 占空比映射：未测量前为空，按起转占空比 + 直线补偿
+    .motor_map = {0, {}, {}},
 };
 
+namespace
+{
+    // 节拍计时：每拍只取一次时间戳，得到实测周期供测速与 PID 使用
+    void tick_update()
+    {
+        const uint32_t now_us = micros();
+        const float nominal = robot.dt_ms * 0.001f;
+        const float dt = robot.tick.count ? static_cast<float>(now_us - robot.tick.last_us) * 1e-6f : nominal;
+        robot.tick.dt = my_lim(dt, 0.25f * nominal, 4.0f * nominal); // 防止长时间停顿后的异常 dt
+        robot.tick.last_us = now_us;
+        robot.tick.count++;
+    }
+}
+
 void my_motion_init()
 {
     my_mpu6050_init();
+    my_blackbox_init();
 
     my_motor_init();
 }
 
 void my_motion_update()
 {
+    my_perf_service();
+    const uint32_t t_begin = my_perf_now();
+    uint32_t tx_cycles = 0; // ESP-NOW 发送耗时，单独统计，不计入控制段
+    tick_update();
+    my_perf_add_us(PERF_PERIOD, static_cast<uint32_t>(robot.tick.dt * 1e6f));
+    // 其他任务投递的摇杆/参数/运行开关在此统一生效，本拍内不再变化
+    my_state_drain();
+    my_joy_update();
+    const uint32_t t_imu = my_perf_now();
+    const uint32_t cmd_cycles = t_imu - t_begin; // 命令生效计入控制段，不算 IMU
+
     my_mpu6050_update();
+    uint32_t t_stage = my_perf_record(PERF_IMU, t_imu);
+    my_encoder_update();
+    t_stage = my_perf_record(PERF_ENCODER, t_stage);
     // 更新robot状态数据
     robot_state_update();
 
+    // 增益调度与电压补偿（编队模式下同样需要电压补偿）
+    my_sched_update();
+
     // 获取当前车辆角色
     const group_config &group_cfg = my_group_get_config();
+    const bool fleet = group_cfg.espnow_enabled && group_cfg.role != VehicleRole::STANDALONE;
 
-    // 编队模式（头车或从车）：关闭PID，只根据摇杆直接控制
-    if (group_cfg.espnow_enabled && group_cfg.role != VehicleRole::STANDALONE)
+    // 设定值模式：头车广播设定值，从车叠加队形修正；之后两者都走下面的单机平衡控制
+    if (fleet && group_cfg.fleet_mode == FleetMode::SETPOINT)
+    {
+        const uint32_t t_tx = my_perf_now();
+        my_fleet_update();
+        tx_cycles += my_perf_now() - t_tx;
+    }
+
+    // 占空比模式（头车或从车）：关闭PID，只根据摇杆直接控制
+    if (fleet && group_cfg.fleet_mode == FleetMode::DUTY)
     {
         // 从车模式：使用接收到的指令
         if (group_cfg.role == VehicleRole::FOLLOWER)
@@ -84,10 +143,12 @@ void my_motion_update()
             }
             else
             {
-                // ESP-NOW回调已更新robot.motor.L_duty和R_duty
-                // 需要同步到motor_left_u和motor_right_u供my_motor_update使用
-                motor_left_u = robot.motor.L_duty;
-                motor_right_u = robot.motor.R_duty;
+                // ESP-NOW回调投递的指令已在拍首取出，
+                // 同步到motor_left_u和motor_right_u供my_motor_update使用
+                float left, right;
+                my_state_follower(left, right);
+                motor_left_u = left;
+                motor_right_u = right;
             }
         }
         // 头车模式：根据摇杆直接生成duty
@@ -112,7 +173,9 @@ void my_motion_update()
             motor_right_u = right_cmd;
             
             // 广播指令给从车
+            const uint32_t t_tx = my_perf_now();
             my_group_send_command(left_cmd, right_cmd);
+            tx_cycles += my_perf_now() - t_tx;
         }
 
         // 运行检查
@@ -132,12 +195,22 @@ void my_motion_update()
     }
     else
     {
-        // 单机模式：正常PID控制
+        // 单机模式 / 设定值模式：正常PID控制
         robot_pos_control();
-        pitch_control();
-        yaw_control();
-        duty_add();
-        pitch_zero_adapt();
+        control_mode_check();
+        my_autotune_update();
+        if (robot.ctrl_mode == CTRL_MODE_LQR)
+        {
+            lqr_control();
+            duty_add();
+        }
+        else
+        {
+            pitch_control();
+            yaw_control();
+            duty_add();
+            pitch_zero_adapt();
+        }
 
         // 摔倒检测
         fall_check();
@@ -151,14 +224,12 @@ void my_motion_update()
         }
     }
 
+    const uint32_t t_motor = my_perf_now();
+    my_perf_add_cycles(PERF_CONTROL, cmd_cycles + t_motor - t_stage - tx_cycles);
+
     // 电机执行（所有模式）
     my_motor_update();
-
-    // 从车：发送心跳给头车
-    if (group_cfg.role == VehicleRole::FOLLOWER && group_cfg.espnow_enabled)
-    {
-        my_group_send_heartbeat();
-    }
+    my_perf_record(PERF_MOTOR, t_motor);
 
     // 头车：更新从车在线状态
     if (group_cfg.role == VehicleRole::LEADER && group_cfg.espnow_enabled)
@@ -166,6 +237,18 @@ void my_motion_update()
         my_group_update_followers_status();
     }
 
+    // 黑匣子：记录本拍完整状态（joy_l 更新前，保留本拍摇杆）
+    my_blackbox_record();
+
     // 记录本帧摇杆，用于下次检测松杆/回零
     robot.joy_l = robot.joy;
+
+    // 本拍结果对遥测/网页可见
+    my_state_publish();
+
+    if (fleet)
+        my_perf_add_cycles(PERF_ESPNOW, tx_cycles);
+    const uint32_t t_end = my_perf_record(PERF_TOTAL, t_begin);
+    if (my_perf_cycles_to_us(t_end - t_begin) > static_cast<uint32_t>(robot.dt_ms) * 1000)
+        my_perf_late(); // 执行时间超过一个周期
 }
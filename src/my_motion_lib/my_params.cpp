@@ -1,5 +1,7 @@
 #include "my_params.h"
 #include "my_motion.h"
+#include "my_sched.h"
+#include "my_state.h"
 #include <Preferences.h>
 
 // NVS namespace
@@ -19,6 +21,11 @@ static constexpr const char *KEY_POS_D = "pos_d";
 static constexpr const char *KEY_YAW_P = "yaw_p";
 static constexpr const char *KEY_YAW_I = "yaw_i";
 static constexpr const char *KEY_YAW_D = "yaw_d";
+static constexpr const char *KEY_CTRL_MODE = "ctrl_mode";
+static constexpr const char *KEY_LQR_K = "lqr_k"; // LQR 增益矩阵，按行存 float[LQR_INPUTS][LQR_STATES]
+static constexpr const char *KEY_SCHED = "sched"; // 增益调度表，整体存 sched_config
+static constexpr const char *KEY_MOTOR_MAP = "motor_map"; // 占空比映射曲线，整体存 motor_map_config
+static constexpr const char *KEY_DEADZONE = "deadzone";   // 起转死区 float[MOTOR_CURVE_COUNT]
 
 /**
  * 保存机器人参数到NVS
@@ -26,6 +33,10 @@ static constexpr const char *KEY_YAW_D = "yaw_d";
  */
 bool my_params_save()
 {
+    // 从快照保存：控制任务正在改写 robot（重心自适应、曲线测量），不能直接读
+    static robot_state snap;
+    my_state_snapshot(snap);
+
     Preferences pref;
     if (!pref.begin(PARAMS_NVS_NAMESPACE, false))
     {
@@ -34,33 +45,48 @@ bool my_params_save()
     }
 
     // 保存pitch零点
-    pref.putFloat(KEY_PITCH_ZERO, robot.pitch_zero);
+    pref.putFloat(KEY_PITCH_ZERO, snap.pitch_zero);
     
     // 保存PID参数
-    pref.putFloat(KEY_ANG_P, robot.ang_pid.p);
-    pref.putFloat(KEY_ANG_I, robot.ang_pid.i);
-    pref.putFloat(KEY_ANG_D, robot.ang_pid.d);
+    pref.putFloat(KEY_ANG_P, snap.ang_pid.p);
+    pref.putFloat(KEY_ANG_I, snap.ang_pid.i);
+    pref.putFloat(KEY_ANG_D, snap.ang_pid.d);
     
-    pref.putFloat(KEY_SPD_P, robot.spd_pid.p);
-    pref.putFloat(KEY_SPD_I, robot.spd_pid.i);
-    pref.putFloat(KEY_SPD_D, robot.spd_pid.d);
+    pref.putFloat(KEY_SPD_P, snap.spd_pid.p);
+    pref.putFloat(KEY_SPD_I, snap.spd_pid.i);
+    pref.putFloat(KEY_SPD_D, snap.spd_pid.d);
     
-    pref.putFloat(KEY_POS_P, robot.pos_pid.p);
-    pref.putFloat(KEY_POS_I, robot.pos_pid.i);
-    pref.putFloat(KEY_POS_D, robot.pos_pid.d);
+    pref.putFloat(KEY_POS_P, snap.pos_pid.p);
+    pref.putFloat(KEY_POS_I, snap.pos_pid.i);
+    pref.putFloat(KEY_POS_D, snap.pos_pid.d);
     
-    pref.putFloat(KEY_YAW_P, robot.yaw_pid.p);
-    pref.putFloat(KEY_YAW_I, robot.yaw_pid.i);
-    pref.putFloat(KEY_YAW_D, robot.yaw_pid.d);
+    pref.putFloat(KEY_YAW_P, snap.yaw_pid.p);
+    pref.putFloat(KEY_YAW_I, snap.yaw_pid.i);
+    pref.putFloat(KEY_YAW_D, snap.yaw_pid.d);
+
+    // 保存控制器选择与LQR增益
+    pref.putUChar(KEY_CTRL_MODE, snap.ctrl_mode);
+    pref.putBytes(KEY_LQR_K, snap.lqr.k, sizeof(snap.lqr.k));
+
+    // 保存增益调度表
+    pref.putBytes(KEY_SCHED, &snap.sched, sizeof(snap.sched));
+
+    // 保存占空比映射曲线
+    pref.putBytes(KEY_MOTOR_MAP, &snap.motor_map, sizeof(snap.motor_map));
     
     pref.end();
     
     Serial.println("[PARAMS] Parameters saved to NVS");
-    Serial.printf("  pitch_zero: %.2f\n", robot.pitch_zero);
-    Serial.printf("  ang_pid: P=%.3f I=%.3f D=%.5f\n", robot.ang_pid.p, robot.ang_pid.i, robot.ang_pid.d);
-    Serial.printf("  spd_pid: P=%.5f I=%.5f D=%.5f\n", robot.spd_pid.p, robot.spd_pid.i, robot.spd_pid.d);
-    Serial.printf("  pos_pid: P=%.5f I=%.5f D=%.5f\n", robot.pos_pid.p, robot.pos_pid.i, robot.pos_pid.d);
-    Serial.printf("  yaw_pid: P=%.3f I=%.5f D=%.5f\n", robot.yaw_pid.p, robot.yaw_pid.i, robot.yaw_pid.d);
+    Serial.printf("  pitch_zero: %.2f\n", snap.pitch_zero);
+    Serial.printf("  ang_pid: P=%.3f I=%.3f D=%.5f\n", snap.ang_pid.p, snap.ang_pid.i, snap.ang_pid.d);
+    Serial.printf("  spd_pid: P=%.5f I=%.5f D=%.5f\n", snap.spd_pid.p, snap.spd_pid.i, snap.spd_pid.d);
+    Serial.printf("  pos_pid: P=%.5f I=%.5f D=%.5f\n", snap.pos_pid.p, snap.pos_pid.i, snap.pos_pid.d);
+    Serial.printf("  yaw_pid: P=%.3f I=%.5f D=%.5f\n", snap.yaw_pid.p, snap.yaw_pid.i, snap.yaw_pid.d);
+    Serial.printf("  ctrl: %s  lqr: [%.4f %.4f %.4f %.4f] yaw %.4f\n", snap.ctrl_mode == CTRL_MODE_LQR ? "LQR" : "PID",
+                  snap.lqr.k[0][0], snap.lqr.k[0][1], snap.lqr.k[0][2], snap.lqr.k[0][3], snap.lqr.k[1][4]);
+    Serial.printf("  sched: %s vcomp: %s v_nom=%.2f\n", snap.sched.enable ? "on" : "off", snap.sched.vcomp ? "on" : "off",
+                  snap.sched.v_nom);
+    Serial.printf("  motor_map: %s\n", snap.motor_map.enable ? "on" : "off");
     
     return true;
 }
@@ -105,6 +131,23 @@ bool my_params_load()
     robot.yaw_pid.p = pref.getFloat(KEY_YAW_P, robot.yaw_pid.p);
     robot.yaw_pid.i = pref.getFloat(KEY_YAW_I, robot.yaw_pid.i);
     robot.yaw_pid.d = pref.getFloat(KEY_YAW_D, robot.yaw_pid.d);
+
+    // 控制器选择与LQR增益（旧版本没有这两项时保持默认值；矩阵尺寸不符则丢弃）
+    const uint8_t mode = pref.getUChar(KEY_CTRL_MODE, robot.ctrl_mode);
+    robot.ctrl_mode = mode == CTRL_MODE_LQR ? CTRL_MODE_LQR : CTRL_MODE_PID;
+    if (pref.getBytesLength(KEY_LQR_K) == sizeof(robot.lqr.k))
+        pref.getBytes(KEY_LQR_K, robot.lqr.k, sizeof(robot.lqr.k));
+
+    // 增益调度表（表尺寸改变后长度不符，丢弃并用默认表）
+    if (pref.getBytesLength(KEY_SCHED) == sizeof(robot.sched))
+    {
+        pref.getBytes(KEY_SCHED, &robot.sched, sizeof(robot.sched));
+        my_sched_request_reload();
+    }
+
+    // 占空比映射曲线（点数改变后长度不符，丢弃并回到直线补偿）
+    if (pref.getBytesLength(KEY_MOTOR_MAP) == sizeof(robot.motor_map))
+        pref.getBytes(KEY_MOTOR_MAP, &robot.motor_map, sizeof(robot.motor_map));
     
     pref.end();
     
@@ -114,10 +157,41 @@ bool my_params_load()
     Serial.printf("  spd_pid: P=%.5f I=%.5f D=%.5f\n", robot.spd_pid.p, robot.spd_pid.i, robot.spd_pid.d);
     Serial.printf("  pos_pid: P=%.5f I=%.5f D=%.5f\n", robot.pos_pid.p, robot.pos_pid.i, robot.pos_pid.d);
     Serial.printf("  yaw_pid: P=%.3f I=%.5f D=%.5f\n", robot.yaw_pid.p, robot.yaw_pid.i, robot.yaw_pid.d);
+    Serial.printf("  ctrl: %s  lqr: [%.4f %.4f %.4f %.4f] yaw %.4f\n", robot.ctrl_mode == CTRL_MODE_LQR ? "LQR" : "PID",
+                  robot.lqr.k[0][0], robot.lqr.k[0][1], robot.lqr.k[0][2], robot.lqr.k[0][3], robot.lqr.k[1][4]);
+    Serial.printf("  sched: %s vcomp: %s v_nom=%.2f\n", robot.sched.enable ? "on" : "off", robot.sched.vcomp ? "on" : "off",
+                  robot.sched.v_nom);
+    Serial.printf("  motor_map: %s\n", robot.motor_map.enable ? "on" : "off");
     
     return true;
 }
 
+bool my_params_load_deadzone(float (&dz)[MOTOR_CURVE_COUNT])
+{
+    Preferences pref;
+    if (!pref.begin(PARAMS_NVS_NAMESPACE, true))
+        return false;
+    const bool ok = pref.getBytesLength(KEY_DEADZONE) == sizeof(dz);
+    if (ok)
+        pref.getBytes(KEY_DEADZONE, dz, sizeof(dz));
+    pref.end();
+    return ok;
+}
+
+bool my_params_save_deadzone(const float (&dz)[MOTOR_CURVE_COUNT])
+{
+    Preferences pref;
+    if (!pref.begin(PARAMS_NVS_NAMESPACE, false))
+    {
+        Serial.println("[PARAMS] Failed to open NVS for writing");
+        return false;
+    }
+    const bool ok = pref.putBytes(KEY_DEADZONE, dz, sizeof(dz)) == sizeof(dz);
+    pref.end();
+    Serial.printf("[PARAMS] deadzone %s: L %.3f/%.3f R %.3f/%.3f\n", ok ? "saved" : "save failed", dz[0], dz[1], dz[2], dz[3]);
+    return ok;
+}
+
 /**
  * 清除NVS中保存的参数（恢复默认值）
  * @return true 成功, false 失败
@@ -0,0 +1,55 @@
+#include <atomic>
+#include <math.h>
+#include "my_sched.h"
+#include "my_motion.h"
+#include "my_bat.h"
+#include "my_tool.h"
+#include "my_table.h"
+#include "my_autotune.h"
+
+float sched_ang_gain = 1.0f;
+float sched_spd_gain = 1.0f;
+float sched_vcomp = 1.0f;
+float sched_vbat = 0.0f;
+
+namespace
+{
+    using SchedGrid = ctl::Grid2D<SCHED_SPD_POINTS, SCHED_BAT_POINTS>;
+
+    SchedGrid grid;
+    std::atomic<bool> reload_request{true}; // 首拍按 robot.sched（默认值或 NVS）建立轴
+}
+
+void my_sched_request_reload()
+{
+    reload_request.store(true, std::memory_order_release);
+}
+
+void my_sched_update()
+{
+    const sched_config &s = robot.sched;
+    if (reload_request.exchange(false, std::memory_order_acquire))
+    {
+        grid.x.set(0.0f, s.spd_max);
+        grid.y.set(s.bat_min, s.bat_max);
+    }
+
+    // 电池电压由其他任务刷新，单次 ADC 采样噪声大，低通后再用
+    const float dt = robot.dt_ms * 0.001f;
+    const float v = battery_voltage;
+    sched_vbat = sched_vbat > 0.0f ? sched_vbat + (v - sched_vbat) * (dt / (SCHED_BAT_TAU_S + dt)) : v;
+    const bool vbat_ok = sched_vbat >= SCHED_BAT_VALID_MIN;
+
+    sched_vcomp = (s.vcomp && vbat_ok) ? my_lim(s.v_nom / sched_vbat, SCHED_VCOMP_MIN, SCHED_VCOMP_MAX) : 1.0f;
+
+    if (!s.enable || my_autotune_active())
+    {
+        sched_ang_gain = 1.0f;
+        sched_spd_gain = 1.0f;
+        return;
+    }
+    // 两张表共用一次定位
+    const SchedGrid::Cell c = grid.locate(fabsf(robot.spd.now), vbat_ok ? sched_vbat : s.v_nom);
+    sched_ang_gain = SchedGrid::lookup(s.ang, c);
+    sched_spd_gain = SchedGrid::lookup(s.spd, c);
+}
@@ -0,0 +1,225 @@
+#include <atomic>
+#include "my_state.h"
+#include "my_motion.h"
+#include "my_control.h"
+#include "my_joy.h"
+#include "my_fleet.h"
+#include "my_sched.h"
+#include "my_seqlock.h"
+
+namespace
+{
+    struct duty_cmd
+    {
+        float left, right;
+    };
+
+    struct fleet_cmd
+    {
+        fleet_setpoint sp;
+        uint32_t tx_us, rx_us;
+    };
+
+    template <typename T>
+    struct saved_cmd
+    {
+        T value;
+        bool save;
+    };
+
+    lockfree::Snapshot<robot_state> snapshot;
+
+    lockfree::SpscQueue<joy_sample, JOY_QUEUE_LEN> joy_queue; // 网络任务投递，每帧都按序处理
+    lockfree::Mailbox<uint8_t> run_box;                       // 网络任务投递
+    lockfree::Mailbox<saved_cmd<pid_gains>> pid_box;          // 网络任务投递
+    lockfree::Mailbox<saved_cmd<lqr_gains>> lqr_box;          // 网络任务投递
+    lockfree::Mailbox<saved_cmd<sched_config>> sched_box;     // 网络任务投递
+    lockfree::Mailbox<saved_cmd<float>> pitch_zero_box;       // 网络任务投递
+    lockfree::Mailbox<duty_cmd> follower_box;                 // ESP-NOW 回调投递
+    lockfree::Mailbox<fleet_cmd> fleet_box;                   // ESP-NOW 回调投递（设定值约 50Hz，远低于取件频率）
+
+    std::atomic<bool> save_request{false};
+
+    // 以下仅网络任务访问：最近一次投递的参数
+    bool pid_posted = false;
+    pid_gains pid_last;
+    bool lqr_posted = false;
+    lqr_gains lqr_last;
+    bool sched_posted = false;
+    sched_config sched_last;
+    robot_state net_snap;
+
+    // 以下仅控制任务访问
+    duty_cmd follower = {0.0f, 0.0f};
+    bool save_after_publish = false; // 本拍生效的命令要求保存：等快照发布后再通知遥测任务，保存读到的是新值
+}
+
+void my_state_drain()
+{
+    // 设定值模式的从车由头车驱动，网页摇杆帧取出后丢弃
+    const bool fleet_follower = my_fleet_follower();
+    joy_sample joy;
+    while (joy_queue.pop(joy))
+        if (!fleet_follower)
+            my_joy_push(joy);
+    fleet_cmd fleet;
+    if (fleet_box.take(fleet) && fleet_follower)
+        my_fleet_push(fleet.sp, fleet.tx_us, fleet.rx_us);
+
+    uint8_t run;
+    if (run_box.take(run))
+        robot.run = run != 0;
+
+    bool save = false;
+    saved_cmd<pid_gains> pid;
+    if (pid_box.take(pid))
+    {
+        robot.ang_pid = pid.value.ang;
+        robot.spd_pid = pid.value.spd;
+        robot.pos_pid = pid.value.pos;
+        robot.yaw_pid = pid.value.yaw;
+        pid_state_update();
+        save |= pid.save;
+    }
+
+    saved_cmd<lqr_gains> lqr;
+    if (lqr_box.take(lqr))
+    {
+        robot.ctrl_mode = lqr.value.ctrl_mode;
+        robot.lqr = lqr.value.lqr;
+        save |= lqr.save;
+    }
+
+    saved_cmd<sched_config> sched;
+    if (sched_box.take(sched))
+    {
+        robot.sched = sched.value;
+        my_sched_request_reload();
+        save |= sched.save;
+    }
+
+    saved_cmd<float> zero;
+    if (pitch_zero_box.take(zero))
+    {
+        robot.pitch_zero = zero.value;
+        save |= zero.save;
+    }
+    if (save)
+        save_after_publish = true;
+
+    follower_box.take(follower);
+}
+
+void my_state_publish()
+{
+    snapshot.publish(robot);
+    if (save_after_publish)
+    {
+        save_after_publish = false;
+        save_request.store(true, std::memory_order_release);
+    }
+}
+
+void my_state_follower(float &left, float &right)
+{
+    left = follower.left;
+    right = follower.right;
+}
+
+uint32_t my_state_snapshot(robot_state &out)
+{
+    const uint32_t n = snapshot.read(out);
+    if (n == 0)
+        out = robot; // 控制任务启动前 robot 只在初始化时写入
+    return n;
+}
+
+void my_cmd_joystick(const joy_sample &s)
+{
+    if (!joy_queue.push(s))
+        my_joy_dropped();
+}
+
+void my_cmd_run(bool run)
+{
+    run_box.post(run ? 1 : 0);
+}
+
+void my_cmd_pid(const pid_gains &g, bool save)
+{
+    pid_last = g;
+    pid_posted = true;
+    pid_box.post({g, save});
+}
+
+void my_cmd_lqr(const lqr_gains &g, bool save)
+{
+    lqr_last = g;
+    lqr_posted = true;
+    lqr_box.post({g, save});
+}
+
+void my_cmd_sched(const sched_config &s, bool save)
+{
+    sched_last = s;
+    sched_posted = true;
+    sched_box.post({s, save});
+}
+
+void my_cmd_pitch_zero(float zero, bool save)
+{
+    pitch_zero_box.post({zero, save});
+}
+
+void my_state_request_save()
+{
+    save_request.store(true, std::memory_order_release);
+}
+
+void my_state_pid(pid_gains &out)
+{
+    if (pid_posted)
+    {
+        out = pid_last;
+        return;
+    }
+    my_state_snapshot(net_snap);
+    out = {net_snap.ang_pid, net_snap.spd_pid, net_snap.pos_pid, net_snap.yaw_pid};
+}
+
+void my_state_lqr(lqr_gains &out)
+{
+    if (lqr_posted)
+    {
+        out = lqr_last;
+        return;
+    }
+    my_state_snapshot(net_snap);
+    out = {net_snap.ctrl_mode, net_snap.lqr};
+}
+
+void my_state_sched(sched_config &out)
+{
+    if (sched_posted)
+    {
+        out = sched_last;
+        return;
+    }
+    my_state_snapshot(net_snap);
+    out = net_snap.sched;
+}
+
+void my_cmd_follower(float left, float right)
+{
+    follower_box.post({left, right});
+}
+
+void my_cmd_fleet_setpoint(const fleet_setpoint &sp, uint32_t tx_us, uint32_t rx_us)
+{
+    fleet_box.post({sp, tx_us, rx_us});
+}
+
+bool my_state_take_save_request()
+{
+    return save_request.exchange(false, std::memory_order_acquire);
+}
@@ -13,13 +13,87 @@
 // 以下是参数定义
 // web刷新限制
 #define REFRESH_RATE_DEF 10
-#define REFRESH_RATE_MAX 60
+#define REFRESH_RATE_MAX 200
 #define REFRESH_RATE_MIN 1
 
+// 二进制遥测帧（小端）：帧头 + 帧体（my_telem_codec.h）
+// 通道依次为 TELEM_FIELDS，flags 含 TELEM_FLAG_CHART 时再按 bit5-7 追加订阅的曲线组（每组 3 路）
+// 关键帧帧体为各通道量化后的 int32，差分帧为相对该客户端上一帧的变长差值
+// 布局变化必须提升 TELEM_VERSION，并同步 ui_config 中的 telem 描述
+#define TELEM_MAGIC 0xA5
+#define TELEM_VERSION 3
+#define TELEM_FLAG_FALLEN 0x01
+#define TELEM_FLAG_CHART 0x02
+#define TELEM_BBX_SHIFT 2 // bit2-3：黑匣子状态
+#define TELEM_FLAG_KEY 0x10
+#define TELEM_GROUP_SHIFT 5 // bit5-7：曲线组掩码
+#define TELEM_FIELD_COUNT 4
+#define TELEM_CHART_COUNT 9
+#define TELEM_KEY_INTERVAL 100 // 至少每 100 帧一个关键帧
+#define TELEM_GROUP_MS 500 // 车队状态仍走 JSON，限频发送
+#define GROUP_STATUS_PAGE 3 // 车队状态每条消息最多带的从车数，单条不超过 WS_POOL_BYTES
+
+// 广播缓冲池：客户端队列（WS_MAX_QUEUED_MESSAGES）堆满前足够轮转，全忙时丢帧而不是新分配
+#define WS_POOL_COUNT 24
+#define WS_POOL_BYTES 512
+
+// 每客户端订阅：频率在 [REFRESH_RATE_MIN, 客户端请求值] 内按拥塞自适应
+#define WS_CLIENT_SLOTS 4      // 同时推送遥测的客户端数
+#define WS_QUEUE_HIGH 4        // 发送队列达到该深度即减半频率，达到两倍时丢帧
+#define TELEM_LAT_HIGH_MS 200  // 回执延迟高于该值减半频率
+#define TELEM_LAT_LOW_MS 80    // 低于该值且队列空闲时逐步恢复
+#define TELEM_ADAPT_MS 250     // 调整间隔
+
+struct __attribute__((packed)) telem_frame_head
+{
+    uint8_t magic;
+    uint8_t version;
+    uint8_t flags;
+    uint8_t count; // 通道数
+    uint32_t seq;
+    uint32_t t_ms;
+};
+static_assert(sizeof(telem_frame_head) == 12, "telem_frame_head layout");
+
+static constexpr int CHART_COUNT = 3;
+
+// 遥测任务每次采样的全部通道，按客户端订阅挑选后编码
+struct telem_sample
+{
+    float v[TELEM_FIELD_COUNT + TELEM_CHART_COUNT];
+    float step[TELEM_FIELD_COUNT + TELEM_CHART_COUNT];
+    uint8_t flags; // 摔倒 + 黑匣子状态
+    uint32_t t_ms;
+};
+
+struct ws_client_stats
+{
+    uint32_t sent;
+    uint32_t dropped;  // 到期但队列满 / 缓冲池全忙
+    uint32_t backoffs; // 降速次数
+    uint32_t keys;
+    uint32_t bytes;
+    uint16_t hz;       // 当前实际频率
+    uint16_t lat_ms;   // 回执延迟
+    uint8_t queue;     // 发送队列深度
+};
+
+// 遥测路径的堆分配统计：build = 取池缓冲 + 编码，send = 入客户端队列（库内部 deque 节点）
+struct telem_alloc_stats
+{
+    uint32_t frames;
+    uint32_t build_allocs;
+    uint32_t send_allocs;
+    uint32_t alloc_frames; // 编码阶段发生过分配的帧数，稳态应为 0
+    uint32_t last_build;
+    uint32_t last_send;
+};
+
 struct ChartConfig
 {
     const char *title;
     const char *legend[3];
+    float step[3]; // 遥测量化精度
 };
 
 struct SliderGroup
@@ -31,19 +105,46 @@ struct SliderGroup
 // 异步服务器对象
 extern AsyncWebServer server;
 extern AsyncWebSocket ws;
+extern ChartConfig chart_config[CHART_COUNT];
 
 void web_pid_set(JsonObject param);
 void web_pid_get(AsyncWebSocketClient *c);
-void web_joystick(float x, float y, float a);
+void web_lqr_set(JsonObject param);
+void web_lqr_fill(JsonDocument &doc);
+bool web_sched_set(JsonObject param); // 参数非法时不修改并返回 false
+void web_sched_fill(JsonDocument &doc);
+void web_motor_map_fill(JsonDocument &doc);
+bool web_motor_map_cmd(JsonObject param); // 配置有变化时返回 true
+void web_motor_map_update();
+void web_joystick(float x, float y, float a, uint32_t sender_us, uint32_t rx_us);
 void web_group_config_set(JsonObject param);
 void web_group_config_get(AsyncWebSocketClient *c);
+void web_loop_stats_fill(JsonDocument &doc);
+void web_blackbox_fill(JsonDocument &doc);
+void web_blackbox_cmd(JsonObject param);
+void web_autotune_fill(JsonDocument &doc);
+bool web_autotune_cmd(JsonObject param); // apply 成功返回 true
+void web_autotune_update();
 // fs函数
 static String contentType(const String &path);
 // webtool函数
 void wsSendTo(AsyncWebSocketClient *c, const JsonDocument &doc);
 void my_wsheart();
-bool wsCanBroadcast();
-void wsBroadcast(const JsonDocument &doc);
+void wsCleanupClients(); // 限频清理断开的客户端
+void wsBroadcast(const JsonDocument &doc); // 跳过队列已满的客户端
+void wsPoolInit();
+AsyncWebSocketSharedBuffer wsPoolAcquire(size_t len); // 全忙返回空；超过 WS_POOL_BYTES 临时分配
+uint32_t wsPoolMiss();
+uint32_t wsPoolOversize();
+void web_telem_schema(JsonObject o);
+// 客户端订阅（my_web_client.cpp）
+void ws_client_attach(AsyncWebSocketClient *c);
+void ws_client_detach(uint32_t id);
+void ws_client_set_rate(uint32_t id, int hz);
+void ws_client_set_groups(uint32_t id, uint8_t groups);
+void ws_client_ack(uint32_t id, uint32_t t_ms);
+uint32_t ws_clients_publish(const telem_sample &smp); // 返回下次调用间隔（ms）
+void ws_clients_stats_fill(JsonObject o);
 bool handleFileRead(AsyncWebServerRequest *req, String path);
 // tool函数
 float my_db(float value, float deadband);
@@ -4,17 +4,19 @@
 #include "my_rgb.h"
 #include "my_bat.h"
 #include "my_params.h"
+#include "my_perf.h"
+#include "my_blackbox.h"
 // ======================= 内部状态 =======================
 // Web/WS 服务实例（仅本翻译单元可见）
 AsyncWebServer server(80);
 AsyncWebSocket ws("/ws");
+static robot_state web_snap; // 仅 async_tcp 任务：回显用的 robot 快照
 
-static constexpr int CHART_COUNT = 3;
 static constexpr int SLIDER_GROUP_COUNT = 4;
 
-ChartConfig chart_config[CHART_COUNT] = {{CHART_NAME1, {CHART_NAME11, CHART_NAME12, CHART_NAME13}},
-                                         {CHART_NAME2, {CHART_NAME21, CHART_NAME22, CHART_NAME23}},
-                                         {CHART_NAME3, {CHART_NAME31, CHART_NAME32, CHART_NAME33}}};
+ChartConfig chart_config[CHART_COUNT] = {{CHART_NAME1, {CHART_NAME11, CHART_NAME12, CHART_NAME13}, CHART_STEP1},
+                                         {CHART_NAME2, {CHART_NAME21, CHART_NAME22, CHART_NAME23}, CHART_STEP2},
+                                         {CHART_NAME3, {CHART_NAME31, CHART_NAME32, CHART_NAME33}, CHART_STEP3}};
 
 SliderGroup slider_group[SLIDER_GROUP_COUNT] = {{SLIDER_NAME1, {SLIDER_NAME11, SLIDER_NAME12, SLIDER_NAME13}},
                                                 {SLIDER_NAME2, {SLIDER_NAME21, SLIDER_NAME22, SLIDER_NAME23}},
@@ -94,6 +96,8 @@ void we_evt_connect(AsyncWebSocket *s, AsyncWebSocketClient *c, AwsEventType typ
     rgb_state["mode"] = robot.rgb.mode;
     rgb_state["count"] = robot.rgb.rgb_count;
     rgb["max_count"] = RGB_LED_COUNT;
+    // 二进制遥测帧格式
+    web_telem_schema(doc["telem"].to<JsonObject>());
     doc.shrinkToFit(); // 发送前收紧空间，减轻带宽
     // 先发 ui_config（首连一次，配置标题/图例/分组名称）
     wsSendTo(c, doc);
@@ -102,12 +106,14 @@ void we_evt_connect(AsyncWebSocket *s, AsyncWebSocketClient *c, AwsEventType typ
     ack["type"] = "info";
     ack["text"] = "已就绪";
     wsSendTo(c, ack);
+    // 分配遥测订阅槽，首帧为关键帧
+    ws_client_attach(c);
 }
 
 // 断联事件
 void we_evt_disconnect(AsyncWebSocket *s, AsyncWebSocketClient *c, AwsEventType type, void *arg, uint8_t *data, size_t len)
 {
-    // 可按需记录日志或清理该 client 的状态
+    ws_client_detach(c->id());
 }
 
 // 消息事件
@@ -126,22 +132,31 @@ void ws_evt_data(AsyncWebSocket *s, AsyncWebSocketClient *c, AwsEventType type,
         return;
     if (!*typeStr)
         return;
+    // 遥测回执频繁且只含时间戳，不打印
+    if (!strcmp(typeStr, "telem_ack"))
+    {
+        ws_client_ack(c->id(), doc["t"] | 0u);
+        return;
+    }
     // 调试用
     Serial.println("--- Printing JsonDocument ---");
     serializeJsonPretty(doc, Serial);
 
     // ===========逻辑处理区域===========
-    // 1) 设置遥测频率（上限锁 60Hz，避免队列堆积）
+    // 1) 设置本客户端遥测频率上限（实际频率按拥塞自适应）
     if (!strcmp(typeStr, "telem_hz"))
-        robot.data_ms = 1000 / my_lim(doc["ms"], REFRESH_RATE_MIN, REFRESH_RATE_MAX);
+        ws_client_set_rate(c->id(), doc["ms"] | REFRESH_RATE_DEF);
 
     // 2) 运行开关（只影响执行器；不影响遥测是否发送）
     else if (!strcmp(typeStr, "robot_run"))
-        robot.run = doc["running"] | false; // 默认关闭
+        my_cmd_run(doc["running"] | false); // 默认关闭；下一拍拍首生效
 
-    // 3) 图表推送开关（关闭时后台仅发 3 路，显著减载）
+    // 3) 本客户端图表推送开关，groups 为曲线组掩码（缺省全部）；同时作为新连接的初值
     else if (!strcmp(typeStr, "charts_send"))
+    {
         robot.chart_enable = doc["on"] | false; // 默认关闭
+        ws_client_set_groups(c->id(), robot.chart_enable ? (doc["groups"] | 0x07) : 0);
+    }
 
     // 4) 摔倒检测开关
     else if (!strcmp(typeStr, "fall_check"))
@@ -153,7 +168,14 @@ void ws_evt_data(AsyncWebSocket *s, AsyncWebSocketClient *c, AwsEventType type,
 
     // 6) 摇杆
     else if (!strcmp(typeStr, "joy"))
-        web_joystick(doc["x"] | 0.0f, doc["y"] | 0.0f, doc["a"] | 0.0f);
+    {
+        // t 为网页 performance.now()（ms），换算为 us 并按 uint32 回绕；旧页面不带 t 时以到达时刻代替
+        const uint32_t rx_us = micros();
+        const uint32_t sender_us = doc["t"].is<double>()
+                                       ? static_cast<uint32_t>(static_cast<uint64_t>(doc["t"].as<double>() * 1000.0))
+                                       : rx_us;
+        web_joystick(doc["x"] | 0.0f, doc["y"] | 0.0f, doc["a"] | 0.0f, sender_us, rx_us);
+    }
 
     // 7) 设置 PID
     else if (!strcmp(typeStr, "set_pid"))
@@ -172,38 +194,34 @@ void ws_evt_data(AsyncWebSocket *s, AsyncWebSocketClient *c, AwsEventType type,
         out["type"] = "rgb_state";
         out["mode"] = robot.rgb.mode;
         out["count"] = robot.rgb.rgb_count;
-        if (wsCanBroadcast())
-            wsBroadcast(out);
-        else
-            wsSendTo(c, out);
+        wsBroadcast(out);
     }
 
     // 设置pitch零点
     else if (!strcmp(typeStr, "pitch_zero_set"))
     {
-        float new_zero = doc["value"] | robot.pitch_zero;
+        my_state_snapshot(web_snap);
+        float new_zero = doc["value"] | web_snap.pitch_zero;
         // 限制范围在 -5 到 +5 度
-        robot.pitch_zero = constrain(new_zero, -5.0f, 5.0f);
-        
-        // 保存到NVS
-        my_params_save();
-        
+        new_zero = constrain(new_zero, -5.0f, 5.0f);
+
+        // 控制任务下一拍生效（与重心自适应在同一任务中修改），之后由遥测任务保存到NVS
+        my_cmd_pitch_zero(new_zero, true);
+
         JsonDocument out;
         out["type"] = "pitch_zero_state";
-        out["value"] = robot.pitch_zero;
+        out["value"] = new_zero;
         out["saved"] = true;  // 标记已保存
-        if (wsCanBroadcast())
-            wsBroadcast(out);
-        else
-            wsSendTo(c, out);
+        wsBroadcast(out);
     }
 
     // 获取当前pitch_zero值
     else if (!strcmp(typeStr, "get_pitch_zero"))
     {
+        my_state_snapshot(web_snap);
         JsonDocument out;
         out["type"] = "pitch_zero_state";
-        out["value"] = robot.pitch_zero;
+        out["value"] = web_snap.pitch_zero;
         wsSendTo(c, out);
     }
 
@@ -215,7 +233,78 @@ void ws_evt_data(AsyncWebSocket *s, AsyncWebSocketClient *c, AwsEventType type,
     else if (!strcmp(typeStr, "get_group_config"))
         web_group_config_get(c);
     
-    // 11) 系统重启
+    // 11) 控制环耗时统计（reset=true 时同时清零）
+    else if (!strcmp(typeStr, "loop_stats"))
+    {
+        JsonDocument out;
+        web_loop_stats_fill(out);
+        wsSendTo(c, out);
+        if (doc["reset"] | false)
+            my_perf_request_reset();
+    }
+
+    // 12) 黑匣子：布防/触发/停止，回复当前状态（指令在下一拍生效，前端随后可再查询）
+    else if (!strcmp(typeStr, "blackbox"))
+    {
+        web_blackbox_cmd(doc.as<JsonObject>());
+        JsonDocument out;
+        web_blackbox_fill(out);
+        wsSendTo(c, out);
+    }
+
+    // 13) 控制器选择 / LQR 增益（写入后存 NVS，回复全部客户端）；get_lqr 只回复本客户端
+    else if (!strcmp(typeStr, "lqr_set") || !strcmp(typeStr, "get_lqr"))
+    {
+        const bool set = !strcmp(typeStr, "lqr_set");
+        if (set)
+            web_lqr_set(doc["param"].as<JsonObject>());
+        JsonDocument out;
+        web_lqr_fill(out);
+        if (set)
+            wsBroadcast(out);
+        else
+            wsSendTo(c, out);
+    }
+
+    // 14) 自整定：start/abort/apply/status，回复当前进度；apply 成功后回发新的 PID 参数
+    else if (!strcmp(typeStr, "autotune"))
+    {
+        const bool applied = web_autotune_cmd(doc.as<JsonObject>());
+        JsonDocument out;
+        web_autotune_fill(out);
+        wsSendTo(c, out);
+        if (applied)
+            web_pid_get(c);
+    }
+
+    // 15) 增益调度表（写入后存 NVS，回复全部客户端）；get_sched 只回复本客户端
+    else if (!strcmp(typeStr, "sched_set") || !strcmp(typeStr, "get_sched"))
+    {
+        const bool set = !strcmp(typeStr, "sched_set");
+        const bool ok = !set || web_sched_set(doc["param"].as<JsonObject>());
+        JsonDocument out;
+        web_sched_fill(out);
+        if (!ok)
+            out["error"] = "参数非法，未修改";
+        if (set && ok)
+            wsBroadcast(out);
+        else
+            wsSendTo(c, out);
+    }
+
+    // 16) 占空比映射与死区：measure/abort/enable/disable/save/calibrate/status，开关或保存后回复全部客户端
+    else if (!strcmp(typeStr, "motor_map"))
+    {
+        const bool changed = web_motor_map_cmd(doc.as<JsonObject>());
+        JsonDocument out;
+        web_motor_map_fill(out);
+        if (changed)
+            wsBroadcast(out);
+        else
+            wsSendTo(c, out);
+    }
+
+    // 17) 系统重启
     else if (!strcmp(typeStr, "system_restart"))
     {
         Serial.println("[WEB] System restart requested");
@@ -280,7 +369,8 @@ static void handleApiState(AsyncWebServerRequest *req)
     d["rgb_mode"] = clamp_rgb_mode(robot.rgb.mode);
     d["rgb_count"] = clamp_rgb_count(robot.rgb.rgb_count);
     d["rgb_max"] = RGB_LED_COUNT;
-    d["pitch_zero"] = robot.pitch_zero;
+    my_state_snapshot(web_snap);
+    d["pitch_zero"] = web_snap.pitch_zero;
     JsonObject w = d["wifi"].to<JsonObject>();
     const auto &cfg = wifi_current_config();
     w["ssid"] = cfg.ssid;
@@ -292,6 +382,46 @@ static void handleApiState(AsyncWebServerRequest *req)
     req->send(200, "application/json; charset=utf-8", s);
 }
 
+static void handleApiPerf(AsyncWebServerRequest *req)
+{
+    JsonDocument d;
+    String s;
+    web_loop_stats_fill(d);
+    if (req->hasParam("reset"))
+        my_perf_request_reset();
+    serializeJson(d, s);
+    req->send(200, "application/json; charset=utf-8", s);
+}
+
+static void handleApiBlackbox(AsyncWebServerRequest *req)
+{
+    JsonDocument d;
+    String s;
+    web_blackbox_fill(d);
+    serializeJson(d, s);
+    req->send(200, "application/json; charset=utf-8", s);
+}
+
+// 冻结窗口直接从缓冲分块发送，不做整体拷贝；下载期间重新布防会使本次下载提前结束
+static void handleApiBlackboxData(AsyncWebServerRequest *req)
+{
+    size_t total = 0;
+    my_blackbox_read(nullptr, 0, 0, total);
+    if (!total)
+    {
+        req->send(409, "text/plain; charset=utf-8", "blackbox not frozen");
+        return;
+    }
+    AsyncWebServerResponse *resp = req->beginResponse("application/octet-stream", total,
+                                                      [](uint8_t *buf, size_t maxLen, size_t index) -> size_t
+                                                      {
+                                                          size_t t = 0;
+                                                          return my_blackbox_read(buf, maxLen, index, t);
+                                                      });
+    resp->addHeader("Content-Disposition", "attachment; filename=blackbox.bbx");
+    req->send(resp);
+}
+
 static void handleApiWifiGet(AsyncWebServerRequest *req)
 {
     JsonDocument d;
@@ -358,10 +488,14 @@ void my_web_asyn_init()
     else if (!(FSYS.exists("/home.html") || FSYS.exists("/home.html.gz")))
         Serial.println("[WEB] home.html missing in LittleFS, upload data folder with `pio run -t uploadfs`");
 
+    wsPoolInit();
     ws.onEvent(onWsEvent); // 2) WebSocket
     server.addHandler(&ws);
 
     server.on("/api/state", HTTP_GET, handleApiState); // 3) 基础 API
+    server.on("/api/perf", HTTP_GET, handleApiPerf);
+    server.on("/api/blackbox/data", HTTP_GET, handleApiBlackboxData); // 先注册子路径
+    server.on("/api/blackbox", HTTP_GET, handleApiBlackbox);
     server.on("/api/wifi", HTTP_GET, handleApiWifiGet);
     server.addHandler(new AsyncCallbackJsonWebHandler("/api/wifi", handleApiWifiPost));
     server.on("/", HTTP_GET, handleRootRequest); // 4) 静态文件
@@ -3,7 +3,18 @@
 #include "my_net_config.h"
 #include "my_bat.h"
 #include "my_group.h"
+#include "my_fleet.h"
 #include "my_params.h"
+#include "my_perf.h"
+#include "my_mpu6050.h"
+#include "my_blackbox.h"
+#include "my_autotune.h"
+#include "my_sched.h"
+#include "my_heap_trace.h"
+#include "my_motor.h"
+#include "my_state.h"
+#include "my_duty_map.h"
+#include "my_config.h"
 
 static constexpr float JOY_X_DEADBAND = 0.10f;
 static constexpr float JOY_Y_DEADBAND = 0.02f;
@@ -11,66 +22,200 @@ static constexpr float JOY_A_DEADBAND = 0.02f;
 static constexpr float JOY_AXIS_LOCK_FRACTION = 0.2f; // 副轴必须超过主轴的比例才放行
 static constexpr float JOY_AXIS_LOCK_FLOOR = 0.05f;    // 副轴绝对值低于该值直接清零
 
-// 12+2 路遥测数据
-void my_web_data_update()
+static const char *const TELEM_FIELDS[TELEM_FIELD_COUNT] = {"pitch", "roll", "yaw", "battery"};
+static const float TELEM_FIELD_STEPS[TELEM_FIELD_COUNT] = {0.01f, 0.01f, 0.01f, 0.01f}; // deg, deg, deg, V
+
+// 二进制帧布局描述，随 ui_config 下发一次，前端据此解码
+void web_telem_schema(JsonObject o)
 {
-    JsonDocument doc;
+    o["magic"] = TELEM_MAGIC;
+    o["version"] = TELEM_VERSION;
+    o["head"] = sizeof(telem_frame_head);
+    JsonArray fields = o["fields"].to<JsonArray>();
+    for (const char *name : TELEM_FIELDS)
+        fields.add(name);
+    JsonArray steps = o["steps"].to<JsonArray>();
+    for (float st : TELEM_FIELD_STEPS)
+        steps.add(st);
+    o["chart"] = TELEM_CHART_COUNT;
+    JsonArray chart_steps = o["chart_steps"].to<JsonArray>();
+    for (const ChartConfig &c : chart_config)
+        for (float st : c.step)
+            chart_steps.add(st);
+    o["flag_fallen"] = TELEM_FLAG_FALLEN;
+    o["flag_chart"] = TELEM_FLAG_CHART;
+    o["flag_key"] = TELEM_FLAG_KEY;
+    o["group_shift"] = TELEM_GROUP_SHIFT;
+    o["bbx_shift"] = TELEM_BBX_SHIFT;
+    JsonArray bbx = o["bbx_states"].to<JsonArray>();
+    for (uint8_t i = BB_IDLE; i <= BB_FROZEN; ++i)
+        bbx.add(my_blackbox_state_name(static_cast<blackbox_state>(i)));
+}
 
-    // 组包 -> 广播
-    doc["type"] = "telemetry";
-    doc["fallen"] = FALLEN;
-    doc["pitch"] = ANGLE_X;
-    doc["roll"] = ANGLE_Y;
-    doc["yaw"] = ANGLE_Z;
-    doc["battery"] = battery_voltage;
-    
-    // 根据 charts_send 决定是否打包 n 路曲线数据
-    if (robot.chart_enable)
-    {
-        JsonArray arr = doc["d"].to<JsonArray>();
-        arr.add(CHART_11);
-        arr.add(CHART_12);
-        arr.add(CHART_13);
-        arr.add(CHART_21);
-        arr.add(CHART_22);
-        arr.add(CHART_23);
-        arr.add(CHART_31);
-        arr.add(CHART_32);
-        arr.add(CHART_33);
-    }
-
-    // 车队状态（如果启用）
+// 本机测得的一路链路：loss 为本次上报区间的丢包率，其余为累计值
+// 链路统计编码为整数数组，10 辆从车时每辆约 120 字节（对象形式约 300 字节）：
+//   [区间丢包 ‰, 抖动 0.1ms, RSSI, 最差 RSSI, 错误帧, 距最近一帧 ms]
+// 对端上报的链路只有前 5 项
+static void web_link_fill(JsonArray a, const fleet_link_stats &s, float loss, uint32_t now_us)
+{
+    a.add(static_cast<uint32_t>(loss * 1000.0f + 0.5f));
+    a.add(s.jitter_us / 100);
+    a.add(s.rssi);
+    a.add(s.rssi_min);
+    a.add(s.rejected);
+    a.add(s.received ? (now_us - s.last_rx_us) / 1000 : 0);
+}
+
+// 对端随心跳上报的链路
+static void web_link_report_fill(JsonArray a, const fleet_link_report &r)
+{
+    a.add(r.loss_permille);
+    a.add(r.jitter_us / 100);
+    a.add(r.rssi);
+    a.add(r.rssi_min);
+    a.add(r.rejected);
+}
+
+// 车队状态：字段不定长，保留 JSON，限频发送
+static void web_group_status_update()
+{
+    static uint32_t last_ms = 0;
     const group_config &cfg = my_group_get_config();
-    if (cfg.espnow_enabled)
+    if (!cfg.espnow_enabled)
+        return;
+    const uint32_t now = millis();
+    if (now - last_ms < TELEM_GROUP_MS)
+        return;
+    last_ms = now;
+
+    JsonDocument doc;
+    doc["type"] = "telemetry";
+    JsonObject group = doc["group_status"].to<JsonObject>();
+    group["espnow_status"] = my_group_espnow_is_ready() ? "ok" : "error";
+    const uint32_t now_us = micros();
+
+    uint32_t errors[FLEET_ERR_COUNT];
+    my_group_rx_errors(errors);
+    JsonObject rx_err = group["rx_err"].to<JsonObject>();
+    for (uint8_t r = FLEET_ERR_SHORT; r < FLEET_ERR_COUNT; ++r)
+        rx_err[fleet_decode_result_name(static_cast<fleet_decode_result>(r))] = errors[r];
+
+    // 头车：从车总数在本条，列表按 GROUP_STATUS_PAGE 辆一页另发（下标固定，区间丢包率按下标各自累计）
+    static follower_info flist[MAX_FOLLOWERS];
+    int count = 0;
+    if (cfg.role == VehicleRole::LEADER)
+    {
+        count = my_group_get_followers(flist, MAX_FOLLOWERS);
+        group["total"] = count;
+    }
+    // 从车：头车下行链路
+    else if (cfg.role == VehicleRole::FOLLOWER)
     {
-        JsonObject group = doc["group_status"].to<JsonObject>();
-        group["espnow_status"] = my_group_espnow_is_ready() ? "ok" : "error";
-        
-        // 头车：包含从车列表
-        if (cfg.role == VehicleRole::LEADER)
+        static FleetLossWindow leader_window;
+        fleet_link_stats st;
+        my_group_leader_link(st);
+        web_link_fill(group["leader"].to<JsonArray>(), st, leader_window.update(st), now_us);
+    }
+    // 发送任务只报关键计数：头车为指令流，从车为心跳；失败含回调失败、esp_now_send 错误与等回调超时
+    fleet_tx_stats tx;
+    my_group_tx_stats(tx);
+    JsonObject to = group["tx"].to<JsonObject>();
+    to["hz"] = tx.max_hz;
+    to["sent"] = cfg.role == VehicleRole::FOLLOWER ? tx.heartbeats : tx.sched.sent;
+    to["skip"] = tx.sched.skipped;
+    to["fail"] = tx.fail + tx.error + tx.timeout;
+    to["done_us"] = tx.done_max_us;
+
+    if (cfg.fleet_mode == FleetMode::SETPOINT)
+    {
+        fleet_status fs;
+        my_fleet_status(fs);
+        JsonObject fo = group["fleet"].to<JsonObject>();
+        fo["setpoints"] = fs.setpoints;
+        if (fs.follower)
         {
-            JsonArray followers = group["followers"].to<JsonArray>();
-            follower_info flist[MAX_FOLLOWERS];
-            int count = my_group_get_followers(flist, MAX_FOLLOWERS);
-            
-            for (int i = 0; i < count; i++)
-            {
-                JsonObject f = followers.add<JsonObject>();
-                char mac_str[18];
-                snprintf(mac_str, sizeof(mac_str), "%02X:%02X:%02X:%02X:%02X:%02X",
-                        flist[i].mac[0], flist[i].mac[1], flist[i].mac[2],
-                        flist[i].mac[3], flist[i].mac[4], flist[i].mac[5]);
-                f["mac"] = mac_str;
-                f["last_seen_ms"] = millis() - flist[i].last_seen;
-            }
+            fo["tracking"] = fs.tracking;
+            fo["pos_err"] = fs.pos_err;
+            fo["spd_corr"] = fs.spd_corr;
         }
     }
-    
     wsBroadcast(doc);
+
+    // 从车分页：每页单独一条消息，都在广播池缓冲以内
+    static FleetLossWindow up_window[MAX_FOLLOWERS];
+    for (int first = 0; first < count; first += GROUP_STATUS_PAGE)
+    {
+        JsonDocument page;
+        page["type"] = "telemetry";
+        JsonObject pg = page["group_status"].to<JsonObject>();
+        pg["first"] = first;
+        pg["total"] = count;
+        JsonArray followers = pg["followers"].to<JsonArray>();
+        for (int i = first; i < count && i < first + GROUP_STATUS_PAGE; i++)
+        {
+            JsonObject f = followers.add<JsonObject>();
+            char mac_str[18];
+            snprintf(mac_str, sizeof(mac_str), "%02X:%02X:%02X:%02X:%02X:%02X",
+                    flist[i].mac[0], flist[i].mac[1], flist[i].mac[2],
+                    flist[i].mac[3], flist[i].mac[4], flist[i].mac[5]);
+            f["mac"] = mac_str;
+            f["on"] = flist[i].online ? 1 : 0;
+            f["seen"] = now - flist[i].last_seen;
+            f["bat"] = flist[i].battery_level;
+            const fleet_link_stats &up = flist[i].up.stats();
+            web_link_fill(f["up"].to<JsonArray>(), up, up_window[i].update(up), now_us);
+            web_link_report_fill(f["dn"].to<JsonArray>(), flist[i].down);
+        }
+        wsBroadcast(page);
+    }
 }
+
+// 4+9 路遥测数据：采样一次，按各客户端订阅的频率与曲线组分别编码发送
+void my_web_data_update()
+{
+    // 取控制任务整拍发布的快照；下面的 ANGLE_xx/CHART_xx/FALLEN 宏按 robot.xxx 展开，即读这份快照
+    static robot_state snap;
+    my_state_snapshot(snap);
+    const robot_state &robot = snap;
+
+    telem_sample smp;
+    smp.v[0] = ANGLE_X;
+    smp.v[1] = ANGLE_Y;
+    smp.v[2] = ANGLE_Z;
+    smp.v[3] = battery_voltage;
+    smp.v[4] = CHART_11;
+    smp.v[5] = CHART_12;
+    smp.v[6] = CHART_13;
+    smp.v[7] = CHART_21;
+    smp.v[8] = CHART_22;
+    smp.v[9] = CHART_23;
+    smp.v[10] = CHART_31;
+    smp.v[11] = CHART_32;
+    smp.v[12] = CHART_33;
+    memcpy(smp.step, TELEM_FIELD_STEPS, sizeof(TELEM_FIELD_STEPS));
+    for (int c = 0; c < CHART_COUNT; ++c)
+        for (int j = 0; j < 3; ++j)
+            smp.step[TELEM_FIELD_COUNT + c * 3 + j] = chart_config[c].step[j];
+
+    blackbox_status bbx;
+    my_blackbox_status(bbx);
+    smp.flags = (FALLEN ? TELEM_FLAG_FALLEN : 0) | (bbx.state << TELEM_BBX_SHIFT);
+    smp.t_ms = millis();
+
+    wsCleanupClients();
+    ::robot.data_ms = ws_clients_publish(smp);
+
+    web_group_status_update();
+    web_autotune_update();
+    web_motor_map_update();
+}
+
 // PID 设置（顺序：角度P/I/D，速度P/I/D，位置P/I/D）
 void web_pid_set(JsonObject param)
 {
+    // 在当前参数副本上改写，经命令邮箱在下一拍拍首生效，生效后再存 NVS
+    pid_gains pid;
+    my_state_pid(pid);
     SLIDER_11 = param["key01"].as<float>();
     SLIDER_12 = param["key02"].as<float>();
     SLIDER_13 = param["key03"].as<float>();
@@ -83,14 +228,13 @@ void web_pid_set(JsonObject param)
     SLIDER_41 = param["key10"].as<float>();
     SLIDER_42 = param["key11"].as<float>();
     SLIDER_43 = param["key12"].as<float>();
-    pid_state_update();
-    
-    // 保存PID参数到NVS
-    my_params_save();
+    my_cmd_pid(pid, true);
 }
 // PID 读取
 void web_pid_get(AsyncWebSocketClient *c)
 {
+    pid_gains pid;
+    my_state_pid(pid);
     JsonDocument out;
     JsonObject pr = out["param"].to<JsonObject>();
     out["type"] = "pid";
@@ -109,8 +253,214 @@ void web_pid_get(AsyncWebSocketClient *c)
 
     wsSendTo(c, out);
 }
-// 摇杆
-void web_joystick(float x, float y, float a)
+// 控制器选择与 LQR 增益：mode 为 "pid"/"lqr"，k 为按行展开的 LQR_INPUTS*LQR_STATES 个数；
+// 两项均可缺省，各自生效并保存；增益任一非有限值则整组增益不生效，同一请求中的模式切换照常生效
+void web_lqr_set(JsonObject param)
+{
+    // 先校验增益，再分别应用模式与增益
+    float next[LQR_INPUTS][LQR_STATES];
+    bool gains_ok = false;
+    JsonArray k = param["k"].as<JsonArray>();
+    if (k.size() == LQR_INPUTS * LQR_STATES)
+    {
+        gains_ok = true;
+        size_t n = 0;
+        for (JsonVariant v : k)
+        {
+            const float f = v.as<float>();
+            gains_ok = gains_ok && std::isfinite(f);
+            next[n / LQR_STATES][n % LQR_STATES] = f;
+            ++n;
+        }
+    }
+
+    lqr_gains g;
+    my_state_lqr(g);
+    bool changed = false;
+    const char *mode = param["mode"] | "";
+    if (!strcmp(mode, "lqr") || !strcmp(mode, "pid"))
+    {
+        g.ctrl_mode = !strcmp(mode, "lqr") ? CTRL_MODE_LQR : CTRL_MODE_PID;
+        changed = true;
+    }
+    if (gains_ok)
+    {
+        memcpy(g.lqr.k, next, sizeof(next));
+        changed = true;
+    }
+    if (changed)
+        my_cmd_lqr(g, true);
+}
+
+void web_lqr_fill(JsonDocument &doc)
+{
+    lqr_gains g;
+    my_state_lqr(g);
+    doc["type"] = "lqr";
+    doc["mode"] = g.ctrl_mode == CTRL_MODE_LQR ? "lqr" : "pid";
+    JsonArray k = doc["k"].to<JsonArray>();
+    for (int i = 0; i < LQR_INPUTS; ++i)
+        for (int j = 0; j < LQR_STATES; ++j)
+            k.add(g.lqr.k[i][j]);
+}
+
+// 增益调度表：enable/vcomp 开关、轴范围、标称电压与两张表（按行展开，行=电压点，列=速度点）；
+// 各项均可缺省，任一项非法则整组不生效
+static bool sched_table_parse(JsonVariant v, float (&out)[SCHED_BAT_POINTS][SCHED_SPD_POINTS])
+{
+    JsonArray a = v.as<JsonArray>();
+    if (a.size() != SCHED_BAT_POINTS * SCHED_SPD_POINTS)
+        return false;
+    size_t n = 0;
+    for (JsonVariant x : a)
+    {
+        const float f = x.as<float>();
+        if (!std::isfinite(f) || f < 0.0f || f > 3.0f)
+            return false;
+        out[n / SCHED_SPD_POINTS][n % SCHED_SPD_POINTS] = f;
+        ++n;
+    }
+    return true;
+}
+
+bool web_sched_set(JsonObject param)
+{
+    sched_config next;
+    my_state_sched(next);
+    if (!param["enable"].isNull())
+        next.enable = param["enable"].as<bool>();
+    if (!param["vcomp"].isNull())
+        next.vcomp = param["vcomp"].as<bool>();
+    next.spd_max = param["spd_max"] | next.spd_max;
+    next.bat_min = param["bat_min"] | next.bat_min;
+    next.bat_max = param["bat_max"] | next.bat_max;
+    next.v_nom = param["v_nom"] | next.v_nom;
+    if (!(next.spd_max > 0.0f) || !(next.bat_max > next.bat_min) || !(next.v_nom > SCHED_BAT_VALID_MIN))
+        return false;
+    if (!param["ang"].isNull() && !sched_table_parse(param["ang"], next.ang))
+        return false;
+    if (!param["spd"].isNull() && !sched_table_parse(param["spd"], next.spd))
+        return false;
+    my_cmd_sched(next, true); // 控制任务下一拍生效并重算轴，之后由遥测任务存 NVS
+    return true;
+}
+
+void web_sched_fill(JsonDocument &doc)
+{
+    sched_config s;
+    my_state_sched(s);
+    doc["type"] = "sched";
+    doc["enable"] = s.enable != 0;
+    doc["vcomp"] = s.vcomp != 0;
+    doc["spd_max"] = s.spd_max;
+    doc["bat_min"] = s.bat_min;
+    doc["bat_max"] = s.bat_max;
+    doc["v_nom"] = s.v_nom;
+    doc["spd_points"] = SCHED_SPD_POINTS;
+    doc["bat_points"] = SCHED_BAT_POINTS;
+    JsonArray ang = doc["ang"].to<JsonArray>();
+    JsonArray spd = doc["spd"].to<JsonArray>();
+    for (int i = 0; i < SCHED_BAT_POINTS; ++i)
+        for (int j = 0; j < SCHED_SPD_POINTS; ++j)
+        {
+            ang.add(s.ang[i][j]);
+            spd.add(s.spd[i][j]);
+        }
+    // 当前工作点
+    JsonObject now = doc["now"].to<JsonObject>();
+    now["vbat"] = sched_vbat;
+    now["ang_gain"] = sched_ang_gain;
+    now["spd_gain"] = sched_spd_gain;
+    now["vcomp"] = sched_vcomp;
+}
+
+// 占空比映射：PWM 后端、开关、四条曲线（左正/左反/右正/右反，每条 MOTOR_MAP_POINTS 点）与测量进度
+void web_motor_map_fill(JsonDocument &doc)
+{
+    // 曲线与死区在控制任务中整体改写（测量完成、标定完成），从快照读；网络任务与遥测任务都会调用，快照放在栈上
+    robot_state snap;
+    my_state_snapshot(snap);
+    const motor_map_config &m = snap.motor_map;
+    motor_map_status st;
+    my_motor_map_status(st);
+    doc["type"] = "motor_map";
+    doc["backend"] = my_motor_pwm_backend_name();
+    doc["enable"] = robot.motor_map.enable != 0; // 开关为单字节，网络任务直接写，取实时值（快照要下一拍才更新）
+    doc["state"] = my_motor_map_state_name(st.state);
+    doc["point"] = st.point;
+    doc["points_total"] = st.points_total;
+    if (st.error)
+        doc["error"] = st.error;
+    motor_cal_status cal;
+    my_motor_cal_status(cal);
+    JsonObject dz = doc["deadzone"].to<JsonObject>();
+    dz["state"] = cal.state;
+    dz["saved"] = cal.loaded;
+    JsonArray dzv = dz["duty"].to<JsonArray>();
+    dzv.add(snap.motor.L_deadzone_fwd);
+    dzv.add(snap.motor.L_deadzone_rev);
+    dzv.add(snap.motor.R_deadzone_fwd);
+    dzv.add(snap.motor.R_deadzone_rev);
+    JsonArray curves = doc["curves"].to<JsonArray>();
+    for (int c = 0; c < MOTOR_CURVE_COUNT; ++c)
+    {
+        JsonObject o = curves.add<JsonObject>();
+        o["valid"] = ctl::duty_map_valid(m.duty[c], m.speed[c]);
+        JsonArray duty = o["duty"].to<JsonArray>();
+        JsonArray speed = o["speed"].to<JsonArray>();
+        for (int k = 0; k < MOTOR_MAP_POINTS; ++k)
+        {
+            duty.add(m.duty[c][k]);
+            speed.add(m.speed[c][k]);
+        }
+    }
+}
+
+// 占空比映射指令：cmd = measure / abort / enable / disable / save / calibrate（重新标定死区）；返回 true 表示配置有变化
+bool web_motor_map_cmd(JsonObject param)
+{
+    const char *cmd = param["cmd"] | "";
+    if (!strcmp(cmd, "measure"))
+        my_motor_map_measure();
+    else if (!strcmp(cmd, "abort"))
+        my_motor_map_abort();
+    else if (!strcmp(cmd, "calibrate"))
+        my_motor_calibrate();
+    else if (!strcmp(cmd, "enable") || !strcmp(cmd, "disable"))
+    {
+        robot.motor_map.enable = !strcmp(cmd, "enable");
+        return true;
+    }
+    else if (!strcmp(cmd, "save"))
+    {
+        my_state_request_save(); // 遥测任务从快照保存
+        return true;
+    }
+    return false;
+}
+
+// 遥测任务中调用：测量进度、死区标定状态变化时推送（结束时连同曲线与死区一起）
+void web_motor_map_update()
+{
+    static motor_map_state last_state = MM_IDLE;
+    static uint8_t last_point = 0;
+    static const char *last_cal = nullptr;
+    motor_map_status st;
+    my_motor_map_status(st);
+    motor_cal_status cal;
+    my_motor_cal_status(cal);
+    if (st.state == last_state && st.point == last_point && cal.state == last_cal)
+        return;
+    last_state = st.state;
+    last_point = st.point;
+    last_cal = cal.state;
+    JsonDocument doc;
+    web_motor_map_fill(doc);
+    wsBroadcast(doc);
+}
+
+// 摇杆：sender_us 为网页端时间戳，控制任务据此对齐与外推（my_joy）
+void web_joystick(float x, float y, float a, uint32_t sender_us, uint32_t rx_us)
 {
     const float x_clamped = my_lim(x, -1.0f, 1.0f);
     const float y_clamped = my_lim(y, -1.0f, 1.0f);
@@ -132,9 +482,7 @@ void web_joystick(float x, float y, float a)
         y_filtered = 0.0f;
     }
 
-    robot.joy.x = x_filtered;
-    robot.joy.y = y_filtered * 0.7f;
-    robot.joy.a = a_filtered;
+    my_cmd_joystick({x_filtered, y_filtered * 0.7f, a_filtered, sender_us, rx_us});
 }
 
 // 车队配置设置
@@ -168,6 +516,23 @@ void web_group_config_set(JsonObject param)
         new_cfg.espnow_enabled = false;
     }
     
+    // 编队方式；队形偏移立即生效（头车随设定值广播），其余配置重启后生效
+    const char *mode_str = param["fleet_mode"] | "";
+    if (!strcmp(mode_str, "setpoint"))
+        new_cfg.fleet_mode = FleetMode::SETPOINT;
+    else if (!strcmp(mode_str, "duty"))
+        new_cfg.fleet_mode = FleetMode::DUTY;
+    if (param["formation_offset"].is<float>())
+    {
+        new_cfg.formation_offset = param["formation_offset"].as<float>();
+        my_group_set_formation_offset(new_cfg.formation_offset);
+    }
+    if (param["tx_max_hz"].is<int>())
+    {
+        my_group_set_tx_rate(static_cast<uint16_t>(constrain(param["tx_max_hz"].as<int>(), 1, GROUP_TX_MAX_HZ_LIMIT)));
+        new_cfg.tx_max_hz = my_group_get_config().tx_max_hz;
+    }
+
     // 如果是从车，需要设置头车MAC
     if (new_role == VehicleRole::FOLLOWER)
     {
@@ -233,7 +598,206 @@ void web_group_config_get(AsyncWebSocketClient *c)
     // 其他配置
     out["group_id"] = cfg.group_id;
     out["espnow_enabled"] = cfg.espnow_enabled;
+    out["fleet_mode"] = cfg.fleet_mode == FleetMode::SETPOINT ? "setpoint" : "duty";
+    out["formation_offset"] = cfg.formation_offset;
+    out["tx_max_hz"] = cfg.tx_max_hz;
     out["espnow_status"] = my_group_espnow_is_ready() ? "ok" : "error";
     
     wsSendTo(c, out);
 }
+
+// 控制环分段耗时统计（WS loop_stats 与 /api/perf 共用）
+void web_loop_stats_fill(JsonDocument &doc)
+{
+    doc["type"] = "loop_stats";
+    doc["period_us"] = robot.dt_ms * 1000;
+    doc["ticks"] = robot.tick.count;
+    doc["overrun"] = robot.tick.overrun;
+    doc["late"] = my_perf_late_count();
+    doc["exec_max_us"] = robot.tick.exec_max_us;
+    JsonObject stages = doc["stages"].to<JsonObject>();
+    for (uint8_t i = 0; i < PERF_STAGE_COUNT; ++i)
+    {
+        perf_summary sum;
+        my_perf_summary(static_cast<perf_stage>(i), sum);
+        JsonObject o = stages[my_perf_stage_name(static_cast<perf_stage>(i))].to<JsonObject>();
+        o["n"] = sum.count;
+        o["min"] = sum.min_us;
+        o["max"] = sum.max_us;
+        o["mean"] = sum.mean_us;
+        o["p50"] = sum.p50_us;
+        o["p99"] = sum.p99_us;
+    }
+
+    const imu_fifo_stats &imu = my_mpu6050_stats();
+    JsonObject io = doc["imu"].to<JsonObject>();
+    io["samples"] = imu.samples;
+    io["fifo_overflow"] = imu.fifo_overflow;
+    io["ring_drop"] = imu.ring_drop;
+    io["i2c_error"] = imu.i2c_error;
+    io["stale"] = imu.stale;
+    io["batch"] = imu.last_batch;
+    io["age_us"] = imu.age_us;
+
+    heap_trace_info heap;
+    my_heap_trace_info(heap);
+    JsonObject ho = doc["heap"].to<JsonObject>();
+    ho["free"] = heap.free_bytes;
+    ho["min_free"] = heap.min_free;
+    ho["largest"] = heap.largest;
+    ho["allocs"] = heap.total;
+    ws_clients_stats_fill(doc["telem"].to<JsonObject>());
+
+    const motor_out_stats &mo = my_motor_stats();
+    JsonObject mj = doc["motor"].to<JsonObject>();
+    mj["legacy"] = MOTOR_OUTPUT_LEGACY != 0;
+    mj["updates"] = mo.updates;
+    mj["dir_writes"] = mo.dir_writes;
+    mj["duty_writes"] = mo.duty_writes;
+    mj["cycles_last"] = mo.cycles_last;
+    mj["cycles_max"] = mo.cycles_max;
+    mj["cycles_mean"] = mo.updates ? static_cast<uint32_t>(mo.cycles_sum / mo.updates) : 0;
+
+    joy_stats js;
+    my_joy_stats(js);
+    JsonObject jo = doc["joy"].to<JsonObject>();
+    jo["samples"] = js.samples;
+    jo["dropped"] = js.dropped;
+    jo["deadman"] = js.deadman;
+    jo["delay_ms"] = js.delay_us / 1000.0f;
+}
+
+// 黑匣子状态 + 记录格式（网页据此解码 /api/blackbox/data）
+void web_blackbox_fill(JsonDocument &doc)
+{
+    blackbox_status st;
+    my_blackbox_status(st);
+    doc["type"] = "blackbox_state";
+    doc["state"] = my_blackbox_state_name(st.state);
+    doc["trigger"] = my_blackbox_trigger_name(st.trigger);
+    doc["capacity"] = st.capacity;
+    doc["count"] = st.count;
+    doc["trigger_pos"] = st.trigger_pos;
+    doc["psram"] = st.psram;
+    doc["dt_us"] = robot.dt_ms * 1000;
+    doc["version"] = BLACKBOX_VERSION;
+    doc["record_size"] = sizeof(blackbox_record);
+    doc["header_size"] = sizeof(blackbox_header);
+    size_t n = 0;
+    const blackbox_field *fields = my_blackbox_fields(n);
+    JsonArray arr = doc["fields"].to<JsonArray>();
+    for (size_t i = 0; i < n; ++i)
+    {
+        JsonObject f = arr.add<JsonObject>();
+        f["name"] = fields[i].name;
+        f["offset"] = fields[i].offset;
+        f["type"] = String(fields[i].type);
+    }
+}
+
+// 黑匣子指令：cmd = arm / trigger / stop
+void web_blackbox_cmd(JsonObject param)
+{
+    const char *cmd = param["cmd"] | "";
+    if (!strcmp(cmd, "arm"))
+    {
+        const char *trig = param["trigger"] | "fall";
+        blackbox_arm_config cfg;
+        cfg.trigger = !strcmp(trig, "threshold") ? BB_TRIG_THRESHOLD : (!strcmp(trig, "manual") ? BB_TRIG_MANUAL : BB_TRIG_FALL);
+        cfg.channel = static_cast<int8_t>(my_blackbox_find_field(param["channel"] | ""));
+        cfg.level = param["level"] | 0.0f;
+        cfg.pre_pct = static_cast<uint8_t>(my_lim(param["pre"] | 50, 0, 100));
+        my_blackbox_arm(cfg);
+    }
+    else if (!strcmp(cmd, "trigger"))
+        my_blackbox_trigger();
+    else if (!strcmp(cmd, "stop"))
+        my_blackbox_stop();
+}
+
+static void autotune_result_fill(JsonObject o, const autotune_result &r)
+{
+    o["valid"] = r.valid;
+    if (!r.valid)
+        return;
+    o["ku"] = r.ku;
+    o["tu"] = r.tu;
+    o["amp"] = r.amplitude;
+    o["p"] = r.p;
+    o["i"] = r.i;
+    o["d"] = r.d;
+}
+
+// 自整定进度与建议参数
+void web_autotune_fill(JsonDocument &doc)
+{
+    autotune_status st;
+    my_autotune_status(st);
+    doc["type"] = "autotune";
+    doc["state"] = my_autotune_state_name(st.state);
+    doc["loop"] = my_autotune_loop_name(st.loop);
+    doc["cycles"] = st.cycles;
+    doc["cycles_total"] = st.cycles_total;
+    doc["elapsed_ms"] = st.elapsed_ms;
+    if (st.error)
+        doc["error"] = st.error;
+    autotune_result_fill(doc["ang"].to<JsonObject>(), st.ang);
+    autotune_result_fill(doc["spd"].to<JsonObject>(), st.spd);
+}
+
+// 自整定指令：cmd = start(target: ang/spd/both) / abort / apply；apply 写入建议参数并存 NVS
+bool web_autotune_cmd(JsonObject param)
+{
+    const char *cmd = param["cmd"] | "";
+    if (!strcmp(cmd, "start"))
+    {
+        const char *target = param["target"] | "both";
+        my_autotune_start(!strcmp(target, "ang") ? AT_TARGET_ANG : (!strcmp(target, "spd") ? AT_TARGET_SPD : AT_TARGET_BOTH));
+    }
+    else if (!strcmp(cmd, "abort"))
+        my_autotune_abort();
+    else if (!strcmp(cmd, "apply"))
+    {
+        autotune_status st;
+        my_autotune_status(st);
+        if (st.state != AT_DONE)
+            return false;
+        pid_gains g;
+        my_state_pid(g);
+        if (st.ang.valid)
+        {
+            g.ang.p = st.ang.p;
+            g.ang.i = st.ang.i;
+            g.ang.d = st.ang.d;
+        }
+        if (st.spd.valid)
+        {
+            g.spd.p = st.spd.p;
+            g.spd.i = st.spd.i;
+            g.spd.d = st.spd.d;
+        }
+        my_cmd_pid(g, true);
+        return true;
+    }
+    return false;
+}
+
+// 遥测任务中调用：整定进行中每 200ms 推送一次进度，状态或周期数变化时立即推送
+void web_autotune_update()
+{
+    static autotune_state last_state = AT_IDLE;
+    static uint8_t last_cycles = 0;
+    static uint32_t last_ms = 0;
+    autotune_status st;
+    my_autotune_status(st);
+    const uint32_t now = millis();
+    const bool active = st.state == AT_SETTLE || st.state == AT_RELAY;
+    if (st.state == last_state && st.cycles == last_cycles && !(active && now - last_ms >= 200))
+        return;
+    last_state = st.state;
+    last_cycles = st.cycles;
+    last_ms = now;
+    JsonDocument doc;
+    web_autotune_fill(doc);
+    wsBroadcast(doc);
+}
@@ -0,0 +1,294 @@
+#include <atomic>
+#include "my_net_config.h"
+#include "my_heap_trace.h"
+#include "my_telem_codec.h"
+
+// ======================= 每客户端遥测订阅 =======================
+// 连接/断开/订阅由 async_tcp 任务写，遥测任务只读订阅字段；
+// 编码器与统计只由遥测任务访问，槽位换了客户端（id 变化）时由遥测任务自行复位
+
+namespace
+{
+    struct client_slot
+    {
+        // async_tcp 任务写
+        std::atomic<uint32_t> id{0}; // 0 = 空闲
+        volatile uint16_t rate_hz = REFRESH_RATE_DEF; // 客户端请求的上限
+        volatile uint8_t groups = 0;                  // 订阅的曲线组（bit0~2）
+        volatile uint32_t ack_t_ms = 0;               // 最近一次回执携带的帧时间戳
+        volatile uint32_t ack_at_ms = 0;              // 收到回执的时刻
+
+        // 遥测任务私有
+        uint32_t served_id = 0;
+        uint16_t cur_hz = REFRESH_RATE_DEF; // 自适应后的实际频率
+        uint32_t next_ms = 0;
+        uint32_t adapt_ms = 0;
+        uint32_t since_key = 0;
+        uint32_t seq = 0;
+        uint16_t lat_ms = 0; // 回执延迟（EWMA）
+        uint32_t last_ack = 0;
+        TelemEncoder enc;
+        ws_client_stats st = {};
+    };
+
+    client_slot slots[WS_CLIENT_SLOTS];
+    telem_alloc_stats alloc = {};
+
+    client_slot *find(uint32_t id)
+    {
+        for (client_slot &s : slots)
+            if (s.id.load(std::memory_order_acquire) == id)
+                return &s;
+        return nullptr;
+    }
+
+    uint8_t popcount3(uint8_t m)
+    {
+        return (m & 1) + ((m >> 1) & 1) + ((m >> 2) & 1);
+    }
+
+    // 新客户端：复位编码器（首帧为关键帧）与统计
+    void bind(client_slot &s, uint32_t id, uint32_t now)
+    {
+        s.served_id = id;
+        s.cur_hz = s.rate_hz;
+        s.next_ms = now;
+        s.adapt_ms = now;
+        s.since_key = 0;
+        s.seq = 0;
+        s.lat_ms = 0;
+        s.last_ack = s.ack_at_ms;
+        s.enc.invalidate();
+        s.st = {};
+    }
+
+    // 按队列深度与回执延迟调整频率：拥塞减半，空闲时每次加 1/4
+    void adapt(client_slot &s, AsyncWebSocketClient *c, uint32_t now)
+    {
+        if (now - s.adapt_ms < TELEM_ADAPT_MS)
+            return;
+        s.adapt_ms = now;
+
+        const uint32_t ack_at = s.ack_at_ms;
+        if (ack_at != s.last_ack)
+        {
+            s.last_ack = ack_at;
+            const uint32_t lat = ack_at - s.ack_t_ms;
+            s.lat_ms = static_cast<uint16_t>((s.lat_ms * 3 + (lat > 60000 ? 60000 : lat)) / 4);
+        }
+        // 超过 2s 没有回执时只看队列（旧页面不发回执）
+        const bool lat_known = now - ack_at < 2000;
+        const size_t q = c->queueLen();
+        s.st.queue = static_cast<uint8_t>(q);
+
+        const uint16_t target = s.rate_hz;
+        if (q >= WS_QUEUE_HIGH || (lat_known && s.lat_ms > TELEM_LAT_HIGH_MS))
+        {
+            s.cur_hz = s.cur_hz / 2 > REFRESH_RATE_MIN ? s.cur_hz / 2 : REFRESH_RATE_MIN;
+            s.st.backoffs++;
+        }
+        else if (q <= 1 && (!lat_known || s.lat_ms < TELEM_LAT_LOW_MS) && s.cur_hz < target)
+        {
+            const uint16_t step = s.cur_hz / 4 > 1 ? s.cur_hz / 4 : 1;
+            s.cur_hz = s.cur_hz + step < target ? s.cur_hz + step : target;
+        }
+        if (s.cur_hz > target) // 客户端调低了上限
+            s.cur_hz = target;
+    }
+
+    void send(client_slot &s, AsyncWebSocketClient *c, const telem_sample &smp)
+    {
+        const uint32_t a0 = my_heap_trace_watched();
+        if (c->queueIsFull() || c->queueLen() >= WS_QUEUE_HIGH * 2)
+        {
+            s.st.dropped++; // 参考值未推进，下一帧仍可差分
+            return;
+        }
+        AsyncWebSocketSharedBuffer buf = wsPoolAcquire(sizeof(telem_frame_head) + TELEM_CODEC_MAX_BODY);
+        if (!buf)
+        {
+            s.st.dropped++;
+            return;
+        }
+
+        // 按订阅挑选通道：姿态/电量固定，曲线按组
+        float v[TELEM_FIELD_COUNT + TELEM_CHART_COUNT];
+        float step[TELEM_FIELD_COUNT + TELEM_CHART_COUNT];
+        uint8_t n = 0;
+        for (; n < TELEM_FIELD_COUNT; ++n)
+        {
+            v[n] = smp.v[n];
+            step[n] = smp.step[n];
+        }
+        const uint8_t groups = s.groups & 0x07;
+        for (int g = 0; g < CHART_COUNT; ++g)
+        {
+            if (!(groups & (1 << g)))
+                continue;
+            for (int j = 0; j < 3; ++j, ++n)
+            {
+                v[n] = smp.v[TELEM_FIELD_COUNT + g * 3 + j];
+                step[n] = smp.step[TELEM_FIELD_COUNT + g * 3 + j];
+            }
+        }
+
+        uint8_t flags = smp.flags;
+        if (groups)
+            flags |= TELEM_FLAG_CHART | (groups << TELEM_GROUP_SHIFT);
+        bool is_key = false;
+        uint8_t *p = buf->data();
+        const size_t body = s.enc.encode(v, step, n, s.since_key >= TELEM_KEY_INTERVAL, p + sizeof(telem_frame_head), is_key);
+        if (is_key)
+            flags |= TELEM_FLAG_KEY;
+
+        telem_frame_head head;
+        head.magic = TELEM_MAGIC;
+        head.version = TELEM_VERSION;
+        head.flags = flags;
+        head.count = n;
+        head.seq = s.seq;
+        head.t_ms = smp.t_ms;
+        memcpy(p, &head, sizeof(head));
+        buf->resize(sizeof(head) + body);
+        const size_t len = buf->size();
+        const uint32_t a1 = my_heap_trace_watched();
+
+        const bool ok = c->binary(buf);
+        buf.reset();
+        const uint32_t a2 = my_heap_trace_watched();
+
+        alloc.last_build = a1 - a0;
+        alloc.last_send = a2 - a1;
+        alloc.build_allocs += alloc.last_build;
+        alloc.send_allocs += alloc.last_send;
+        if (alloc.last_build)
+            alloc.alloc_frames++;
+        alloc.frames++;
+        if (!ok)
+        {
+            s.st.dropped++;
+            return;
+        }
+        // 入队即推进参考：TCP 保证顺序到达
+        s.enc.commit();
+        s.seq++;
+        s.since_key = is_key ? 0 : s.since_key + 1;
+        s.st.sent++;
+        s.st.bytes += len;
+        if (is_key)
+            s.st.keys++;
+    }
+}
+
+void ws_client_attach(AsyncWebSocketClient *c)
+{
+    for (client_slot &s : slots)
+    {
+        uint32_t expected = 0;
+        if (s.id.load(std::memory_order_relaxed) != 0)
+            continue;
+        s.rate_hz = REFRESH_RATE_DEF;
+        s.groups = robot.chart_enable ? 0x07 : 0; // 沿用最近一次的图表开关作为初值
+        s.ack_at_ms = 0;
+        if (s.id.compare_exchange_strong(expected, c->id(), std::memory_order_release))
+            return;
+    }
+    Serial.printf("[WS] 客户端 #%u 无空闲订阅槽，不推送遥测\n", c->id());
+}
+
+void ws_client_detach(uint32_t id)
+{
+    client_slot *s = find(id);
+    if (s)
+        s->id.store(0, std::memory_order_release);
+}
+
+void ws_client_set_rate(uint32_t id, int hz)
+{
+    client_slot *s = find(id);
+    if (s)
+        s->rate_hz = static_cast<uint16_t>(my_lim(hz, REFRESH_RATE_MIN, REFRESH_RATE_MAX));
+}
+
+void ws_client_set_groups(uint32_t id, uint8_t groups)
+{
+    client_slot *s = find(id);
+    if (s)
+        s->groups = groups & 0x07;
+}
+
+void ws_client_ack(uint32_t id, uint32_t t_ms)
+{
+    client_slot *s = find(id);
+    if (!s)
+        return;
+    s->ack_t_ms = t_ms;
+    s->ack_at_ms = millis();
+}
+
+uint32_t ws_clients_publish(const telem_sample &smp)
+{
+    const uint32_t now = millis();
+    uint16_t fastest = 0;
+    for (client_slot &s : slots)
+    {
+        const uint32_t id = s.id.load(std::memory_order_acquire);
+        if (!id)
+        {
+            s.served_id = 0;
+            continue;
+        }
+        AsyncWebSocketClient *c = ws.client(id);
+        if (!c || c->status() != WS_CONNECTED)
+            continue;
+        if (s.served_id != id)
+            bind(s, id, now);
+
+        adapt(s, c, now);
+        s.st.hz = s.cur_hz;
+        s.st.lat_ms = s.lat_ms;
+        if (s.cur_hz > fastest)
+            fastest = s.cur_hz;
+
+        if (static_cast<int32_t>(now - s.next_ms) < 0)
+            continue;
+        const uint32_t period = 1000 / s.cur_hz;
+        s.next_ms += period;
+        if (static_cast<int32_t>(now - s.next_ms) >= 0)
+            s.next_ms = now + period; // 落后一个周期以上时重新对齐，不补发
+        send(s, c, smp);
+    }
+    // 遥测任务按最快客户端的周期运行
+    return 1000 / (fastest ? fastest : REFRESH_RATE_DEF);
+}
+
+void ws_clients_stats_fill(JsonObject o)
+{
+    o["frames"] = alloc.frames;
+    o["build_allocs"] = alloc.build_allocs;
+    o["send_allocs"] = alloc.send_allocs;
+    o["alloc_frames"] = alloc.alloc_frames;
+    o["last_build"] = alloc.last_build;
+    o["last_send"] = alloc.last_send;
+    o["pool_miss"] = wsPoolMiss();
+    o["pool_oversize"] = wsPoolOversize();
+    JsonArray arr = o["clients"].to<JsonArray>();
+    for (client_slot &s : slots)
+    {
+        const uint32_t id = s.id.load(std::memory_order_acquire);
+        if (!id || s.served_id != id)
+            continue;
+        JsonObject c = arr.add<JsonObject>();
+        c["id"] = id;
+        c["rate"] = s.rate_hz;
+        c["hz"] = s.st.hz;
+        c["groups"] = s.groups;
+        c["queue"] = s.st.queue;
+        c["lat_ms"] = s.st.lat_ms;
+        c["sent"] = s.st.sent;
+        c["dropped"] = s.st.dropped;
+        c["backoffs"] = s.st.backoffs;
+        c["keys"] = s.st.keys;
+        c["bytes"] = s.st.bytes;
+    }
+}
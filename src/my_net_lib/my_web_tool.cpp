@@ -12,45 +12,98 @@ void wsSendTo(AsyncWebSocketClient *c, const JsonDocument &doc)
 void my_wsheart()
 {
     ws.cleanupClients(); // 清理断开的
-    size_t n = ws.count();
-    for (size_t i = 0; i < n; i++)
+    for (AsyncWebSocketClient &c : ws.getClients())
     {
-        AsyncWebSocketClient *c = ws.client(i);
-        if (!c)
-            continue;
-        if (c->canSend())
-            c->ping(); // 发送 ping 帧
+        if (c.status() == WS_CONNECTED && c.canSend())
+            c.ping(); // 发送 ping 帧
     }
     vTaskDelay(pdMS_TO_TICKS(15000)); // 每 15 秒 ping 一次
 }
 
-bool wsCanBroadcast()
+// ======================= 广播缓冲池 =======================
+// 固定数量的共享缓冲循环复用：引用计数只剩池自身（use_count()==1）说明所有客户端都已发完
+static AsyncWebSocketSharedBuffer ws_pool[WS_POOL_COUNT];
+static size_t ws_pool_next = 0;
+static uint32_t ws_pool_miss = 0;
+static uint32_t ws_pool_oversize = 0;
+static uint32_t ws_last_cleanup_ms = 0;
+static portMUX_TYPE ws_pool_mux = portMUX_INITIALIZER_UNLOCKED; // 遥测任务与 async_tcp 任务都会取缓冲
+
+void wsPoolInit()
 {
-    bool ok = true;
-    size_t n = ws.count();
-    for (size_t i = 0; i < n; i++)
+    for (auto &b : ws_pool)
     {
-        AsyncWebSocketClient *c = ws.client(i);
-        if (!c)
+        if (b)
             continue;
-        if (c->queueIsFull() || !c->canSend())
+        b = std::make_shared<std::vector<uint8_t>>();
+        b->reserve(WS_POOL_BYTES);
+    }
+}
+
+AsyncWebSocketSharedBuffer wsPoolAcquire(size_t len)
+{
+    if (len > WS_POOL_BYTES)
+    {
+        // 超出池缓冲的消息（如多从车的车队状态）单独分配一次，发完随引用计数释放；计数以便发现常态超长
+        portENTER_CRITICAL(&ws_pool_mux);
+        ws_pool_oversize++;
+        portEXIT_CRITICAL(&ws_pool_mux);
+        return std::make_shared<std::vector<uint8_t>>(len);
+    }
+    AsyncWebSocketSharedBuffer out;
+    portENTER_CRITICAL(&ws_pool_mux);
+    for (size_t i = 0; i < WS_POOL_COUNT; ++i)
+    {
+        AsyncWebSocketSharedBuffer &b = ws_pool[(ws_pool_next + i) % WS_POOL_COUNT];
+        if (b && b.use_count() == 1)
         {
-            ok = false;
+            ws_pool_next = (ws_pool_next + i + 1) % WS_POOL_COUNT;
+            b->resize(len); // 容量已预留，不会重新分配
+            out = b;
             break;
         }
     }
-    return ok;
+    if (!out)
+        ws_pool_miss++; // 全部仍在客户端队列中，丢帧
+    portEXIT_CRITICAL(&ws_pool_mux);
+    return out;
 }
 
-void wsBroadcast(const JsonDocument &doc)
+uint32_t wsPoolMiss()
+{
+    return ws_pool_miss;
+}
+
+uint32_t wsPoolOversize()
+{
+    return ws_pool_oversize;
+}
+
+// 断开的客户端每秒清理一次（另有 15s 心跳），不再每帧遍历
+void wsCleanupClients()
 {
-    // 清理断开的客户端，避免幽灵连接占坑
+    const uint32_t now = millis();
+    if (now - ws_last_cleanup_ms < 1000)
+        return;
+    ws_last_cleanup_ms = now;
     ws.cleanupClients();
-    if (!wsCanBroadcast())
-        return; // 丢掉这一帧，避免把队列越堆越高
+}
 
-    String s;
-    s.reserve(320); // 预留缓冲，减少堆分配
-    serializeJson(doc, s);
-    ws.textAll(s);
+void wsBroadcast(const JsonDocument &doc)
+{
+    wsCleanupClients();
+    if (!ws.count())
+        return;
+
+    // 直接序列化进池缓冲，不经过 String
+    const size_t len = measureJson(doc);
+    AsyncWebSocketSharedBuffer buf = wsPoolAcquire(len + 1);
+    if (!buf)
+        return;
+    serializeJson(doc, reinterpret_cast<char *>(buf->data()), len + 1);
+    buf->resize(len); // 去掉结尾 '\0'
+    // 逐个客户端入队，慢客户端只丢自己的这一条，不再拖住所有人
+    for (AsyncWebSocketClient &c : ws.getClients())
+        if (c.status() == WS_CONNECTED && !c.queueIsFull())
+            c.text(buf);
 }
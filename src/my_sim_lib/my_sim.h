@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * 主机仿真（env:native）
+ * 用两轮倒立摆模型替代 MPU6050 / PCNT / LEDC，
+ * 让 my_motion_update() 及整套串级 PID 在 Linux 上闭环运行。
+ */
+
+/********** 仿真时钟 **********/
+uint64_t sim_time_us();             // 当前仿真时间（us）
+void sim_advance_us(uint32_t us);   // 推进仿真时间，同时积分被控对象
+
+/********** 被控对象参数 **********/
+struct sim_plant_params
+{
+    float body_mass;        // 车身质量 (kg)
+    float body_com;         // 质心到轮轴距离 (m)
+    float body_inertia;     // 车身绕质心转动惯量 (kg*m^2)
+    float wheel_mass;       // 单轮质量 (kg)
+    float wheel_radius;     // 轮半径 (m)
+    float track_width;      // 轮距 (m)
+    float yaw_inertia;      // 整车绕竖轴转动惯量 (kg*m^2)
+    float stall_torque;     // 单轮堵转力矩（轮端，额定电压，N*m）
+    float no_load_speed;    // 单轮空载转速（轮端，额定电压，rad/s）
+    float friction_torque;  // 库仑摩擦力矩（决定起转死区，N*m）
+    float nominal_voltage;  // 电机额定电压 (V)
+    float battery_voltage;  // 当前电池电压 (V)
+    float mount_offset_deg; // IMU 安装偏差：直立平衡时 pitch 读数 (deg)
+    float angle_noise_deg;  // 角度噪声标准差 (deg)
+    float gyro_noise_dps;   // 陀螺噪声标准差 (deg/s)
+};
+
+/********** 被控对象状态（物理坐标：电机正转方向为 +x，前倾为 +theta） **********/
+struct sim_plant_state
+{
+    float theta;     // 车身倾角 (rad)
+    float theta_dot; // 车身角速度 (rad/s)
+    float phi;       // 平均轮转角 (rad)
+    float phi_dot;   // 平均轮角速度 (rad/s)
+    float psi;       // 偏航角 (rad)
+    float psi_dot;   // 偏航角速度 (rad/s)
+    float duty_l;    // 左轮当前 PWM 占空比（带符号）
+    float duty_r;    // 右轮当前 PWM 占空比（带符号）
+    float push_n;    // 当前作用在质心的水平外力 (N)
+};
+
+sim_plant_params sim_plant_default_params();
+void sim_plant_init(const sim_plant_params &params, float theta0_rad, uint32_t seed);
+void sim_plant_step(float dt_s);
+const sim_plant_state &sim_plant_get();
+const sim_plant_params &sim_plant_get_params();
+
+void sim_plant_set_duty(float duty_l, float duty_r); // 电机输出（由仿真电机模块调用）
+void sim_plant_set_push(float force_n);              // 外部扰动
+float sim_plant_wheel_angle_l();                     // 左轮转角 (rad)
+float sim_plant_wheel_angle_r();                     // 右轮转角 (rad)
+float sim_plant_noise(float sigma);                  // 可复现高斯噪声
@@ -0,0 +1,222 @@
+// 仿真硬件层：实现 my_mpu6050 / my_encoder / my_motor / my_group 的接口，
+// 数据来自 my_sim_plant 中的倒立摆模型，控制代码无需任何改动即可链接运行
+#include "Arduino.h"
+#include "my_sim.h"
+#include "my_motion.h"
+#include "my_mpu6050.h"
+#include "my_encoder.h"
+#include "my_motor.h"
+#include "my_group.h"
+#include "my_bat.h"
+#include "my_sched.h"
+#include "my_vel_observer.h"
+#include "my_duty_map.h"
+
+SimSerial Serial;
+float battery_voltage = 12.0f; // 由仿真入口按模型电池电压设置
+
+namespace
+{
+    constexpr uint32_t MAX_STEP_US = 100; // 积分步长上限，保证电机模型数值稳定
+    uint64_t now_us = 0;
+
+    // 与 my_encoder.cpp 保持一致的编码器参数
+    constexpr float GearRatio = 35.0f;
+    constexpr float EncoderLines = 385.0f;
+    constexpr float CountsPerWheelRev = EncoderLines * 2.0f * GearRatio;
+    constexpr float RadPerCount = (2.0f * static_cast<float>(PI)) / CountsPerWheelRev;
+
+    int64_t left_last_count = 0;
+    int64_t right_last_count = 0;
+    VelObserver left_observer;
+    VelObserver right_observer;
+
+    float start_duty = 0.0f; // 仿真“标定”得到的起转死区
+
+    int64_t wheel_counts(float angle_rad)
+    {
+        return static_cast<int64_t>(floorf(angle_rad / RadPerCount));
+    }
+
+    // 与 my_motor.cpp 中 motor_duty() 相同：有效曲线按映射，否则起转占空比 + 直线
+    float drive_motor(float cmd, bool left)
+    {
+        cmd = constrain(cmd, -1.0f, 1.0f);
+        if (fabsf(cmd) < 1e-5f)
+            return 0.0f;
+        const uint8_t curve = (left ? MOTOR_CURVE_L_FWD : MOTOR_CURVE_R_FWD) + (cmd > 0 ? 0 : 1);
+        const motor_map_config &map = robot.motor_map;
+        const float base = map.enable && ctl::duty_map_valid(map.duty[curve], map.speed[curve])
+                               ? ctl::duty_map(map.duty[curve], map.speed[curve], fabsf(cmd))
+                               : start_duty + (1.0f - start_duty) * fabsf(cmd);
+        const float duty = fminf(base * sched_vcomp, 1.0f);
+        return cmd > 0 ? duty : -duty;
+    }
+}
+
+/********** 仿真时钟 **********/
+uint64_t sim_time_us()
+{
+    return now_us;
+}
+
+void sim_advance_us(uint32_t us)
+{
+    while (us > 0)
+    {
+        const uint32_t step = us > MAX_STEP_US ? MAX_STEP_US : us;
+        sim_plant_step(step * 1e-6f);
+        now_us += step;
+        us -= step;
+    }
+}
+
+uint32_t micros()
+{
+    return static_cast<uint32_t>(now_us);
+}
+
+uint32_t millis()
+{
+    return static_cast<uint32_t>(now_us / 1000);
+}
+
+void delay(uint32_t ms)
+{
+    sim_advance_us(ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    sim_advance_us(us);
+}
+
+/********** IMU **********/
+void my_mpu6050_setzero()
+{
+    my_mpu6050_update();
+    robot.imu_zero = robot.imu;
+}
+
+void my_mpu6050_init()
+{
+    my_mpu6050_setzero();
+}
+
+void my_mpu6050_update()
+{
+    const sim_plant_state &s = sim_plant_get();
+    const sim_plant_params &p = sim_plant_get_params();
+    robot.imu_l = robot.imu;
+    // 前倾(+theta)对应 pitch 读数减小，与实车安装方向一致
+    robot.imu.anglex = sim_plant_noise(p.angle_noise_deg);
+    robot.imu.angley = -s.theta * static_cast<float>(RAD_TO_DEG) + p.mount_offset_deg + sim_plant_noise(p.angle_noise_deg);
+    robot.imu.anglez = s.psi * static_cast<float>(RAD_TO_DEG);
+    robot.imu.gyrox = sim_plant_noise(p.gyro_noise_dps);
+    robot.imu.gyroy = -s.theta_dot * static_cast<float>(RAD_TO_DEG) + sim_plant_noise(p.gyro_noise_dps);
+    robot.imu.gyroz = s.psi_dot * static_cast<float>(RAD_TO_DEG) + sim_plant_noise(p.gyro_noise_dps);
+}
+
+bool my_mpu6050_probe()
+{
+    return true;
+}
+
+const imu_fifo_stats &my_mpu6050_stats()
+{
+    static imu_fifo_stats stats = {};
+    stats.samples = robot.tick.count;
+    return stats;
+}
+
+/********** 编码器 **********/
+volatile int32_t Encoder_Left_Delta = 0;
+volatile int32_t Encoder_Right_Delta = 0;
+
+void my_encoder_init()
+{
+    left_last_count = wheel_counts(sim_plant_wheel_angle_l());
+    right_last_count = wheel_counts(sim_plant_wheel_angle_r());
+    Encoder_Left_Delta = 0;
+    Encoder_Right_Delta = 0;
+    left_observer.configure(ENCODER_OBS_ACCEL / RadPerCount, robot.dt_ms * 0.001f);
+    right_observer.configure(ENCODER_OBS_ACCEL / RadPerCount, robot.dt_ms * 0.001f);
+    left_observer.reset(left_last_count);
+    right_observer.reset(right_last_count);
+}
+
+void my_encoder_update()
+{
+    const int64_t left = wheel_counts(sim_plant_wheel_angle_l());
+    const int64_t right = wheel_counts(sim_plant_wheel_angle_r());
+    Encoder_Left_Delta = static_cast<int32_t>(left - left_last_count);
+    Encoder_Right_Delta = static_cast<int32_t>(right - right_last_count);
+    left_last_count = left;
+    right_last_count = right;
+
+    const float dt_s = robot.tick.dt;
+#if ENCODER_VEL_OBSERVER
+    robot.wel.spd1 = left_observer.update(left, dt_s) * RadPerCount;
+    robot.wel.spd2 = right_observer.update(right, dt_s) * RadPerCount;
+#else
+    robot.wel.spd1 = dt_s > 0.0f ? Encoder_Left_Delta * RadPerCount / dt_s : 0.0f;
+    robot.wel.spd2 = dt_s > 0.0f ? Encoder_Right_Delta * RadPerCount / dt_s : 0.0f;
+#endif
+    robot.wel.pos1 = static_cast<float>(left) * RadPerCount;
+    robot.wel.pos2 = static_cast<float>(right) * RadPerCount;
+}
+
+/********** 电机 **********/
+volatile float motor_left_u = 0.0f;
+volatile float motor_right_u = 0.0f;
+
+void my_motor_init()
+{
+    // 仿真里死区可直接由模型参数算出，等价于实车在标称电压下的标定结果（电压偏差交给 sched_vcomp）
+    const sim_plant_params &p = sim_plant_get_params();
+    start_duty = p.friction_torque / p.stall_torque;
+    robot.motor.L_deadzone_fwd = start_duty;
+    robot.motor.L_deadzone_rev = start_duty;
+    robot.motor.R_deadzone_fwd = start_duty;
+    robot.motor.R_deadzone_rev = start_duty;
+
+    my_encoder_init();
+    sim_plant_set_duty(0.0f, 0.0f);
+    motor_left_u = 0.0f;
+    motor_right_u = 0.0f;
+}
+
+void my_motor_update()
+{
+    robot.motor.L_cmd = motor_left_u;
+    robot.motor.R_cmd = motor_right_u;
+    const float left_applied = drive_motor(motor_left_u, true);
+    const float right_applied = drive_motor(motor_right_u, false);
+    sim_plant_set_duty(left_applied, right_applied);
+    robot.motor.L_duty = left_applied;
+    robot.motor.R_duty = right_applied;
+}
+
+/********** 车队（默认单机模式；fleet 场景切换为设定值模式的从车，设定值由场景直接投递） **********/
+group_config g_group_cfg = {
+    .role = VehicleRole::STANDALONE,
+    .leader_mac = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF},
+    .group_id = 0,
+    .espnow_enabled = false,
+    .fleet_mode = FleetMode::DUTY,
+    .formation_offset = 0.0f,
+    .tx_max_hz = GROUP_TX_MAX_HZ};
+volatile uint32_t g_last_command_time = 0;
+
+const group_config &my_group_get_config()
+{
+    return g_group_cfg;
+}
+
+void my_group_send_command(float, float) {}
+void my_group_send_setpoint(const fleet_setpoint &) {}
+bool my_group_is_command_timeout()
+{
+    return false;
+}
+void my_group_update_followers_status() {}
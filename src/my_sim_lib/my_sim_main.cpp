@@ -0,0 +1,355 @@
+// 主机仿真入口：pio run -e native -t exec -- [选项]
+//   --seconds N      仿真时长（默认 10）
+//   --scenario S     balance | push | drive | fleet（默认 push）
+//                    fleet：本车为设定值模式的从车，模拟头车每 20ms 广播一帧（与 drive 相同的前进+转向，
+//                    6s 时队形偏移 +2rad），结束时打印队形误差
+//   --theta0 DEG     初始倾角（默认 3）
+//   --seed N         噪声种子
+//   --jitter US      控制节拍抖动标准差（us），检验实测 dt 的效果
+//   --ctrl C         pid | lqr（默认 pid），选择单机控制器
+//   --autotune L     ang | spd | both，1s 时启动继电自整定，完成后立即应用建议参数继续仿真，
+//                    结束时打印辨识结果，未完成返回非零
+//   --vbat V         电池电压（默认 12，等于标称电压），检验电压补偿
+//   --no-vcomp       关闭 drive_motor 电压补偿
+//   --motor-map      启用占空比映射，曲线按模型空载轮速生成（与实车测量流程的点位相同）
+//   --csv FILE       逐拍导出状态
+//   --blackbox FILE  黑匣子布防（摔倒触发，未摔倒则在最后一拍手动触发），结束时导出与实车相同的二进制
+// 结束时打印跟踪指标与每拍 CPU 开销；倒地返回非零，可直接用于调参回归
+#include <chrono>
+#include <string.h>
+#include "Arduino.h"
+#include "my_sim.h"
+#include "my_motion.h"
+#include "my_perf.h"
+#include "my_blackbox.h"
+#include "my_autotune.h"
+#include "my_control.h"
+#include "my_bat.h"
+#include "my_sched.h"
+#include "my_state.h"
+#include "my_fleet.h"
+
+namespace
+{
+    struct sim_options
+    {
+        float seconds = 10.0f;
+        const char *scenario = "push";
+        float theta0_deg = 3.0f;
+        uint32_t seed = 1;
+        float jitter_us = 0.0f;
+        uint8_t ctrl_mode = CTRL_MODE_PID;
+        uint8_t autotune = 0; // autotune_target，0 不整定
+        bool autotune_applied = false;
+        float vbat = 12.0f;
+        bool vcomp = true;
+        bool motor_map = false;
+        const char *csv = nullptr;
+        const char *blackbox = nullptr;
+    };
+
+    bool parse_args(int argc, char **argv, sim_options &opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const bool has_val = i + 1 < argc;
+            if (!strcmp(argv[i], "--seconds") && has_val)
+                opt.seconds = static_cast<float>(atof(argv[++i]));
+            else if (!strcmp(argv[i], "--scenario") && has_val)
+                opt.scenario = argv[++i];
+            else if (!strcmp(argv[i], "--theta0") && has_val)
+                opt.theta0_deg = static_cast<float>(atof(argv[++i]));
+            else if (!strcmp(argv[i], "--seed") && has_val)
+                opt.seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+            else if (!strcmp(argv[i], "--jitter") && has_val)
+                opt.jitter_us = static_cast<float>(atof(argv[++i]));
+            else if (!strcmp(argv[i], "--ctrl") && has_val)
+            {
+                const char *c = argv[++i];
+                if (!strcmp(c, "lqr"))
+                    opt.ctrl_mode = CTRL_MODE_LQR;
+                else if (strcmp(c, "pid"))
+                {
+                    fprintf(stderr, "未知控制器: %s\n", c);
+                    return false;
+                }
+            }
+            else if (!strcmp(argv[i], "--autotune") && has_val)
+            {
+                const char *l = argv[++i];
+                if (!strcmp(l, "ang"))
+                    opt.autotune = AT_TARGET_ANG;
+                else if (!strcmp(l, "spd"))
+                    opt.autotune = AT_TARGET_SPD;
+                else if (!strcmp(l, "both"))
+                    opt.autotune = AT_TARGET_BOTH;
+                else
+                {
+                    fprintf(stderr, "未知整定目标: %s\n", l);
+                    return false;
+                }
+            }
+            else if (!strcmp(argv[i], "--vbat") && has_val)
+                opt.vbat = static_cast<float>(atof(argv[++i]));
+            else if (!strcmp(argv[i], "--no-vcomp"))
+                opt.vcomp = false;
+            else if (!strcmp(argv[i], "--motor-map"))
+                opt.motor_map = true;
+            else if (!strcmp(argv[i], "--csv") && has_val)
+                opt.csv = argv[++i];
+            else if (!strcmp(argv[i], "--blackbox") && has_val)
+                opt.blackbox = argv[++i];
+            else
+            {
+                fprintf(stderr, "未知参数: %s\n", argv[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 模拟网页“测量曲线”的结果：模型空载稳态轮速 w = w0 * (duty * v_ratio - tf / ts)，按标称电压换算
+    void build_motor_map(const sim_plant_params &p)
+    {
+        const float start = p.friction_torque / p.stall_torque;
+        motor_map_config &m = robot.motor_map;
+        for (uint8_t c = 0; c < MOTOR_CURVE_COUNT; ++c)
+            for (uint8_t k = 0; k < MOTOR_MAP_POINTS; ++k)
+            {
+                m.duty[c][k] = start + (1.0f - start) * k / (MOTOR_MAP_POINTS - 1);
+                m.speed[c][k] = p.no_load_speed * (m.duty[c][k] - start);
+            }
+        m.enable = 1;
+    }
+
+    // 场景：按时间注入外力 / 摇杆指令
+    void apply_scenario(const char *scenario, float t)
+    {
+        if (!strcmp(scenario, "push"))
+        {
+            // 2s 时向前推 0.1s
+            sim_plant_set_push((t >= 2.0f && t < 2.1f) ? 1.5f : 0.0f);
+        }
+        else if (!strcmp(scenario, "drive"))
+        {
+            // 与网页摇杆相同经命令队列投递，下一拍拍首交给 my_joy 生成设定值；仿真无网络延迟
+            const uint32_t now = micros();
+            my_cmd_joystick({(t >= 4.0f && t < 5.0f) ? 0.5f : 0.0f, (t >= 1.0f && t < 3.0f) ? 0.5f : 0.0f, 0.0f, now, now});
+        }
+        else if (!strcmp(scenario, "fleet"))
+        {
+            // 虚拟头车：实际轮速按 0.5s 一阶滞后跟随目标（平衡车加速需先前倾，与本车 drive 场景的响应相当），
+            // 积分得里程；与 ESP-NOW 接收回调相同经命令邮箱投递，到达延迟 2~8ms
+            static uint32_t last_us = 0, next_us = 0, lcg = 1;
+            static float leader_pos = 0.0f, leader_spd = 0.0f;
+            const uint32_t now = micros();
+            const float dt = static_cast<float>(now - last_us) * 1e-6f;
+            const float spd = (t >= 1.0f && t < 3.0f) ? 0.5f * robot.joy.y_coef : 0.0f;
+            leader_spd += (spd - leader_spd) * fminf(dt / 0.5f, 1.0f);
+            leader_pos += leader_spd * dt;
+            last_us = now;
+            if (static_cast<int32_t>(now - next_us) < 0)
+                return;
+            next_us += GROUP_SETPOINT_INTERVAL_MS * 1000;
+            lcg = lcg * 1664525u + 1013904223u;
+            const uint32_t delay_us = 2000 + (lcg >> 8) % 6000;
+            fleet_setpoint sp;
+            sp.spd = spd;
+            sp.yaw_rate = (t >= 4.0f && t < 5.0f) ? 0.5f * robot.joy.x_coef * YAW_RATE_MAX_DEG_S : 0.0f;
+            sp.pos = leader_pos;
+            sp.vel = leader_spd;
+            sp.offset = t >= 6.0f ? 2.0f : 0.0f;
+            sp.flags = FLEET_SP_RUN;
+            my_cmd_fleet_setpoint(sp, now - delay_us, now);
+        }
+    }
+
+    // 与网页 autotune apply 相同：以当前参数为底写入建议值，经命令邮箱在下一拍生效
+    void apply_autotune(sim_options &opt)
+    {
+        autotune_status at;
+        my_autotune_status(at);
+        if (at.state != AT_DONE)
+            return;
+        pid_gains g;
+        my_state_pid(g);
+        if (at.ang.valid)
+        {
+            g.ang.p = at.ang.p;
+            g.ang.i = at.ang.i;
+            g.ang.d = at.ang.d;
+        }
+        if (at.spd.valid)
+        {
+            g.spd.p = at.spd.p;
+            g.spd.i = at.spd.i;
+            g.spd.d = at.spd.d;
+        }
+        my_cmd_pid(g, false);
+        opt.autotune_applied = true;
+    }
+
+    void dump_blackbox(const char *path)
+    {
+        blackbox_status st;
+        my_blackbox_status(st);
+        FILE *f = fopen(path, "wb");
+        if (!f)
+            return;
+        uint8_t chunk[4096];
+        size_t total = 0;
+        size_t offset = 0;
+        size_t n;
+        while ((n = my_blackbox_read(chunk, sizeof(chunk), offset, total)) > 0)
+        {
+            fwrite(chunk, 1, n, f);
+            offset += n;
+        }
+        fclose(f);
+        printf("blackbox: %s records=%u trigger_pos=%u bytes=%zu\n", my_blackbox_state_name(st.state),
+               st.count, st.trigger_pos, total);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    sim_options opt;
+    if (!parse_args(argc, argv, opt))
+        return 2;
+
+    sim_plant_params plant = sim_plant_default_params();
+    plant.battery_voltage = opt.vbat;
+    battery_voltage = opt.vbat;
+    sim_plant_init(plant, opt.theta0_deg * static_cast<float>(DEG_TO_RAD), opt.seed);
+    my_motion_init();
+    robot.sched.vcomp = opt.vcomp;
+    if (opt.motor_map)
+        build_motor_map(plant);
+    robot.run = true;
+    robot.fallen.enable = true;
+    robot.ctrl_mode = opt.ctrl_mode;
+    if (opt.blackbox)
+        my_blackbox_arm({BB_TRIG_FALL, -1, 0.0f, 100});
+    const bool fleet = !strcmp(opt.scenario, "fleet");
+    if (fleet)
+    {
+        g_group_cfg.role = VehicleRole::FOLLOWER;
+        g_group_cfg.espnow_enabled = true;
+        g_group_cfg.fleet_mode = FleetMode::SETPOINT;
+    }
+
+    FILE *csv = opt.csv ? fopen(opt.csv, "w") : nullptr;
+    if (csv)
+        fprintf(csv, "t,theta_deg,ang_now,ang_tar,spd_now,spd_tar,pos_now,yaw_rate,L_cmd,R_cmd\n");
+
+    const uint32_t tick_us = static_cast<uint32_t>(robot.dt_ms) * 1000;
+    const uint64_t ticks = static_cast<uint64_t>(opt.seconds * 1e6f / tick_us);
+    const uint64_t settle_ticks = 1000000 / tick_us; // 第 1 秒视为起摆过程，不计入统计
+
+    double cpu_ns_sum = 0.0;
+    double cpu_ns_max = 0.0;
+    double theta_sq_sum = 0.0;
+    float theta_abs_max = 0.0f;
+    double spd_err_sq_sum = 0.0; // 轮速估计误差（相对模型真值）
+    uint64_t stat_ticks = 0;
+    bool fell = false;
+    double form_sq_sum = 0.0; // fleet：队形误差
+    float form_abs_max = 0.0f;
+
+    for (uint64_t k = 0; k < ticks; ++k)
+    {
+        const float t = static_cast<float>(sim_time_us()) * 1e-6f;
+        apply_scenario(opt.scenario, t);
+        if (opt.autotune && k == settle_ticks)
+            my_autotune_start(static_cast<autotune_target>(opt.autotune));
+        if (opt.autotune && !opt.autotune_applied)
+            apply_autotune(opt);
+
+        if (opt.blackbox && k + 1 == ticks)
+            my_blackbox_trigger();
+
+        const float phi_dot_true = sim_plant_get().phi_dot; // 本拍采样时刻的轮速真值
+        const auto t0 = std::chrono::steady_clock::now();
+        my_motion_update();
+        const auto t1 = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        cpu_ns_sum += ns;
+        if (ns > cpu_ns_max)
+            cpu_ns_max = ns;
+
+        // 节拍抖动限制在半个周期内
+        const float jitter = constrain(sim_plant_noise(opt.jitter_us), -0.5f * tick_us, 0.5f * tick_us);
+        sim_advance_us(static_cast<uint32_t>(static_cast<float>(tick_us) + jitter));
+
+        const sim_plant_state &s = sim_plant_get();
+        const float theta_deg = s.theta * static_cast<float>(RAD_TO_DEG);
+        if (csv)
+            fprintf(csv, "%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                    t, theta_deg, robot.ang.now, robot.ang.tar, robot.spd.now, robot.spd.tar,
+                    robot.pos.now, robot.yaw.now, robot.motor.L_cmd, robot.motor.R_cmd);
+        if (k >= settle_ticks)
+        {
+            theta_sq_sum += static_cast<double>(theta_deg) * theta_deg;
+            if (fabsf(theta_deg) > theta_abs_max)
+                theta_abs_max = fabsf(theta_deg);
+            const float spd_err = 0.5f * (robot.wel.spd1 + robot.wel.spd2) - phi_dot_true;
+            spd_err_sq_sum += static_cast<double>(spd_err) * spd_err;
+            ++stat_ticks;
+            if (fleet)
+            {
+                fleet_status fs;
+                my_fleet_status(fs);
+                form_sq_sum += static_cast<double>(fs.pos_err) * fs.pos_err;
+                form_abs_max = fmaxf(form_abs_max, fabsf(fs.pos_err));
+            }
+        }
+        if (robot.fallen.is)
+            fell = true;
+    }
+    if (csv)
+        fclose(csv);
+
+    const double n = static_cast<double>(ticks ? ticks : 1);
+    printf("scenario=%s ctrl=%s seconds=%.1f ticks=%llu vbat=%.2f vcomp=%.3f\n", opt.scenario,
+           opt.ctrl_mode == CTRL_MODE_LQR ? "lqr" : "pid", opt.seconds, static_cast<unsigned long long>(ticks), opt.vbat,
+           sched_vcomp);
+    printf("theta: rms=%.3f deg max=%.3f deg  pos=%.3f rad  fallen=%s\n",
+           stat_ticks ? sqrt(theta_sq_sum / stat_ticks) : 0.0, theta_abs_max, robot.pos.now, fell ? "yes" : "no");
+    printf("wheel speed: est err rms=%.4f rad/s (%s)\n", stat_ticks ? sqrt(spd_err_sq_sum / stat_ticks) : 0.0,
+           ENCODER_VEL_OBSERVER ? "observer" : "delta/dt");
+    if (fleet)
+    {
+        fleet_status fs;
+        my_fleet_status(fs);
+        printf("formation: err rms=%.3f rad max=%.3f rad final=%.3f rad  setpoints=%u tracking=%s\n",
+               stat_ticks ? sqrt(form_sq_sum / stat_ticks) : 0.0, form_abs_max, fs.pos_err, fs.setpoints,
+               fs.tracking ? "yes" : "no");
+    }
+    printf("cpu: my_motion_update mean=%.0f ns max=%.0f ns\n", cpu_ns_sum / n, cpu_ns_max);
+    for (uint8_t i = 0; i < PERF_STAGE_COUNT; ++i)
+    {
+        perf_summary sum;
+        my_perf_summary(static_cast<perf_stage>(i), sum);
+        if (sum.count)
+            printf("  %-8s n=%u p50=%u p99=%u max=%u us\n", my_perf_stage_name(static_cast<perf_stage>(i)),
+                   sum.count, sum.p50_us, sum.p99_us, sum.max_us);
+    }
+    if (opt.blackbox)
+        dump_blackbox(opt.blackbox);
+    if (opt.autotune)
+    {
+        autotune_status at;
+        my_autotune_status(at);
+        printf("autotune: %s loop=%s cycles=%u/%u elapsed=%u ms%s%s\n", my_autotune_state_name(at.state),
+               my_autotune_loop_name(at.loop), at.cycles, at.cycles_total, at.elapsed_ms, at.error ? "  error=" : "",
+               at.error ? at.error : "");
+        const autotune_result *res[] = {&at.ang, &at.spd};
+        for (int i = 0; i < 2; ++i)
+            if (res[i]->valid)
+                printf("  %s: Ku=%.4f Tu=%.3f s a=%.3f -> P=%.4f I=%.4f D=%.4f\n", i ? "spd" : "ang", res[i]->ku,
+                       res[i]->tu, res[i]->amplitude, res[i]->p, res[i]->i, res[i]->d);
+        if (at.state != AT_DONE)
+            return 1;
+    }
+    return fell ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+#include <math.h>
+#include "my_sim.h"
+
+namespace
+{
+    constexpr float G = 9.81f;
+
+    sim_plant_params cfg;
+    sim_plant_state st;
+    uint32_t rng = 1;
+
+    float sign_smooth(float w)
+    {
+        // 平滑的库仑摩擦方向，避免零速附近抖动
+        return tanhf(w / 0.05f);
+    }
+
+    // 单轮输出力矩：电压源 + 反电动势 + 库仑摩擦
+    float wheel_torque(float duty, float w_rel)
+    {
+        const float v_ratio = cfg.battery_voltage / cfg.nominal_voltage;
+        const float drive = cfg.stall_torque * (duty * v_ratio - w_rel / cfg.no_load_speed);
+        return drive - cfg.friction_torque * sign_smooth(w_rel);
+    }
+}
+
+sim_plant_params sim_plant_default_params()
+{
+    sim_plant_params p{};
+    p.body_mass = 0.50f;
+    p.body_com = 0.040f;
+    p.body_inertia = 4.2e-4f;
+    p.wheel_mass = 0.030f;
+    p.wheel_radius = 0.0325f;
+    p.track_width = 0.150f;
+    p.yaw_inertia = 1.3e-3f;
+    p.stall_torque = 0.50f;
+    p.no_load_speed = 30.0f;
+    p.friction_torque = 0.03f;
+    p.nominal_voltage = 12.0f;
+    p.battery_voltage = 12.0f;
+    p.mount_offset_deg = -2.1f;
+    p.angle_noise_deg = 0.05f;
+    p.gyro_noise_dps = 0.3f;
+    return p;
+}
+
+void sim_plant_init(const sim_plant_params &params, float theta0_rad, uint32_t seed)
+{
+    cfg = params;
+    st = {};
+    st.theta = theta0_rad;
+    rng = seed ? seed : 1;
+}
+
+const sim_plant_state &sim_plant_get()
+{
+    return st;
+}
+
+const sim_plant_params &sim_plant_get_params()
+{
+    return cfg;
+}
+
+void sim_plant_set_duty(float duty_l, float duty_r)
+{
+    st.duty_l = duty_l;
+    st.duty_r = duty_r;
+}
+
+void sim_plant_set_push(float force_n)
+{
+    st.push_n = force_n;
+}
+
+float sim_plant_wheel_angle_l()
+{
+    return st.phi - (cfg.track_width / (2.0f * cfg.wheel_radius)) * st.psi;
+}
+
+float sim_plant_wheel_angle_r()
+{
+    return st.phi + (cfg.track_width / (2.0f * cfg.wheel_radius)) * st.psi;
+}
+
+float sim_plant_noise(float sigma)
+{
+    if (sigma <= 0.0f)
+        return 0.0f;
+    // xorshift32 + Box-Muller
+    auto next = []() {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return (static_cast<float>(rng) + 1.0f) / 4294967297.0f;
+    };
+    const float u1 = next();
+    const float u2 = next();
+    return sigma * sqrtf(-2.0f * logf(u1)) * cosf(2.0f * static_cast<float>(M_PI) * u2);
+}
+
+// 平面倒立摆（拉格朗日方程，广义坐标 phi/theta）+ 偏航单自由度
+void sim_plant_step(float dt_s)
+{
+    const float M = cfg.body_mass;
+    const float L = cfg.body_com;
+    const float r = cfg.wheel_radius;
+    const float mw = 2.0f * cfg.wheel_mass;
+    const float Iw = 2.0f * 0.5f * cfg.wheel_mass * r * r;
+    const float k_yaw = cfg.track_width / (2.0f * r);
+
+    // 两侧轮相对车身的角速度
+    const float w_l = st.phi_dot - k_yaw * st.psi_dot - st.theta_dot;
+    const float w_r = st.phi_dot + k_yaw * st.psi_dot - st.theta_dot;
+    const float tau_l = wheel_torque(st.duty_l, w_l);
+    const float tau_r = wheel_torque(st.duty_r, w_r);
+    const float tau = tau_l + tau_r;
+
+    const float s = sinf(st.theta);
+    const float c = cosf(st.theta);
+
+    // [a11 a12; a12 a22] * [phi_dd; theta_dd] = [b1; b2]
+    const float a11 = (mw + M) * r * r + Iw;
+    const float a12 = M * r * L * c;
+    const float a22 = M * L * L + cfg.body_inertia;
+    const float b1 = tau + M * r * L * s * st.theta_dot * st.theta_dot + st.push_n * r;
+    const float b2 = -tau + M * G * L * s + st.push_n * L * c;
+    const float det = a11 * a22 - a12 * a12;
+    const float phi_dd = (b1 * a22 - a12 * b2) / det;
+    const float theta_dd = (a11 * b2 - a12 * b1) / det;
+
+    // 偏航：两轮地面力差产生力矩，轮子平动/转动惯量折算进来
+    const float yaw_inertia = cfg.yaw_inertia + 2.0f * (cfg.wheel_mass + 0.5f * cfg.wheel_mass) * k_yaw * k_yaw * r * r;
+    const float psi_dd = (tau_r - tau_l) * k_yaw / yaw_inertia;
+
+    // 半隐式欧拉
+    st.phi_dot += phi_dd * dt_s;
+    st.theta_dot += theta_dd * dt_s;
+    st.psi_dot += psi_dd * dt_s;
+    st.phi += st.phi_dot * dt_s;
+    st.theta += st.theta_dot * dt_s;
+    st.psi += st.psi_dot * dt_s;
+
+    // 倒地：车身触地后停住，不再继续积分
+    const float limit = 80.0f * static_cast<float>(M_PI) / 180.0f;
+    if (fabsf(st.theta) > limit)
+    {
+        st.theta = st.theta > 0 ? limit : -limit;
+        st.theta_dot = 0.0f;
+    }
+}
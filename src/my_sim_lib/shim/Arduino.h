@@ -0,0 +1,64 @@
+#pragma once
+
+// 主机仿真用的 Arduino 最小替身：只提供控制代码用到的接口
+// 时间由仿真时钟驱动（见 my_sim.h），与墙钟无关，保证结果可复现
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define HIGH 0x1
+#define LOW 0x0
+
+typedef uint8_t byte;
+
+template <typename T, typename L, typename H>
+inline T constrain(T v, L lo, H hi)
+{
+    return v < lo ? static_cast<T>(lo) : (v > hi ? static_cast<T>(hi) : v);
+}
+
+uint32_t micros();
+uint32_t millis();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// 串口输出直接落到 stdout
+class SimSerial
+{
+public:
+    void begin(unsigned long) {}
+    int printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)))
+    {
+        va_list ap;
+        va_start(ap, fmt);
+        const int n = vprintf(fmt, ap);
+        va_end(ap);
+        return n;
+    }
+    void print(const char *s) { fputs(s, stdout); }
+    void print(int v) { ::printf("%d", v); }
+    void print(unsigned v) { ::printf("%u", v); }
+    void print(long v) { ::printf("%ld", v); }
+    void print(unsigned long v) { ::printf("%lu", v); }
+    void print(double v) { ::printf("%.2f", v); }
+    void println() { fputc('\n', stdout); }
+    template <typename T>
+    void println(T v)
+    {
+        print(v);
+        println();
+    }
+};
+
+extern SimSerial Serial;
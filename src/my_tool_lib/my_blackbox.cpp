@@ -0,0 +1,301 @@
+#include <Arduino.h>
+#include <atomic>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "my_blackbox.h"
+#include "my_motion.h"
+#include "my_encoder.h"
+
+#if defined(ESP_PLATFORM)
+#include <esp_heap_caps.h>
+#endif
+
+namespace
+{
+    constexpr uint32_t PsramCapacity = 16384;  // 约 1.9MB，500Hz 下 32s
+    constexpr uint32_t InternalCapacity = 512; // 无 PSRAM 时约 1s
+
+#define BB_FIELD(f, t) {#f, static_cast<uint16_t>(offsetof(blackbox_record, f)), t}
+    const blackbox_field Fields[] = {
+        BB_FIELD(t_us, 'u'), BB_FIELD(tick, 'u'), BB_FIELD(dt, 'f'),
+        BB_FIELD(enc_l, 'i'), BB_FIELD(enc_r, 'i'), BB_FIELD(flags, 'h'),
+        BB_FIELD(ang_now, 'f'), BB_FIELD(ang_tar, 'f'),
+        BB_FIELD(spd_now, 'f'), BB_FIELD(spd_tar, 'f'),
+        BB_FIELD(pos_now, 'f'), BB_FIELD(pos_tar, 'f'),
+        BB_FIELD(yaw_now, 'f'), BB_FIELD(yaw_tar, 'f'),
+        BB_FIELD(anglex, 'f'), BB_FIELD(angley, 'f'), BB_FIELD(anglez, 'f'),
+        BB_FIELD(gyrox, 'f'), BB_FIELD(gyroy, 'f'), BB_FIELD(gyroz, 'f'),
+        BB_FIELD(wel_spd1, 'f'), BB_FIELD(wel_spd2, 'f'),
+        BB_FIELD(base_duty, 'f'), BB_FIELD(yaw_duty, 'f'),
+        BB_FIELD(L_cmd, 'f'), BB_FIELD(R_cmd, 'f'),
+        BB_FIELD(L_duty, 'f'), BB_FIELD(R_duty, 'f'),
+        BB_FIELD(joy_x, 'f'), BB_FIELD(joy_y, 'f'),
+    };
+#undef BB_FIELD
+    constexpr size_t FieldCount = sizeof(Fields) / sizeof(Fields[0]);
+
+    blackbox_record *buf = nullptr;
+    uint32_t capacity = 0; // 2 的幂
+    bool in_psram = false;
+
+    // 仅控制任务写
+    uint32_t head = 0;    // 下一条写入位置（单调递增）
+    uint32_t written = 0; // 布防后写入条数
+    uint32_t post_remaining = 0;
+    uint32_t pre_count = 0;
+    uint32_t frozen_count = 0;
+    uint32_t frozen_trigger_pos = 0;
+    bool last_fallen = false;
+    blackbox_arm_config active = {BB_TRIG_MANUAL, -1, 0.0f, 50};
+    std::atomic<uint8_t> state{BB_IDLE};
+
+    // 网络任务 -> 控制任务的请求
+    blackbox_arm_config pending = {BB_TRIG_MANUAL, -1, 0.0f, 50};
+    std::atomic<bool> arm_request{false};
+    std::atomic<bool> stop_request{false};
+    std::atomic<bool> manual_request{false};
+
+    void fill(blackbox_record &r)
+    {
+        r.t_us = robot.tick.last_us;
+        r.tick = robot.tick.count;
+        r.dt = robot.tick.dt;
+        r.enc_l = static_cast<int16_t>(Encoder_Left_Delta);
+        r.enc_r = static_cast<int16_t>(Encoder_Right_Delta);
+        r.flags = (robot.run ? 0x01 : 0) | (robot.fallen.is ? 0x02 : 0);
+        r.reserved = 0;
+        r.ang_now = robot.ang.now;
+        r.ang_tar = robot.ang.tar;
+        r.spd_now = robot.spd.now;
+        r.spd_tar = robot.spd.tar;
+        r.pos_now = robot.pos.now;
+        r.pos_tar = robot.pos.tar;
+        r.yaw_now = robot.yaw.now;
+        r.yaw_tar = robot.yaw.tar;
+        r.anglex = robot.imu.anglex;
+        r.angley = robot.imu.angley;
+        r.anglez = robot.imu.anglez;
+        r.gyrox = robot.imu.gyrox;
+        r.gyroy = robot.imu.gyroy;
+        r.gyroz = robot.imu.gyroz;
+        r.wel_spd1 = robot.wel.spd1;
+        r.wel_spd2 = robot.wel.spd2;
+        r.base_duty = robot.motor.base_duty;
+        r.yaw_duty = robot.motor.yaw_duty;
+        r.L_cmd = robot.motor.L_cmd;
+        r.R_cmd = robot.motor.R_cmd;
+        r.L_duty = robot.motor.L_duty;
+        r.R_duty = robot.motor.R_duty;
+        r.joy_x = robot.joy.x;
+        r.joy_y = robot.joy.y;
+    }
+
+    bool triggered(const blackbox_record &r)
+    {
+        if (manual_request.exchange(false))
+            return true;
+        const bool fallen = robot.fallen.is;
+        const bool fall_edge = fallen && !last_fallen;
+        last_fallen = fallen;
+        if (active.trigger == BB_TRIG_FALL)
+            return fall_edge;
+        if (active.trigger == BB_TRIG_THRESHOLD && active.channel >= 0 && Fields[active.channel].type == 'f')
+        {
+            float v;
+            memcpy(&v, reinterpret_cast<const uint8_t *>(&r) + Fields[active.channel].offset, sizeof(v));
+            return fabsf(v) >= active.level;
+        }
+        return false;
+    }
+
+    void freeze(uint32_t post_recorded)
+    {
+        frozen_count = written < capacity ? written : capacity;
+        frozen_trigger_pos = frozen_count - 1 - post_recorded;
+        state.store(BB_FROZEN, std::memory_order_release);
+    }
+}
+
+bool my_blackbox_init()
+{
+    if (buf)
+        return true;
+#if defined(ESP_PLATFORM)
+    buf = static_cast<blackbox_record *>(heap_caps_malloc(PsramCapacity * sizeof(blackbox_record), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    in_psram = buf != nullptr;
+    capacity = in_psram ? PsramCapacity : InternalCapacity;
+    if (!buf)
+        buf = static_cast<blackbox_record *>(heap_caps_malloc(capacity * sizeof(blackbox_record), MALLOC_CAP_8BIT));
+#else
+    capacity = PsramCapacity;
+    buf = static_cast<blackbox_record *>(malloc(capacity * sizeof(blackbox_record)));
+#endif
+    if (!buf)
+    {
+        capacity = 0;
+        Serial.println("[BBX] 缓冲分配失败，黑匣子不可用");
+        return false;
+    }
+    Serial.printf("[BBX] %u 条记录（%s，%u 字节/条）\n", capacity, in_psram ? "PSRAM" : "RAM",
+                  static_cast<unsigned>(sizeof(blackbox_record)));
+    return true;
+}
+
+void my_blackbox_record()
+{
+    if (!buf)
+        return;
+    if (stop_request.exchange(false))
+        state.store(BB_IDLE, std::memory_order_release);
+    if (arm_request.exchange(false))
+    {
+        active = pending;
+        const uint32_t pct = active.pre_pct > 100 ? 100 : active.pre_pct;
+        // 窗口 = pre 段 + 触发点 1 条 + post 段
+        pre_count = capacity * pct / 100;
+        if (pre_count > capacity - 1)
+            pre_count = capacity - 1;
+        post_remaining = capacity - 1 - pre_count;
+        written = 0;
+        last_fallen = robot.fallen.is;
+        manual_request.store(false);
+        state.store(BB_ARMED, std::memory_order_release);
+    }
+
+    const uint8_t s = state.load(std::memory_order_relaxed);
+    if (s == BB_IDLE || s == BB_FROZEN)
+        return;
+
+    blackbox_record &r = buf[head & (capacity - 1)];
+    fill(r);
+    head++;
+    written++;
+
+    if (s == BB_ARMED)
+    {
+        if (triggered(r))
+        {
+            if (post_remaining == 0)
+                freeze(0);
+            else
+                state.store(BB_TRIGGERED, std::memory_order_release);
+        }
+        return;
+    }
+    // BB_TRIGGERED
+    if (--post_remaining == 0)
+        freeze(capacity - 1 - pre_count);
+}
+
+void my_blackbox_arm(const blackbox_arm_config &cfg)
+{
+    pending = cfg;
+    arm_request.store(true, std::memory_order_release);
+}
+
+void my_blackbox_trigger()
+{
+    manual_request.store(true, std::memory_order_release);
+}
+
+void my_blackbox_stop()
+{
+    stop_request.store(true, std::memory_order_release);
+}
+
+void my_blackbox_status(blackbox_status &out)
+{
+    out.state = static_cast<blackbox_state>(state.load(std::memory_order_acquire));
+    out.trigger = active.trigger;
+    out.capacity = capacity;
+    out.psram = in_psram;
+    if (out.state == BB_FROZEN)
+    {
+        out.count = frozen_count;
+        out.trigger_pos = frozen_trigger_pos;
+    }
+    else
+    {
+        out.count = written < capacity ? written : capacity;
+        out.trigger_pos = 0;
+    }
+}
+
+const blackbox_field *my_blackbox_fields(size_t &count)
+{
+    count = FieldCount;
+    return Fields;
+}
+
+int my_blackbox_find_field(const char *name)
+{
+    for (size_t i = 0; i < FieldCount; ++i)
+        if (!strcmp(Fields[i].name, name))
+            return static_cast<int>(i);
+    return -1;
+}
+
+const char *my_blackbox_trigger_name(blackbox_trigger t)
+{
+    switch (t)
+    {
+    case BB_TRIG_FALL:
+        return "fall";
+    case BB_TRIG_THRESHOLD:
+        return "threshold";
+    default:
+        return "manual";
+    }
+}
+
+const char *my_blackbox_state_name(blackbox_state s)
+{
+    static const char *const Names[] = {"idle", "armed", "triggered", "frozen"};
+    return s <= BB_FROZEN ? Names[s] : "?";
+}
+
+size_t my_blackbox_read(uint8_t *dst, size_t len, size_t offset, size_t &total)
+{
+    total = 0;
+    if (state.load(std::memory_order_acquire) != BB_FROZEN)
+        return 0;
+
+    blackbox_header hdr = {};
+    memcpy(hdr.magic, "BBX1", 4);
+    hdr.version = BLACKBOX_VERSION;
+    hdr.record_size = sizeof(blackbox_record);
+    hdr.count = frozen_count;
+    hdr.trigger_pos = frozen_trigger_pos;
+    hdr.dt_us = robot.dt_ms * 1000;
+    hdr.trigger = active.trigger;
+    total = sizeof(hdr) + static_cast<size_t>(frozen_count) * sizeof(blackbox_record);
+
+    size_t copied = 0;
+    while (copied < len && offset < total)
+    {
+        size_t n;
+        if (offset < sizeof(hdr))
+        {
+            n = sizeof(hdr) - offset;
+            if (n > len - copied)
+                n = len - copied;
+            memcpy(dst + copied, reinterpret_cast<const uint8_t *>(&hdr) + offset, n);
+        }
+        else
+        {
+            // 冻结窗口的第一条 = head - count，按记录拆分拷贝以处理回绕
+            const size_t rec_byte = offset - sizeof(hdr);
+            const uint32_t idx = static_cast<uint32_t>(rec_byte / sizeof(blackbox_record));
+            const size_t within = rec_byte % sizeof(blackbox_record);
+            const blackbox_record &r = buf[(head - frozen_count + idx) & (capacity - 1)];
+            n = sizeof(blackbox_record) - within;
+            if (n > len - copied)
+                n = len - copied;
+            memcpy(dst + copied, reinterpret_cast<const uint8_t *>(&r) + within, n);
+        }
+        copied += n;
+        offset += n;
+    }
+    return copied;
+}
@@ -0,0 +1,83 @@
+#include <atomic>
+#include "my_heap_trace.h"
+
+#if defined(ESP_PLATFORM)
+#include <esp_heap_caps.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+namespace
+{
+    std::atomic<uint32_t> total{0};
+    std::atomic<uint32_t> watched_count{0};
+    TaskHandle_t watched_task = nullptr;
+
+    inline void note_alloc()
+    {
+        total.fetch_add(1, std::memory_order_relaxed);
+        if (watched_task && xTaskGetCurrentTaskHandle() == watched_task)
+            watched_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// platformio.ini: -Wl,--wrap=malloc -Wl,--wrap=calloc -Wl,--wrap=realloc
+extern "C"
+{
+    void *__real_malloc(size_t size);
+    void *__real_calloc(size_t n, size_t size);
+    void *__real_realloc(void *ptr, size_t size);
+
+    void *__wrap_malloc(size_t size)
+    {
+        note_alloc();
+        return __real_malloc(size);
+    }
+
+    void *__wrap_calloc(size_t n, size_t size)
+    {
+        note_alloc();
+        return __real_calloc(n, size);
+    }
+
+    void *__wrap_realloc(void *ptr, size_t size)
+    {
+        note_alloc();
+        return __real_realloc(ptr, size);
+    }
+}
+
+void my_heap_trace_watch()
+{
+    watched_task = xTaskGetCurrentTaskHandle();
+}
+
+uint32_t my_heap_trace_watched()
+{
+    return watched_count.load(std::memory_order_relaxed);
+}
+
+void my_heap_trace_info(heap_trace_info &out)
+{
+    out.total = total.load(std::memory_order_relaxed);
+    out.watched = watched_count.load(std::memory_order_relaxed);
+    out.free_bytes = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    out.min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+    out.largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+}
+
+#else
+// 主机仿真不截获分配
+void my_heap_trace_watch()
+{
+}
+
+uint32_t my_heap_trace_watched()
+{
+    return 0;
+}
+
+void my_heap_trace_info(heap_trace_info &out)
+{
+    out = {};
+}
+#endif
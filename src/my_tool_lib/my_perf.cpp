@@ -0,0 +1,159 @@
+#include <Arduino.h>
+#include <string.h>
+#include "my_perf.h"
+
+#if defined(ESP_PLATFORM)
+#include <Esp.h>
+#else
+#include <chrono>
+#endif
+
+namespace
+{
+    // 对数-线性分桶：0~15us 每 1us 一桶，之后每个 2 的幂区间再分 8 桶（误差 <12.5%）
+    constexpr uint32_t LinearBuckets = 16;
+    constexpr uint32_t SubBuckets = 8;
+    constexpr uint32_t Octaves = 13; // 16us ~ 128ms
+    constexpr uint32_t BucketCount = LinearBuckets + Octaves * SubBuckets;
+
+    struct perf_hist
+    {
+        uint32_t bucket[BucketCount];
+        uint32_t count;
+        uint32_t min_us;
+        uint32_t max_us;
+        uint64_t sum_us;
+    };
+
+    perf_hist hist[PERF_STAGE_COUNT];
+    uint32_t late_count = 0;
+    volatile bool reset_pending = true; // 首拍即完成初始化
+    uint32_t cycles_per_us = 1;
+
+    const char *const StageNames[PERF_STAGE_COUNT] = {"imu", "encoder", "control", "motor", "espnow", "total", "period"};
+
+    uint32_t bucket_index(uint32_t us)
+    {
+        if (us < LinearBuckets)
+            return us;
+        const uint32_t msb = 31 - __builtin_clz(us); // >= 4
+        const uint32_t sub = (us >> (msb - 3)) & (SubBuckets - 1);
+        const uint32_t idx = LinearBuckets + (msb - 4) * SubBuckets + sub;
+        return idx < BucketCount ? idx : BucketCount - 1;
+    }
+
+    uint32_t bucket_upper(uint32_t idx)
+    {
+        if (idx < LinearBuckets)
+            return idx;
+        const uint32_t k = idx - LinearBuckets;
+        const uint32_t shift = k / SubBuckets + 1; // msb - 3
+        const uint32_t lower = (SubBuckets + k % SubBuckets) << shift;
+        return lower + (1u << shift) - 1;
+    }
+
+    uint32_t percentile(const perf_hist &h, float p)
+    {
+        if (h.count == 0)
+            return 0;
+        const uint32_t target = static_cast<uint32_t>(ceilf(p * h.count));
+        uint32_t acc = 0;
+        for (uint32_t i = 0; i < BucketCount; ++i)
+        {
+            acc += h.bucket[i];
+            if (acc >= target)
+            {
+                const uint32_t upper = bucket_upper(i);
+                return upper < h.max_us ? upper : h.max_us;
+            }
+        }
+        return h.max_us;
+    }
+}
+
+uint32_t my_perf_now()
+{
+#if defined(ESP_PLATFORM)
+    return ESP.getCycleCount();
+#else
+    // 主机上用纳秒代替周期
+    using namespace std::chrono;
+    return static_cast<uint32_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void my_perf_add_us(perf_stage stage, uint32_t us)
+{
+    perf_hist &h = hist[stage];
+    h.bucket[bucket_index(us)]++;
+    h.count++;
+    h.sum_us += us;
+    if (us < h.min_us)
+        h.min_us = us;
+    if (us > h.max_us)
+        h.max_us = us;
+}
+
+uint32_t my_perf_cycles_to_us(uint32_t cycles)
+{
+    return cycles / cycles_per_us;
+}
+
+void my_perf_add_cycles(perf_stage stage, uint32_t cycles)
+{
+    my_perf_add_us(stage, my_perf_cycles_to_us(cycles));
+}
+
+uint32_t my_perf_record(perf_stage stage, uint32_t start)
+{
+    const uint32_t now = my_perf_now();
+    my_perf_add_cycles(stage, now - start);
+    return now;
+}
+
+void my_perf_late()
+{
+    late_count++;
+}
+
+uint32_t my_perf_late_count()
+{
+    return late_count;
+}
+
+void my_perf_summary(perf_stage stage, perf_summary &out)
+{
+    const perf_hist &h = hist[stage];
+    out.count = h.count;
+    out.min_us = h.count ? h.min_us : 0;
+    out.max_us = h.max_us;
+    out.mean_us = h.count ? static_cast<float>(h.sum_us) / h.count : 0.0f;
+    out.p50_us = percentile(h, 0.50f);
+    out.p99_us = percentile(h, 0.99f);
+}
+
+const char *my_perf_stage_name(perf_stage stage)
+{
+    return stage < PERF_STAGE_COUNT ? StageNames[stage] : "?";
+}
+
+void my_perf_request_reset()
+{
+    reset_pending = true;
+}
+
+void my_perf_service()
+{
+    if (!reset_pending)
+        return;
+#if defined(ESP_PLATFORM)
+    cycles_per_us = ESP.getCpuFreqMHz();
+#else
+    cycles_per_us = 1000;
+#endif
+    memset(hist, 0, sizeof(hist));
+    for (auto &h : hist)
+        h.min_us = UINT32_MAX;
+    late_count = 0;
+    reset_pending = false;
+}